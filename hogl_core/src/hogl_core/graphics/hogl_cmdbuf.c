@@ -0,0 +1,374 @@
+#include "hogl_cmdbuf.h"
+
+#include <stdint.h>
+
+#include "hogl_core/graphics/hogl_render.h"
+#include "hogl_core/shared/hogl_log.h"
+#include "hogl_core/shared/hogl_memory.h"
+
+#define CMDBUF_DEFAULT_CAPACITY 4096
+
+// Every command starts at a multiple of this so pointers in payloads are aligned
+#define CMD_ALIGN 8
+
+typedef enum {
+	CMD_SHADER,
+	CMD_VAO,
+	CMD_TEXTURE,
+	CMD_UBO_SLICE,
+	CMD_UBO_DATA,
+	CMD_DEPTH,
+	CMD_RENDER_A,
+	CMD_RENDER_E,
+	CMD_RENDER_AI,
+	CMD_RENDER_EI,
+	CMD_RENDER_EBV,
+	CMD_RENDER_MEI
+} hogl_cmd_type;
+
+typedef struct _hogl_cmd_header {
+	uint32_t type;
+	// Size of the command including this header
+	uint32_t size;
+} hogl_cmd_header;
+
+typedef struct _hogl_cmd_texture {
+	hogl_texture* texture;
+	int slot;
+} hogl_cmd_texture;
+
+typedef struct _hogl_cmd_ubo_slice {
+	hogl_ubo_ring* ring;
+	hogl_ubo_slice slice;
+	unsigned int bp;
+} hogl_cmd_ubo_slice;
+
+typedef struct _hogl_cmd_ubo_data {
+	hogl_ubo_ring* ring;
+	unsigned int bp;
+	size_t size;
+	// Followed by size bytes of data
+} hogl_cmd_ubo_data;
+
+typedef struct _hogl_cmd_render {
+	hogl_render_mode mode;
+	unsigned int vertices;
+	unsigned int instances;
+} hogl_cmd_render;
+
+typedef struct _hogl_cmd_render_base {
+	hogl_render_mode mode;
+	unsigned int vertices;
+	unsigned int first_index;
+	int base_vertex;
+	unsigned int instances;
+} hogl_cmd_render_base;
+
+typedef struct _hogl_cmd_render_indirect {
+	hogl_indirect_buffer* ib;
+	hogl_render_mode mode;
+	size_t first;
+	size_t count;
+} hogl_cmd_render_indirect;
+
+typedef struct _hogl_cmdbuf {
+	uint8_t* data;
+	size_t size;
+	size_t capacity;
+	size_t count;
+} hogl_cmdbuf;
+
+size_t __cmd_size(size_t payload) {
+	size_t size = sizeof(hogl_cmd_header) + payload;
+	return (size + CMD_ALIGN - 1) & ~(size_t)(CMD_ALIGN - 1);
+}
+
+// Reserves a command and returns its payload
+void* __cmd_push(hogl_cmdbuf* cb, hogl_cmd_type type, size_t payload) {
+	size_t size = __cmd_size(payload);
+	size_t new_capacity = cb->capacity * 2;
+	uint8_t* new_data = NULL;
+	hogl_cmd_header* header = NULL;
+
+	if (size > UINT32_MAX) {
+		hogl_log_error("Command of %ld bytes is too large for a command buffer", size);
+		return NULL;
+	}
+
+	if (cb->size + size > cb->capacity) {
+		while (new_capacity < cb->size + size) {
+			new_capacity *= 2;
+		}
+
+		new_data = hogl_realloc(cb->data, new_capacity);
+		if (new_data == NULL) {
+			hogl_log_error("Failed to expand a command buffer to %ld bytes", new_capacity);
+			return NULL;
+		}
+
+		cb->data = new_data;
+		cb->capacity = new_capacity;
+	}
+
+	header = (hogl_cmd_header*)(cb->data + cb->size);
+	header->type = (uint32_t)type;
+	header->size = (uint32_t)size;
+
+	cb->size += size;
+	cb->count++;
+	return header + 1;
+}
+
+hogl_error __cmd_render(hogl_cmdbuf* cb, hogl_cmd_type type, hogl_render_mode mode, unsigned int vertices, unsigned int instances) {
+	hogl_cmd_render* cmd = (hogl_cmd_render*)__cmd_push(cb, type, sizeof(hogl_cmd_render));
+	if (cmd == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	cmd->mode = mode;
+	cmd->vertices = vertices;
+	cmd->instances = instances;
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_cmdbuf_new(hogl_cmdbuf** cb, size_t capacity) {
+	if (capacity == 0) {
+		capacity = CMDBUF_DEFAULT_CAPACITY;
+	}
+
+	capacity = __cmd_size(capacity);
+
+	(*cb) = (hogl_cmdbuf*)hogl_malloc(sizeof(hogl_cmdbuf));
+	if ((*cb) == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	(*cb)->data = (uint8_t*)hogl_malloc(capacity);
+	if ((*cb)->data == NULL) {
+		hogl_free(*cb);
+		(*cb) = NULL;
+		return HOGL_ERROR_MEMORY;
+	}
+
+	(*cb)->size = 0;
+	(*cb)->capacity = capacity;
+	(*cb)->count = 0;
+	return HOGL_ERROR_NONE;
+}
+
+void hogl_cmdbuf_reset(hogl_cmdbuf* cb) {
+	cb->size = 0;
+	cb->count = 0;
+}
+
+size_t hogl_cmdbuf_count(hogl_cmdbuf* cb) {
+	return cb->count;
+}
+
+hogl_error hogl_cmdbuf_shader(hogl_cmdbuf* cb, hogl_shader* shader) {
+	hogl_shader** cmd = (hogl_shader**)__cmd_push(cb, CMD_SHADER, sizeof(hogl_shader*));
+	if (cmd == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	*cmd = shader;
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_cmdbuf_vao(hogl_cmdbuf* cb, hogl_vao* vao) {
+	hogl_vao** cmd = (hogl_vao**)__cmd_push(cb, CMD_VAO, sizeof(hogl_vao*));
+	if (cmd == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	*cmd = vao;
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_cmdbuf_texture(hogl_cmdbuf* cb, hogl_texture* texture, int slot) {
+	hogl_cmd_texture* cmd = (hogl_cmd_texture*)__cmd_push(cb, CMD_TEXTURE, sizeof(hogl_cmd_texture));
+	if (cmd == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	cmd->texture = texture;
+	cmd->slot = slot;
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_cmdbuf_ubo_slice(hogl_cmdbuf* cb, hogl_ubo_ring* ring, hogl_ubo_slice slice, unsigned int bp) {
+	hogl_cmd_ubo_slice* cmd = (hogl_cmd_ubo_slice*)__cmd_push(cb, CMD_UBO_SLICE, sizeof(hogl_cmd_ubo_slice));
+	if (cmd == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	cmd->ring = ring;
+	cmd->slice = slice;
+	cmd->bp = bp;
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_cmdbuf_ubo_data(hogl_cmdbuf* cb, hogl_ubo_ring* ring, unsigned int bp, const void* data, size_t size) {
+	hogl_cmd_ubo_data* cmd = (hogl_cmd_ubo_data*)__cmd_push(cb, CMD_UBO_DATA, sizeof(hogl_cmd_ubo_data) + size);
+	if (cmd == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	cmd->ring = ring;
+	cmd->bp = bp;
+	cmd->size = size;
+	hogl_smemcpy(cmd + 1, data, size);
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_cmdbuf_depth(hogl_cmdbuf* cb, hogl_render_depth depth) {
+	hogl_render_depth* cmd = (hogl_render_depth*)__cmd_push(cb, CMD_DEPTH, sizeof(hogl_render_depth));
+	if (cmd == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	*cmd = depth;
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_cmdbuf_render_a(hogl_cmdbuf* cb, hogl_render_mode mode, unsigned int vertices) {
+	return __cmd_render(cb, CMD_RENDER_A, mode, vertices, 0);
+}
+
+hogl_error hogl_cmdbuf_render_e(hogl_cmdbuf* cb, hogl_render_mode mode, unsigned int vertices) {
+	return __cmd_render(cb, CMD_RENDER_E, mode, vertices, 0);
+}
+
+hogl_error hogl_cmdbuf_render_ai(hogl_cmdbuf* cb, hogl_render_mode mode, unsigned int vertices, unsigned int instances) {
+	return __cmd_render(cb, CMD_RENDER_AI, mode, vertices, instances);
+}
+
+hogl_error hogl_cmdbuf_render_ei(hogl_cmdbuf* cb, hogl_render_mode mode, unsigned int vertices, unsigned int instances) {
+	return __cmd_render(cb, CMD_RENDER_EI, mode, vertices, instances);
+}
+
+hogl_error hogl_cmdbuf_render_ebv(hogl_cmdbuf* cb, hogl_render_mode mode, unsigned int vertices, unsigned int first_index, int base_vertex, unsigned int instances) {
+	hogl_cmd_render_base* cmd = (hogl_cmd_render_base*)__cmd_push(cb, CMD_RENDER_EBV, sizeof(hogl_cmd_render_base));
+	if (cmd == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	cmd->mode = mode;
+	cmd->vertices = vertices;
+	cmd->first_index = first_index;
+	cmd->base_vertex = base_vertex;
+	cmd->instances = instances;
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_cmdbuf_render_mei(hogl_cmdbuf* cb, hogl_indirect_buffer* ib, hogl_render_mode mode, size_t first, size_t count) {
+	hogl_cmd_render_indirect* cmd = (hogl_cmd_render_indirect*)__cmd_push(cb, CMD_RENDER_MEI, sizeof(hogl_cmd_render_indirect));
+	if (cmd == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	cmd->ib = ib;
+	cmd->mode = mode;
+	cmd->first = first;
+	cmd->count = count;
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_cmdbuf_replay(hogl_cmdbuf* cb) {
+	hogl_error err = HOGL_ERROR_NONE;
+	size_t offset = 0;
+
+	while (offset < cb->size && err == HOGL_ERROR_NONE) {
+		hogl_cmd_header* header = (hogl_cmd_header*)(cb->data + offset);
+		void* payload = header + 1;
+
+		// A zero size would never advance and a size past the end would read outside of the buffer
+		if (cb->size - offset < sizeof(hogl_cmd_header) || header->size < sizeof(hogl_cmd_header) || header->size > cb->size - offset) {
+			hogl_log_error("Command at %ld has an invalid size", offset);
+			return HOGL_ERROR_BAD_ARGUMENT;
+		}
+
+		offset += header->size;
+
+		switch ((hogl_cmd_type)header->type) {
+		case CMD_SHADER:
+			hogl_shader_bind(*(hogl_shader**)payload);
+			break;
+		case CMD_VAO:
+			hogl_vao_bind(*(hogl_vao**)payload);
+			break;
+		case CMD_TEXTURE: {
+			hogl_cmd_texture* cmd = (hogl_cmd_texture*)payload;
+			hogl_texture_bind(cmd->texture, cmd->slot);
+			break;
+		}
+		case CMD_UBO_SLICE: {
+			hogl_cmd_ubo_slice* cmd = (hogl_cmd_ubo_slice*)payload;
+			err = hogl_ubo_ring_bind(cmd->ring, cmd->slice, cmd->bp);
+			break;
+		}
+		case CMD_UBO_DATA: {
+			hogl_cmd_ubo_data* cmd = (hogl_cmd_ubo_data*)payload;
+			err = hogl_ubo_ring_push(cmd->ring, cmd->bp, cmd + 1, cmd->size);
+			break;
+		}
+		case CMD_DEPTH:
+			err = hogl_set_depth_test(*(hogl_render_depth*)payload);
+			break;
+		case CMD_RENDER_A: {
+			hogl_cmd_render* cmd = (hogl_cmd_render*)payload;
+			err = hogl_render_a(cmd->mode, cmd->vertices);
+			break;
+		}
+		case CMD_RENDER_E: {
+			hogl_cmd_render* cmd = (hogl_cmd_render*)payload;
+			err = hogl_render_e(cmd->mode, cmd->vertices);
+			break;
+		}
+		case CMD_RENDER_AI: {
+			hogl_cmd_render* cmd = (hogl_cmd_render*)payload;
+			err = hogl_render_ai(cmd->mode, cmd->vertices, cmd->instances);
+			break;
+		}
+		case CMD_RENDER_EI: {
+			hogl_cmd_render* cmd = (hogl_cmd_render*)payload;
+			err = hogl_render_ei(cmd->mode, cmd->vertices, cmd->instances);
+			break;
+		}
+		case CMD_RENDER_EBV: {
+			hogl_cmd_render_base* cmd = (hogl_cmd_render_base*)payload;
+			err = cmd->instances != 0 ?
+				hogl_render_ebvi(cmd->mode, cmd->vertices, cmd->first_index, cmd->base_vertex, cmd->instances) :
+				hogl_render_ebv(cmd->mode, cmd->vertices, cmd->first_index, cmd->base_vertex);
+			break;
+		}
+		case CMD_RENDER_MEI: {
+			hogl_cmd_render_indirect* cmd = (hogl_cmd_render_indirect*)payload;
+			hogl_indirect_bind(cmd->ib);
+			err = hogl_render_mei(cmd->mode, cmd->first, cmd->count);
+			break;
+		}
+		default:
+			hogl_log_error("Unknown command type %d", header->type);
+			return HOGL_ERROR_BAD_ARGUMENT;
+		}
+	}
+
+	return err;
+}
+
+hogl_error hogl_cmdbuf_replay_n(hogl_cmdbuf** cbs, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		hogl_error err = hogl_cmdbuf_replay(cbs[i]);
+		if (err != HOGL_ERROR_NONE) {
+			return err;
+		}
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+void hogl_cmdbuf_free(hogl_cmdbuf* cb) {
+	hogl_free(cb->data);
+	hogl_free(cb);
+}
\ No newline at end of file
@@ -0,0 +1,212 @@
+/**
+* @brief hogl command buffer file contains recorded render commands, a command buffer can be recorded on any thread
+* and is later replayed on the thread that owns the OpenGL context
+*/
+
+#ifndef _HOGL_CMDBUF_
+#define _HOGL_CMDBUF_
+
+#include <stddef.h>
+#include "hogl_core/shared/hogl_def.h"
+#include "hogl_core/graphics/hogl_gl_primitive.h"
+
+/**
+ * @brief Command buffer holds compact binary render commands, a single command buffer must only be recorded by
+ * one thread at a time, use one command buffer per recording thread to record in parallel
+*/
+typedef struct _hogl_cmdbuf hogl_cmdbuf;
+
+/**
+ * @brief Creates a new empty command buffer
+ * @param cb Where to store the new command buffer
+ * @param capacity Initial size of the command storage in bytes, grows when needed, 0 for a default size
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the command storage could not be allocated
+*/
+HOGL_API hogl_error hogl_cmdbuf_new(hogl_cmdbuf** cb, size_t capacity);
+
+/**
+ * @brief Removes all recorded commands, keeps the allocated storage
+ * @param cb Command buffer to reset
+*/
+HOGL_API void hogl_cmdbuf_reset(hogl_cmdbuf* cb);
+
+/**
+ * @brief Returns the number of recorded commands
+ * @param cb Command buffer
+ * @return Number of commands
+*/
+HOGL_API size_t hogl_cmdbuf_count(hogl_cmdbuf* cb);
+
+/**
+ * @brief Records a shader bind
+ * @param cb Command buffer to record to
+ * @param shader Shader to bind, must stay alive until the command buffer is replayed
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the command storage could not be expanded
+*/
+HOGL_API hogl_error hogl_cmdbuf_shader(hogl_cmdbuf* cb, hogl_shader* shader);
+
+/**
+ * @brief Records a vao bind
+ * @param cb Command buffer to record to
+ * @param vao Vao to bind, must stay alive until the command buffer is replayed
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the command storage could not be expanded
+*/
+HOGL_API hogl_error hogl_cmdbuf_vao(hogl_cmdbuf* cb, hogl_vao* vao);
+
+/**
+ * @brief Records a texture bind
+ * @param cb Command buffer to record to
+ * @param texture Texture to bind, must stay alive until the command buffer is replayed
+ * @param slot Texture slot to bind to
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the command storage could not be expanded
+*/
+HOGL_API hogl_error hogl_cmdbuf_texture(hogl_cmdbuf* cb, hogl_texture* texture, int slot);
+
+/**
+ * @brief Records a bind of an already written uniform ring slice
+ * @param cb Command buffer to record to
+ * @param ring Ring the slice was allocated from
+ * @param slice Slice to bind
+ * @param bp Binding point to bind the slice to
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the command storage could not be expanded
+*/
+HOGL_API hogl_error hogl_cmdbuf_ubo_slice(hogl_cmdbuf* cb, hogl_ubo_ring* ring, hogl_ubo_slice slice, unsigned int bp);
+
+/**
+ * @brief Records uniform data, the data is copied into the command buffer and pushed to the ring on replay
+ * so recording threads never touch the ring
+ * @param cb Command buffer to record to
+ * @param ring Ring to push the data to on replay
+ * @param bp Binding point to bind the data to
+ * @param data Uniform block data
+ * @param size Size of the data
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the command storage could not be expanded
+*/
+HOGL_API hogl_error hogl_cmdbuf_ubo_data(hogl_cmdbuf* cb, hogl_ubo_ring* ring, unsigned int bp, const void* data, size_t size);
+
+/**
+ * @brief Records a depth test change
+ * @param cb Command buffer to record to
+ * @param depth hogl_render_depth enum value
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the command storage could not be expanded
+*/
+HOGL_API hogl_error hogl_cmdbuf_depth(hogl_cmdbuf* cb, hogl_render_depth depth);
+
+/**
+ * @brief Records a hogl_render_a call
+ * @param cb Command buffer to record to
+ * @param mode Mode to interpret data as
+ * @param vertices Number of vertices inside the vao
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the command storage could not be expanded
+*/
+HOGL_API hogl_error hogl_cmdbuf_render_a(hogl_cmdbuf* cb, hogl_render_mode mode, unsigned int vertices);
+
+/**
+ * @brief Records a hogl_render_e call
+ * @param cb Command buffer to record to
+ * @param mode Mode to interpret data as
+ * @param vertices Number of indices inside the ebo
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the command storage could not be expanded
+*/
+HOGL_API hogl_error hogl_cmdbuf_render_e(hogl_cmdbuf* cb, hogl_render_mode mode, unsigned int vertices);
+
+/**
+ * @brief Records a hogl_render_ai call
+ * @param cb Command buffer to record to
+ * @param mode Mode to interpret data as
+ * @param vertices Number of vertices inside the vao
+ * @param instances Number of instances
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the command storage could not be expanded
+*/
+HOGL_API hogl_error hogl_cmdbuf_render_ai(hogl_cmdbuf* cb, hogl_render_mode mode, unsigned int vertices, unsigned int instances);
+
+/**
+ * @brief Records a hogl_render_ei call
+ * @param cb Command buffer to record to
+ * @param mode Mode to interpret data as
+ * @param vertices Number of indices inside the ebo
+ * @param instances Number of instances
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the command storage could not be expanded
+*/
+HOGL_API hogl_error hogl_cmdbuf_render_ei(hogl_cmdbuf* cb, hogl_render_mode mode, unsigned int vertices, unsigned int instances);
+
+/**
+ * @brief Records a hogl_render_ebv call, or hogl_render_ebvi if instances is not 0
+ * @param cb Command buffer to record to
+ * @param mode Mode to interpret data as
+ * @param vertices Number of indices to draw
+ * @param first_index First index inside the ebo
+ * @param base_vertex Value added to every index before fetching vertices
+ * @param instances Number of instances, 0 draws without instancing
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the command storage could not be expanded
+*/
+HOGL_API hogl_error hogl_cmdbuf_render_ebv(hogl_cmdbuf* cb, hogl_render_mode mode, unsigned int vertices, unsigned int first_index, int base_vertex, unsigned int instances);
+
+/**
+ * @brief Records an indirect buffer bind followed by a hogl_render_mei call
+ * @param cb Command buffer to record to
+ * @param ib Indirect buffer to draw from, must stay alive until the command buffer is replayed
+ * @param mode Mode to interpret data as
+ * @param first Index of the first command inside the indirect buffer
+ * @param count Number of commands to draw
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the command storage could not be expanded
+*/
+HOGL_API hogl_error hogl_cmdbuf_render_mei(hogl_cmdbuf* cb, hogl_indirect_buffer* ib, hogl_render_mode mode, size_t first, size_t count);
+
+/**
+ * @brief Executes all recorded commands in order, must be called on the thread with the active OpenGL context
+ * and after the recording thread is done with the command buffer, the commands are kept so the buffer can
+ * be replayed again
+ * @param cb Command buffer to replay
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_UNKNOWN_MODE		if a recorded render mode is invalid
+ *		HOGL_ERROR_BAD_ARGUMENT		if a command has an unknown type or an invalid size
+ * 		HOGL_ERROR_OPENGL_GENERIC	if hogl_gl_check failed at any point
+ *		any error of hogl_ubo_ring_push, replay stops at the first failing command
+*/
+HOGL_API hogl_error hogl_cmdbuf_replay(hogl_cmdbuf* cb);
+
+/**
+ * @brief Replays several command buffers in the order they are given, used to submit buffers recorded by
+ * different threads
+ * @param cbs Command buffers to replay
+ * @param count Number of command buffers
+ * @return Returns error codes:
+ *		same as hogl_cmdbuf_replay
+*/
+HOGL_API hogl_error hogl_cmdbuf_replay_n(hogl_cmdbuf** cbs, size_t count);
+
+/**
+ * @brief Frees the command buffer
+ * @param cb Command buffer to free
+*/
+HOGL_API void hogl_cmdbuf_free(hogl_cmdbuf* cb);
+
+#endif
\ No newline at end of file
@@ -1,21 +1,44 @@
 #include "hogl_gl_primitive.h"
 
+#include <string.h>
+
 #include <gl/glad.h>
 #include <gl/glfw3.h>
 
+#include "hogl_core/graphics/hogl_gl_state.h"
 #include "hogl_core/shared/hogl_log.h"
 #include "hogl_core/shared/hogl_memory.h"
 
 #define SHADER_LOG_LENGTH 512
 #define MIN_FBO_COLOR_ATTACHMENT 8
 
+// Updates up to these sizes are copied with glBufferSubData instead of mapping the buffer
+#ifndef HOGL_GL_SUBDATA_THRESHOLD
+#define HOGL_GL_SUBDATA_THRESHOLD 4096
+#endif
+
+// Stream writes mostly map orphaned or appended storage unsynchronized, so mapping pays off sooner
+#ifndef HOGL_GL_SUBDATA_THRESHOLD_STREAM
+#define HOGL_GL_SUBDATA_THRESHOLD_STREAM 1024
+#endif
+
+// Static buffers are usually still read by the GPU, a synchronized map waits for it while the driver can stage a copy
+#ifndef HOGL_GL_SUBDATA_THRESHOLD_STATIC
+#define HOGL_GL_SUBDATA_THRESHOLD_STATIC 65536
+#endif
+
+// Nanoseconds to wait for a stream buffer fence before checking it again
+#define STREAM_WAIT_TIMEOUT 1000000
+
 typedef struct _hogl_vbo_meta {
 	unsigned int type;
 	unsigned int usage;
 
-#ifndef HOGL_DISABLE_GL_BOUND_CHECKING
+	// Needed to tell whole buffer updates apart
 	size_t size;
-#endif
+
+	// End of the data written since the storage was last allocated or orphaned, nothing past it can be read by issued draws
+	size_t append_offset;
 
 #ifndef HOGL_DISABLE_GL_WARNING
 	bool has_data;
@@ -28,16 +51,81 @@ typedef struct _hogl_vao {
 	unsigned int* vbo_ids;
 	hogl_vbo_meta* vbos;
 	size_t vbo_count;
+
+	// Set once a stream buffer was attached, its data does not live inside the vbos
+	bool streamed;
+
+	// Index type of the element buffer, used by the indexed draws while the vao is bound
+	unsigned int index_type;
 } hogl_vao;
 
+typedef struct _hogl_stream_buffer {
+	unsigned int id;
+	unsigned int type;
+
+	// Persistent mapping of the whole buffer
+	char* mapping;
+	size_t region_size;
+	unsigned int region_count;
+
+	// Region being written and how much of it is allocated
+	unsigned int region;
+	size_t used;
+
+	// Fence of every region, NULL if the region is not used by the GPU
+	GLsync* fences;
+} hogl_stream_buffer;
+
 typedef struct _hogl_ubo {
 	unsigned int id;
 
-#ifndef HOGL_DISABLE_GL_BOUND_CHECKING
 	size_t stride;
-#endif
+
+	// Range bound to the binding point
+	unsigned int bp;
+	size_t offset;
 } hogl_ubo;
 
+typedef struct _hogl_ubo_ring {
+	hogl_stream_buffer* sb;
+
+	// GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT of the context
+	size_t alignment;
+} hogl_ubo_ring;
+
+typedef struct _hogl_indirect_buffer {
+	unsigned int id;
+
+	// Number of commands
+	size_t capacity;
+} hogl_indirect_buffer;
+
+typedef struct _hogl_geometry_span {
+	size_t offset;
+	size_t size;
+} hogl_geometry_span;
+
+// Sorted list of free spans, neighbours are merged when a span is released
+typedef struct _hogl_geometry_free_list {
+	hogl_geometry_span* spans;
+	size_t count;
+	size_t capacity;
+} hogl_geometry_free_list;
+
+typedef struct _hogl_geometry_pool {
+	hogl_vao* vao;
+	size_t vertex_size;
+	size_t index_size;
+	hogl_index_type index_type;
+
+	// Total number of vertices and indices
+	size_t vertex_capacity;
+	size_t index_capacity;
+
+	hogl_geometry_free_list vertices;
+	hogl_geometry_free_list indices;
+} hogl_geometry_pool;
+
 typedef struct _hogl_shader {
 	unsigned int id;
 } hogl_shader;
@@ -60,6 +148,18 @@ typedef struct _hogl_renderbuffer {
 	unsigned int attachment_type;
 } hogl_renderbuffer;
 
+unsigned int __get_index_type(hogl_index_type type) {
+	switch (type) {
+	case HOGL_IT_UINT32:
+		return GL_UNSIGNED_INT;
+	case HOGL_IT_UINT16:
+		return GL_UNSIGNED_SHORT;
+	default:
+		hogl_log_warn("No index type specified, assuming UINT32");
+		return GL_UNSIGNED_INT;
+	}
+}
+
 void __parse_vbo_from_desc(hogl_vbo_meta* vbo, hogl_vbo_desc* desc) {
 	// Type
 	switch (desc->type)
@@ -92,9 +192,10 @@ void __parse_vbo_from_desc(hogl_vbo_meta* vbo, hogl_vbo_desc* desc) {
 		vbo->usage = GL_DYNAMIC_DRAW;
 	}
 
-#ifndef HOGL_DISABLE_GL_BOUND_CHECKING
 	vbo->size = desc->data_size;
+	vbo->append_offset = desc->data != NULL ? desc->data_size : 0;
 
+#ifndef HOGL_DISABLE_GL_BOUND_CHECKING
 	if (vbo->size == 0) {
 		hogl_log_warn("Creating a 0 length vbo");
 	}
@@ -119,18 +220,70 @@ unsigned int __get_type(hogl_element_type type) {
 		return GL_UNSIGNED_BYTE;
 	case HOGL_ET_UINT:
 		return GL_UNSIGNED_INT;
+	case HOGL_ET_USHORT:
+		return GL_UNSIGNED_SHORT;
 	default:
 		hogl_log_warn("No element type specified, assuming FLOAT");
 		return GL_FLOAT;
 	}
 }
 
-void __write_buffer_data(unsigned int target, size_t offset, void* data, size_t size) {
-	void* dst = glMapBuffer(target, GL_WRITE_ONLY);
+size_t __subdata_threshold(unsigned int usage) {
+	switch (usage) {
+	case GL_STREAM_DRAW:
+		return HOGL_GL_SUBDATA_THRESHOLD_STREAM;
+	case GL_STATIC_DRAW:
+		return HOGL_GL_SUBDATA_THRESHOLD_STATIC;
+	default:
+		return HOGL_GL_SUBDATA_THRESHOLD;
+	}
+}
+
+hogl_error __write_buffer_data(unsigned int target, unsigned int usage, size_t buffer_size, size_t* append_offset, size_t offset, void* data, size_t size) {
+	GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+	void* dst = NULL;
+
+	if (size == 0) {
+		return HOGL_ERROR_NONE;
+	}
+
+	// Rewriting a whole stream buffer orphans it, the draws still reading the old storage keep it
+	if (usage == GL_STREAM_DRAW && offset == 0 && size == buffer_size) {
+		glBufferData(target, buffer_size, NULL, usage);
+		hogl_gl_check();
+
+		access |= GL_MAP_UNSYNCHRONIZED_BIT;
+	}
+	// Appending past everything written since the last orphan can't touch data issued draws read
+	else if (usage == GL_STREAM_DRAW && append_offset != NULL && offset >= (*append_offset)) {
+		access |= GL_MAP_UNSYNCHRONIZED_BIT;
+	}
+
+	if (append_offset != NULL && (*append_offset) < offset + size) {
+		(*append_offset) = offset + size;
+	}
+
+	// Small updates are cheaper to copy through the driver than to map
+	if (size <= __subdata_threshold(usage)) {
+		glBufferSubData(target, offset, size, data);
+		hogl_gl_check();
+		return HOGL_ERROR_NONE;
+	}
+
+	// Only map the range that is written
+	dst = glMapBufferRange(target, offset, size, access);
 	hogl_gl_check();
-	hogl_smemcpy((char*)dst + offset, data, size);
+
+	if (dst == NULL) {
+		hogl_log_error("Failed to map %ld bytes of a buffer at offset %ld", size, offset);
+		return HOGL_ERROR_OPENGL_GENERIC;
+	}
+
+	hogl_smemcpy(dst, data, size);
 	glUnmapBuffer(target);
 	hogl_gl_check();
+
+	return HOGL_ERROR_NONE;
 }
 
 void __check_shader_status(unsigned int shader, unsigned int property, char** log) {
@@ -281,17 +434,27 @@ unsigned int __parse_rbuffer(hogl_rbuffer_format format) {
 	}
 }
 
-void hogl_vao_new(hogl_vao** vao) {
+hogl_error hogl_vao_new(hogl_vao** vao) {
 	(*vao) = (hogl_vao*)hogl_malloc(sizeof(hogl_vao));
+
+	if ((*vao) == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
 	(*vao)->vbos = NULL;
 	(*vao)->vbo_ids = NULL;
+	(*vao)->vbo_count = 0;
+	(*vao)->streamed = false;
+	(*vao)->index_type = GL_UNSIGNED_INT;
 	glGenVertexArrays(1, &(*vao)->id);
-	hogl_gl_check();
+	hogl_gl_check_cleanup(hogl_free(*vao); (*vao) = NULL);
+
+	return HOGL_ERROR_NONE;
 }
 
 void hogl_vao_bind(hogl_vao* vao) {
 #ifndef HOGL_DISABLE_GL_WARNING
-	if (vao->vbo_count == 0) {
+	if (vao->vbo_count == 0 && !vao->streamed) {
 		hogl_log_warn("Binding vao without any vertex buffers");
 	}
 	else {
@@ -303,8 +466,10 @@ void hogl_vao_bind(hogl_vao* vao) {
 	}
 #endif
 
-	glBindVertexArray(vao->id);
-	hogl_gl_check();
+	if (hogl_gl_state_vao(vao->id, vao->index_type)) {
+		glBindVertexArray(vao->id);
+		hogl_gl_check();
+	}
 }
 
 hogl_error hogl_vao_alloc_buffers(hogl_vao* vao, hogl_vbo_desc* descs, size_t size) {
@@ -315,8 +480,17 @@ hogl_error hogl_vao_alloc_buffers(hogl_vao* vao, hogl_vbo_desc* descs, size_t si
 	}
 #endif
 
-	glBindVertexArray(vao->id);
-	hogl_gl_check();
+	// Element buffer index type has to be known when the vao is bound
+	for (size_t i = 0; i < size; i++) {
+		if (descs[i].type == HOGL_VBOT_ELEMENT_BUFFER) {
+			vao->index_type = __get_index_type(descs[i].index_type);
+		}
+	}
+
+	if (hogl_gl_state_vao(vao->id, vao->index_type)) {
+		glBindVertexArray(vao->id);
+		hogl_gl_check();
+	}
 
 	// Allocate a vbo buffer
 	vao->vbos = (hogl_vbo_meta*)hogl_malloc(sizeof(hogl_vbo_meta) * size);
@@ -330,8 +504,10 @@ hogl_error hogl_vao_alloc_buffers(hogl_vao* vao, hogl_vbo_desc* descs, size_t si
 		__parse_vbo_from_desc(&vao->vbos[i], &descs[i]);
 
 		// Bind and preallocate buffer
-		glBindBuffer(vao->vbos[i].type, vao->vbo_ids[i]);
-		hogl_gl_check();
+		if (hogl_gl_state_buffer(vao->vbos[i].type, vao->vbo_ids[i])) {
+			glBindBuffer(vao->vbos[i].type, vao->vbo_ids[i]);
+			hogl_gl_check();
+		}
 		glBufferData(vao->vbos[i].type, descs[i].data_size, descs[i].data, vao->vbos[i].usage);
 		hogl_gl_check();
 
@@ -378,13 +554,26 @@ hogl_error hogl_vao_buffer_resize(hogl_vao* vao, int vbo, size_t size, void* dat
 	}
 #endif
 
-	glBindVertexArray(vao->id);
-	hogl_gl_check();
-	glBindBuffer(vao->vbos[vbo].type, vao->vbo_ids[vbo]);
-	hogl_gl_check();
+	if (hogl_gl_state_vao(vao->id, vao->index_type)) {
+		glBindVertexArray(vao->id);
+		hogl_gl_check();
+	}
+	if (hogl_gl_state_buffer(vao->vbos[vbo].type, vao->vbo_ids[vbo])) {
+		glBindBuffer(vao->vbos[vbo].type, vao->vbo_ids[vbo]);
+		hogl_gl_check();
+	}
 	glBufferData(vao->vbos[vbo].type, size, data, vao->vbos[vbo].usage);
 	hogl_gl_check();
 
+	vao->vbos[vbo].size = size;
+	vao->vbos[vbo].append_offset = data != NULL ? size : 0;
+
+#ifndef HOGL_DISABLE_GL_WARNING
+	if (data != NULL) {
+		vao->vbos[vbo].has_data = true;
+	}
+#endif
+
 	return HOGL_ERROR_NONE;
 }
 
@@ -408,20 +597,52 @@ hogl_error hogl_vao_buffer_data(hogl_vao* vao, int vbo, size_t vbo_offset, void*
 	}
 #endif
 
-	glBindVertexArray(vao->id);
-	hogl_gl_check();
-	glBindBuffer(vao->vbos[vbo].type, vao->vbo_ids[vbo]);
-	hogl_gl_check();
-	__write_buffer_data(vao->vbos[vbo].type, vbo_offset, data, size);
+	if (hogl_gl_state_vao(vao->id, vao->index_type)) {
+		glBindVertexArray(vao->id);
+		hogl_gl_check();
+	}
+	if (hogl_gl_state_buffer(vao->vbos[vbo].type, vao->vbo_ids[vbo])) {
+		glBindBuffer(vao->vbos[vbo].type, vao->vbo_ids[vbo]);
+		hogl_gl_check();
+	}
 
 #ifndef HOGL_DISABLE_GL_WARNING
 	vao->vbos[vbo].has_data = true;
 #endif
 
-	return HOGL_ERROR_NONE;
+	return __write_buffer_data(vao->vbos[vbo].type, vao->vbos[vbo].usage, vao->vbos[vbo].size, &vao->vbos[vbo].append_offset,
+		vbo_offset, data, size);
+}
+
+hogl_index_type hogl_narrow_indices(const unsigned int* indices, size_t count, void* narrowed) {
+	// Check everything first so nothing is written if the indices can't be narrowed
+	for (size_t i = 0; i < count; i++) {
+		if (indices[i] > 0xFFFF) {
+			return HOGL_IT_UINT32;
+		}
+	}
+
+	// Copied through memcpy so narrowing in place doesn't access the same memory as two types, going forward is safe
+	// since every 16 bit index is written at or before the 32 bit one it comes from
+	for (size_t i = 0; i < count; i++) {
+		unsigned int index = 0;
+		unsigned short value = 0;
+
+		memcpy(&index, (const char*)indices + i * sizeof(unsigned int), sizeof(unsigned int));
+		value = (unsigned short)index;
+		memcpy((char*)narrowed + i * sizeof(unsigned short), &value, sizeof(unsigned short));
+	}
+
+	return HOGL_IT_UINT16;
 }
 
 void hogl_vao_free(hogl_vao* vao) {
+	for (size_t i = 0; i < vao->vbo_count; i++) {
+		hogl_gl_state_forget_buffer(vao->vbo_ids[i]);
+	}
+
+	hogl_gl_state_forget_vao(vao->id);
+
 	glDeleteBuffers(vao->vbo_count, vao->vbo_ids);
 	hogl_gl_check();
 	glDeleteVertexArrays(1, &vao->id);
@@ -431,6 +652,203 @@ void hogl_vao_free(hogl_vao* vao) {
 	hogl_free(vao);
 }
 
+// Frees a stream buffer whose creation failed part way
+void __stream_buffer_discard(hogl_stream_buffer** sb) {
+	if ((*sb)->id != 0) {
+		hogl_gl_state_forget_buffer((*sb)->id);
+		glDeleteBuffers(1, &(*sb)->id);
+	}
+
+	hogl_free((*sb)->fences);
+	hogl_free((*sb));
+	(*sb) = NULL;
+}
+
+hogl_error __stream_buffer_create(hogl_stream_buffer** sb, unsigned int type, size_t region_size, unsigned int regions) {
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+#ifndef HOGL_DISABLE_GL_BOUND_CHECKING
+	if (region_size == 0 || regions == 0) {
+		hogl_log_error("Trying to allocate a stream buffer with %ld regions of %ld bytes", regions, region_size);
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+#endif
+
+	if (!GLAD_GL_VERSION_4_4) {
+		hogl_log_error("Stream buffers need OpenGL 4.4");
+		return HOGL_ERROR_OPENGL_UNSUPPORTED;
+	}
+
+	(*sb) = (hogl_stream_buffer*)hogl_malloc(sizeof(hogl_stream_buffer));
+
+	if ((*sb) == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	(*sb)->id = 0;
+	(*sb)->type = type;
+	(*sb)->region_size = region_size;
+	(*sb)->region_count = regions;
+	(*sb)->used = 0;
+
+	// First begin moves to region 0
+	(*sb)->region = regions - 1;
+
+	(*sb)->fences = (GLsync*)hogl_malloc(sizeof(GLsync) * regions);
+
+	if ((*sb)->fences == NULL) {
+		__stream_buffer_discard(sb);
+		return HOGL_ERROR_MEMORY;
+	}
+
+	hogl_memset((*sb)->fences, 0, sizeof(GLsync) * regions);
+
+	glGenBuffers(1, &(*sb)->id);
+	hogl_gl_check_cleanup(__stream_buffer_discard(sb));
+
+	// Use the copy write target so the vao element buffer binding is not changed
+	if (hogl_gl_state_buffer(GL_COPY_WRITE_BUFFER, (*sb)->id)) {
+		glBindBuffer(GL_COPY_WRITE_BUFFER, (*sb)->id);
+		hogl_gl_check_cleanup(__stream_buffer_discard(sb));
+	}
+	glBufferStorage(GL_COPY_WRITE_BUFFER, region_size * regions, NULL, flags);
+	hogl_gl_check_cleanup(__stream_buffer_discard(sb));
+
+	(*sb)->mapping = (char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, region_size * regions, flags);
+	hogl_gl_check_cleanup(__stream_buffer_discard(sb));
+
+	if ((*sb)->mapping == NULL) {
+		hogl_log_error("Failed to map stream buffer");
+		__stream_buffer_discard(sb);
+		return HOGL_ERROR_OPENGL_GENERIC;
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_stream_buffer_new(hogl_stream_buffer** sb, hogl_vbo_type type, size_t region_size, unsigned int regions) {
+	// Element stream buffers could not be bound to a vao
+	if (type != HOGL_VBOT_ARRAY_BUFFER) {
+		hogl_log_error("Only array stream buffers are supported");
+		return HOGL_ERROR_BAD_ARGUMENT;
+	}
+
+	return __stream_buffer_create(sb, GL_ARRAY_BUFFER, region_size, regions);
+}
+
+hogl_error hogl_stream_buffer_begin(hogl_stream_buffer* sb, void** data) {
+	GLsync fence = NULL;
+	GLenum status = GL_TIMEOUT_EXPIRED;
+
+	sb->region = (sb->region + 1) % sb->region_count;
+	sb->used = 0;
+
+	fence = sb->fences[sb->region];
+
+	// Wait until the GPU is done with the commands that read the region
+	if (fence != NULL) {
+		while (status == GL_TIMEOUT_EXPIRED) {
+			status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, STREAM_WAIT_TIMEOUT);
+		}
+
+		glDeleteSync(fence);
+		sb->fences[sb->region] = NULL;
+
+		if (status == GL_WAIT_FAILED) {
+			hogl_log_error("Failed to wait for stream buffer region %ld", sb->region);
+			return HOGL_ERROR_OPENGL_GENERIC;
+		}
+
+		hogl_gl_check();
+	}
+
+	if (data != NULL) {
+		(*data) = sb->mapping + sb->region * sb->region_size;
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_stream_buffer_alloc(hogl_stream_buffer* sb, size_t size, size_t alignment, void** data, size_t* offset) {
+	size_t base = sb->region * sb->region_size;
+	size_t start = base + sb->used;
+
+	if (alignment > 1) {
+		start = (start + alignment - 1) / alignment * alignment;
+	}
+
+	if (start + size > base + sb->region_size) {
+		hogl_log_error("Trying to allocate %ld bytes from a stream buffer region with only %ld bytes left", size,
+			base + sb->region_size - (start < base + sb->region_size ? start : base + sb->region_size));
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+
+	sb->used = start + size - base;
+
+	(*data) = sb->mapping + start;
+	(*offset) = start;
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_stream_buffer_attach(hogl_stream_buffer* sb, hogl_vao* vao, hogl_ap_desc* descs, size_t size) {
+	size_t base = sb->region * sb->region_size;
+
+	if (sb->type != GL_ARRAY_BUFFER) {
+		hogl_log_error("Only array stream buffers can be attached to a vao");
+		return HOGL_ERROR_BAD_ARGUMENT;
+	}
+
+	if (hogl_gl_state_vao(vao->id, vao->index_type)) {
+		glBindVertexArray(vao->id);
+		hogl_gl_check();
+	}
+	if (hogl_gl_state_buffer(GL_ARRAY_BUFFER, sb->id)) {
+		glBindBuffer(GL_ARRAY_BUFFER, sb->id);
+		hogl_gl_check();
+	}
+
+	for (size_t i = 0; i < size; i++) {
+		glEnableVertexAttribArray(descs[i].index);
+		hogl_gl_check();
+		glVertexAttribPointer(
+			descs[i].index,
+			descs[i].ecount,
+			__get_type(descs[i].type),
+			descs[i].normalized,
+			descs[i].stride,
+			(void*)(base + descs[i].offset));
+		hogl_gl_check();
+		glVertexAttribDivisor(descs[i].index, descs[i].divisor);
+		hogl_gl_check();
+	}
+
+	vao->streamed = true;
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_stream_buffer_end(hogl_stream_buffer* sb) {
+	sb->fences[sb->region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	hogl_gl_check();
+	return HOGL_ERROR_NONE;
+}
+
+void hogl_stream_buffer_free(hogl_stream_buffer* sb) {
+	for (unsigned int i = 0; i < sb->region_count; i++) {
+		if (sb->fences[i] != NULL) {
+			glDeleteSync(sb->fences[i]);
+		}
+	}
+
+	// Deleting the buffer also unmaps it
+	hogl_gl_state_forget_buffer(sb->id);
+	glDeleteBuffers(1, &sb->id);
+	hogl_gl_check();
+	hogl_free(sb->fences);
+	hogl_free(sb);
+}
+
 hogl_error hogl_ubo_new(hogl_ubo** ubo, hogl_ubo_desc desc) {
 #ifndef HOGL_DISABLE_GL_WARNING
 	if (desc.stride % 4 != 0) {
@@ -448,22 +866,37 @@ hogl_error hogl_ubo_new(hogl_ubo** ubo, hogl_ubo_desc desc) {
 	(*ubo) = (hogl_ubo*)hogl_malloc(sizeof(hogl_ubo));
 	glGenBuffers(1, &(*ubo)->id);
 	hogl_gl_check();
-	glBindBuffer(GL_UNIFORM_BUFFER, (*ubo)->id);
-	hogl_gl_check();
+	if (hogl_gl_state_buffer(GL_UNIFORM_BUFFER, (*ubo)->id)) {
+		glBindBuffer(GL_UNIFORM_BUFFER, (*ubo)->id);
+		hogl_gl_check();
+	}
 	glBufferData(GL_UNIFORM_BUFFER, desc.stride, NULL, GL_DYNAMIC_DRAW);
 	hogl_gl_check();
 
 	(*ubo)->stride = desc.stride;
+	(*ubo)->bp = desc.bp;
+	(*ubo)->offset = desc.offset;
 
-	glBindBufferRange(GL_UNIFORM_BUFFER, desc.bp, (*ubo)->id, desc.offset, desc.stride);
-	hogl_gl_check();
+	if (hogl_gl_state_uniform_range(desc.bp, (*ubo)->id, desc.offset, desc.stride)) {
+		glBindBufferRange(GL_UNIFORM_BUFFER, desc.bp, (*ubo)->id, desc.offset, desc.stride);
+		hogl_gl_check();
+		hogl_gl_state_buffer_changed(GL_UNIFORM_BUFFER, (*ubo)->id);
+	}
 
 	return HOGL_ERROR_NONE;
 }
 
 void hogl_ubo_bind(hogl_ubo* ubo) {
-	glBindBuffer(GL_UNIFORM_BUFFER, ubo->id);
-	hogl_gl_check();
+	if (hogl_gl_state_buffer(GL_UNIFORM_BUFFER, ubo->id)) {
+		glBindBuffer(GL_UNIFORM_BUFFER, ubo->id);
+		hogl_gl_check();
+	}
+
+	// The binding point could have been taken by another buffer, e.g. a ubo ring slice
+	if (hogl_gl_state_uniform_range(ubo->bp, ubo->id, ubo->offset, ubo->stride)) {
+		glBindBufferRange(GL_UNIFORM_BUFFER, ubo->bp, ubo->id, ubo->offset, ubo->stride);
+		hogl_gl_check();
+	}
 }
 
 hogl_error hogl_ubo_data(hogl_ubo* ubo, void* data, size_t size) {
@@ -474,19 +907,478 @@ hogl_error hogl_ubo_data(hogl_ubo* ubo, void* data, size_t size) {
 	}
 #endif
 
-	glBindBuffer(GL_UNIFORM_BUFFER, ubo->id);
-	hogl_gl_check();
-	__write_buffer_data(GL_UNIFORM_BUFFER, 0, data, size);
-
-	return HOGL_ERROR_NONE;
+	if (hogl_gl_state_buffer(GL_UNIFORM_BUFFER, ubo->id)) {
+		glBindBuffer(GL_UNIFORM_BUFFER, ubo->id);
+		hogl_gl_check();
+	}
+	return __write_buffer_data(GL_UNIFORM_BUFFER, GL_DYNAMIC_DRAW, ubo->stride, NULL, 0, data, size);
 }
 
 void hogl_ubo_free(hogl_ubo* ubo) {
+	hogl_gl_state_forget_buffer(ubo->id);
 	glDeleteBuffers(1, &ubo->id);
 	hogl_gl_check();
 	hogl_free(ubo);
 }
 
+hogl_error hogl_ubo_ring_new(hogl_ubo_ring** ring, size_t frame_size, unsigned int frames) {
+	hogl_error err = HOGL_ERROR_NONE;
+	int alignment = 0;
+
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	hogl_gl_check();
+
+	if (alignment < 1) {
+		alignment = 1;
+	}
+
+	// Every frame has to start at an aligned offset
+	frame_size = (frame_size + alignment - 1) / alignment * alignment;
+
+	(*ring) = (hogl_ubo_ring*)hogl_malloc(sizeof(hogl_ubo_ring));
+
+	if ((*ring) == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	(*ring)->alignment = (size_t)alignment;
+
+	err = __stream_buffer_create(&(*ring)->sb, GL_UNIFORM_BUFFER, frame_size, frames);
+
+	if (err != HOGL_ERROR_NONE) {
+		hogl_free((*ring));
+		(*ring) = NULL;
+		return err;
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_ubo_ring_begin(hogl_ubo_ring* ring) {
+	return hogl_stream_buffer_begin(ring->sb, NULL);
+}
+
+hogl_error hogl_ubo_ring_alloc(hogl_ubo_ring* ring, size_t size, void** data, hogl_ubo_slice* slice) {
+	hogl_error err = hogl_stream_buffer_alloc(ring->sb, size, ring->alignment, data, &slice->offset);
+
+	if (err != HOGL_ERROR_NONE) {
+		return err;
+	}
+
+	slice->size = size;
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_ubo_ring_bind(hogl_ubo_ring* ring, hogl_ubo_slice slice, unsigned int bp) {
+	if (hogl_gl_state_uniform_range(bp, ring->sb->id, slice.offset, slice.size)) {
+		glBindBufferRange(GL_UNIFORM_BUFFER, bp, ring->sb->id, slice.offset, slice.size);
+		hogl_gl_check();
+		hogl_gl_state_buffer_changed(GL_UNIFORM_BUFFER, ring->sb->id);
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_ubo_ring_push(hogl_ubo_ring* ring, unsigned int bp, void* data, size_t size) {
+	hogl_ubo_slice slice;
+	void* dst = NULL;
+	hogl_error err = hogl_ubo_ring_alloc(ring, size, &dst, &slice);
+
+	if (err != HOGL_ERROR_NONE) {
+		return err;
+	}
+
+	hogl_smemcpy(dst, data, size);
+
+	return hogl_ubo_ring_bind(ring, slice, bp);
+}
+
+hogl_error hogl_ubo_ring_end(hogl_ubo_ring* ring) {
+	return hogl_stream_buffer_end(ring->sb);
+}
+
+void hogl_ubo_ring_free(hogl_ubo_ring* ring) {
+	hogl_stream_buffer_free(ring->sb);
+	hogl_free(ring);
+}
+
+// Frees an indirect buffer whose creation failed part way
+void __indirect_discard(hogl_indirect_buffer** ib) {
+	if ((*ib)->id != 0) {
+		hogl_gl_state_forget_buffer((*ib)->id);
+		glDeleteBuffers(1, &(*ib)->id);
+	}
+
+	hogl_free((*ib));
+	(*ib) = NULL;
+}
+
+hogl_error hogl_indirect_new(hogl_indirect_buffer** ib, size_t capacity) {
+#ifndef HOGL_DISABLE_GL_BOUND_CHECKING
+	if (capacity == 0) {
+		hogl_log_error("Trying to allocate a 0 size indirect buffer, aborting");
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+#endif
+
+	if (!GLAD_GL_VERSION_4_3) {
+		hogl_log_error("Indirect buffers require OpenGL 4.3");
+		return HOGL_ERROR_OPENGL_UNSUPPORTED;
+	}
+
+	(*ib) = (hogl_indirect_buffer*)hogl_malloc(sizeof(hogl_indirect_buffer));
+
+	if ((*ib) == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	(*ib)->id = 0;
+	(*ib)->capacity = capacity;
+
+	glGenBuffers(1, &(*ib)->id);
+	hogl_gl_check_cleanup(__indirect_discard(ib));
+	if (hogl_gl_state_buffer(GL_DRAW_INDIRECT_BUFFER, (*ib)->id)) {
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, (*ib)->id);
+		hogl_gl_check_cleanup(__indirect_discard(ib));
+	}
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, capacity * sizeof(hogl_draw_elements_indirect), NULL, GL_DYNAMIC_DRAW);
+	hogl_gl_check_cleanup(__indirect_discard(ib));
+
+	return HOGL_ERROR_NONE;
+}
+
+void hogl_indirect_bind(hogl_indirect_buffer* ib) {
+	if (hogl_gl_state_buffer(GL_DRAW_INDIRECT_BUFFER, ib->id)) {
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, ib->id);
+		hogl_gl_check();
+	}
+}
+
+hogl_error hogl_indirect_bind_storage(hogl_indirect_buffer* ib, unsigned int bp) {
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bp, ib->id);
+	hogl_gl_check();
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_indirect_barrier(void) {
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+	hogl_gl_check();
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_indirect_data(hogl_indirect_buffer* ib, size_t first, const hogl_draw_elements_indirect* commands, size_t count) {
+#ifndef HOGL_DISABLE_GL_BOUND_CHECKING
+	if (first + count > ib->capacity) {
+		hogl_log_error("Trying to write commands %ld to %ld into an indirect buffer of %ld commands", first, first + count, ib->capacity);
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+#endif
+
+	if (hogl_gl_state_buffer(GL_DRAW_INDIRECT_BUFFER, ib->id)) {
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, ib->id);
+		hogl_gl_check();
+	}
+
+	return __write_buffer_data(GL_DRAW_INDIRECT_BUFFER, GL_DYNAMIC_DRAW, ib->capacity * sizeof(hogl_draw_elements_indirect), NULL,
+		first * sizeof(hogl_draw_elements_indirect), (void*)commands, count * sizeof(hogl_draw_elements_indirect));
+}
+
+size_t hogl_indirect_capacity(hogl_indirect_buffer* ib) {
+	return ib->capacity;
+}
+
+void hogl_indirect_free(hogl_indirect_buffer* ib) {
+	hogl_gl_state_forget_buffer(ib->id);
+	glDeleteBuffers(1, &ib->id);
+	hogl_gl_check();
+	hogl_free(ib);
+}
+
+hogl_error __free_list_reserve(hogl_geometry_free_list* list, size_t count) {
+	size_t new_capacity = list->capacity == 0 ? 16 : list->capacity;
+	hogl_geometry_span* new_spans = NULL;
+
+	if (list->count + count <= list->capacity) {
+		return HOGL_ERROR_NONE;
+	}
+
+	while (new_capacity < list->count + count) {
+		new_capacity *= 2;
+	}
+
+	new_spans = hogl_realloc(list->spans, new_capacity * sizeof(hogl_geometry_span));
+	if (new_spans == NULL) {
+		hogl_log_error("Failed to expand a geometry pool free list");
+		return HOGL_ERROR_MEMORY;
+	}
+
+	list->spans = new_spans;
+	list->capacity = new_capacity;
+	return HOGL_ERROR_NONE;
+}
+
+// First fit, takes the space from the start of the span
+bool __free_list_take(hogl_geometry_free_list* list, size_t size, size_t* offset) {
+	for (size_t i = 0; i < list->count; i++) {
+		hogl_geometry_span* span = &list->spans[i];
+
+		if (span->size < size) {
+			continue;
+		}
+
+		*offset = span->offset;
+		span->offset += size;
+		span->size -= size;
+
+		if (span->size == 0) {
+			memmove(&list->spans[i], &list->spans[i + 1], (list->count - i - 1) * sizeof(hogl_geometry_span));
+			list->count--;
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+hogl_error __free_list_give(hogl_geometry_free_list* list, size_t offset, size_t size) {
+	size_t lo = 0;
+	size_t hi = list->count;
+
+	if (size == 0) {
+		return HOGL_ERROR_NONE;
+	}
+
+	// First span after the released one
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if (list->spans[mid].offset < offset) {
+			lo = mid + 1;
+		}
+		else {
+			hi = mid;
+		}
+	}
+
+	bool merge_prev = lo > 0 && list->spans[lo - 1].offset + list->spans[lo - 1].size == offset;
+	bool merge_next = lo < list->count && offset + size == list->spans[lo].offset;
+
+	if (merge_prev && merge_next) {
+		list->spans[lo - 1].size += size + list->spans[lo].size;
+		memmove(&list->spans[lo], &list->spans[lo + 1], (list->count - lo - 1) * sizeof(hogl_geometry_span));
+		list->count--;
+		return HOGL_ERROR_NONE;
+	}
+
+	if (merge_prev) {
+		list->spans[lo - 1].size += size;
+		return HOGL_ERROR_NONE;
+	}
+
+	if (merge_next) {
+		list->spans[lo].offset = offset;
+		list->spans[lo].size += size;
+		return HOGL_ERROR_NONE;
+	}
+
+	if (__free_list_reserve(list, 1) != HOGL_ERROR_NONE) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	memmove(&list->spans[lo + 1], &list->spans[lo], (list->count - lo) * sizeof(hogl_geometry_span));
+	list->spans[lo].offset = offset;
+	list->spans[lo].size = size;
+	list->count++;
+	return HOGL_ERROR_NONE;
+}
+
+// Checks if any part of the span is already free
+bool __free_list_overlaps(hogl_geometry_free_list* list, size_t offset, size_t size) {
+	size_t lo = 0;
+	size_t hi = list->count;
+
+	if (size == 0) {
+		return false;
+	}
+
+	// First span starting at or after the offset
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if (list->spans[mid].offset < offset) {
+			lo = mid + 1;
+		}
+		else {
+			hi = mid;
+		}
+	}
+
+	return (lo > 0 && list->spans[lo - 1].offset + list->spans[lo - 1].size > offset) ||
+		(lo < list->count && list->spans[lo].offset < offset + size);
+}
+
+hogl_error hogl_geometry_pool_new(hogl_geometry_pool** pool, hogl_geometry_pool_desc desc) {
+	hogl_error err = HOGL_ERROR_NONE;
+	hogl_vbo_desc vbo_descs[2];
+
+#ifndef HOGL_DISABLE_GL_BOUND_CHECKING
+	if (desc.vertex_size == 0 || desc.vertices == 0 || desc.indices == 0) {
+		hogl_log_error("Trying to allocate a geometry pool of %ld vertices and %ld indices with %ld byte vertices",
+			desc.vertices, desc.indices, desc.vertex_size);
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+#endif
+
+	(*pool) = (hogl_geometry_pool*)hogl_malloc(sizeof(hogl_geometry_pool));
+
+	if ((*pool) == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	hogl_memset(*pool, 0, sizeof(hogl_geometry_pool));
+	(*pool)->vertex_capacity = desc.vertices;
+	(*pool)->index_capacity = desc.indices;
+	(*pool)->vertex_size = desc.vertex_size;
+	(*pool)->index_type = desc.index_type;
+	(*pool)->index_size = __get_index_type(desc.index_type) == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+
+	// The whole pool starts out free
+	if (__free_list_give(&(*pool)->vertices, 0, desc.vertices) != HOGL_ERROR_NONE ||
+		__free_list_give(&(*pool)->indices, 0, desc.indices) != HOGL_ERROR_NONE) {
+		hogl_geometry_pool_free(*pool);
+		(*pool) = NULL;
+		return HOGL_ERROR_MEMORY;
+	}
+
+	vbo_descs[0].type = HOGL_VBOT_ARRAY_BUFFER;
+	vbo_descs[0].usage = HOGL_VBOU_DYNAMIC;
+	vbo_descs[0].ap_desc = desc.ap_desc;
+	vbo_descs[0].desc_size = desc.desc_size;
+	vbo_descs[0].index_type = HOGL_IT_UINT32;
+	vbo_descs[0].data_size = desc.vertices * desc.vertex_size;
+	vbo_descs[0].data = NULL;
+
+	vbo_descs[1].type = HOGL_VBOT_ELEMENT_BUFFER;
+	vbo_descs[1].usage = HOGL_VBOU_DYNAMIC;
+	vbo_descs[1].ap_desc = NULL;
+	vbo_descs[1].desc_size = 0;
+	vbo_descs[1].index_type = desc.index_type;
+	vbo_descs[1].data_size = desc.indices * (*pool)->index_size;
+	vbo_descs[1].data = NULL;
+
+	err = hogl_vao_new(&(*pool)->vao);
+	if (err == HOGL_ERROR_NONE) {
+		err = hogl_vao_alloc_buffers((*pool)->vao, vbo_descs, 2);
+	}
+
+	if (err != HOGL_ERROR_NONE) {
+		hogl_geometry_pool_free(*pool);
+		(*pool) = NULL;
+		return err;
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_geometry_alloc(hogl_geometry_pool* pool, size_t vertices, size_t indices, hogl_geometry_range* range) {
+	size_t first_vertex = 0;
+	size_t first_index = 0;
+
+	// Indices are relative to the base vertex so only a single range has to fit the index type
+	if (pool->index_type == HOGL_IT_UINT16 && vertices > 0x10000) {
+		hogl_log_error("Geometry pool with 16 bit indices can't hold a mesh of %ld vertices", vertices);
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+
+	// Make sure giving the vertices back can't fail if the indices don't fit
+	if (__free_list_reserve(&pool->vertices, 1) != HOGL_ERROR_NONE) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	if (vertices != 0 && !__free_list_take(&pool->vertices, vertices, &first_vertex)) {
+		hogl_log_error("Geometry pool has no free range of %ld vertices", vertices);
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+
+	if (indices != 0 && !__free_list_take(&pool->indices, indices, &first_index)) {
+		hogl_log_error("Geometry pool has no free range of %ld indices", indices);
+		__free_list_give(&pool->vertices, first_vertex, vertices);
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+
+	range->first_vertex = first_vertex;
+	range->vertex_count = vertices;
+	range->first_index = first_index;
+	range->index_count = indices;
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_geometry_data(hogl_geometry_pool* pool, const hogl_geometry_range* range, const void* vertices, const void* indices) {
+	hogl_error err = HOGL_ERROR_NONE;
+
+	if (vertices != NULL && range->vertex_count != 0) {
+		err = hogl_vao_buffer_data(pool->vao, 0, range->first_vertex * pool->vertex_size, (void*)vertices, range->vertex_count * pool->vertex_size);
+		if (err != HOGL_ERROR_NONE) {
+			return err;
+		}
+	}
+
+	if (indices != NULL && range->index_count != 0) {
+		err = hogl_vao_buffer_data(pool->vao, 1, range->first_index * pool->index_size, (void*)indices, range->index_count * pool->index_size);
+	}
+
+	return err;
+}
+
+hogl_error hogl_geometry_release(hogl_geometry_pool* pool, const hogl_geometry_range* range) {
+	if (range->first_vertex > pool->vertex_capacity || range->vertex_count > pool->vertex_capacity - range->first_vertex ||
+		range->first_index > pool->index_capacity || range->index_count > pool->index_capacity - range->first_index) {
+		hogl_log_error("Trying to release a range that is outside of the geometry pool");
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+
+	// A range released twice would be merged into the free list again
+	if (__free_list_overlaps(&pool->vertices, range->first_vertex, range->vertex_count) ||
+		__free_list_overlaps(&pool->indices, range->first_index, range->index_count)) {
+		hogl_log_error("Trying to release a geometry range that is already free");
+		return HOGL_ERROR_BAD_ARGUMENT;
+	}
+
+	// Make sure the indices can be given back before the vertices are
+	if (__free_list_reserve(&pool->vertices, 1) != HOGL_ERROR_NONE ||
+		__free_list_reserve(&pool->indices, 1) != HOGL_ERROR_NONE) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	__free_list_give(&pool->vertices, range->first_vertex, range->vertex_count);
+	__free_list_give(&pool->indices, range->first_index, range->index_count);
+	return HOGL_ERROR_NONE;
+}
+
+hogl_vao* hogl_geometry_vao(hogl_geometry_pool* pool) {
+	return pool->vao;
+}
+
+hogl_draw_elements_indirect hogl_geometry_command(const hogl_geometry_range* range, unsigned int instances, unsigned int base_instance) {
+	hogl_draw_elements_indirect command;
+	command.count = (unsigned int)range->index_count;
+	command.instance_count = instances;
+	command.first_index = (unsigned int)range->first_index;
+	command.base_vertex = (int)range->first_vertex;
+	command.base_instance = base_instance;
+	return command;
+}
+
+void hogl_geometry_pool_free(hogl_geometry_pool* pool) {
+	if (pool->vao != NULL) {
+		hogl_vao_free(pool->vao);
+	}
+
+	hogl_free(pool->vertices.spans);
+	hogl_free(pool->indices.spans);
+	hogl_free(pool);
+}
+
 hogl_error hogl_shader_new(hogl_shader** shader, hogl_shader_desc desc) {
 	char* log = NULL;
 	unsigned int program = 0;
@@ -598,11 +1490,14 @@ hogl_error hogl_shader_sampler_location(hogl_shader* shader, const char* sampler
 }
 
 void hogl_shader_bind(hogl_shader* shader) {
-	glUseProgram(shader->id);
-	hogl_gl_check();
+	if (hogl_gl_state_program(shader->id)) {
+		glUseProgram(shader->id);
+		hogl_gl_check();
+	}
 }
 
 void hogl_shader_free(hogl_shader* shader) {
+	hogl_gl_state_forget_program(shader->id);
 	glDeleteProgram(shader->id);
 	hogl_gl_check();
 	hogl_free(shader);
@@ -613,8 +1508,10 @@ hogl_error hogl_texture_new(hogl_texture** texture, hogl_texture_desc desc) {
 	glGenTextures(1, &(*texture)->id);
 	hogl_gl_check();
 	(*texture)->target = GL_TEXTURE_2D;
-	glBindTexture(GL_TEXTURE_2D, (*texture)->id);
-	hogl_gl_check();
+	if (hogl_gl_state_texture(HOGL_GL_STATE_ACTIVE_UNIT, GL_TEXTURE_2D, (*texture)->id)) {
+		glBindTexture(GL_TEXTURE_2D, (*texture)->id);
+		hogl_gl_check();
+	}
 	(*texture)->cside = GL_TEXTURE_2D;
 	return __parse_texture_from_desc(*texture, &desc);
 }
@@ -624,15 +1521,24 @@ hogl_error hogl_cm_new(hogl_texture** cm, hogl_texture_desc desc) {
 	glGenTextures(1, &(*cm)->id);
 	hogl_gl_check();
 	(*cm)->target = GL_TEXTURE_CUBE_MAP;
-	glBindTexture(GL_TEXTURE_CUBE_MAP, (*cm)->id);
-	hogl_gl_check();
+	if (hogl_gl_state_texture(HOGL_GL_STATE_ACTIVE_UNIT, GL_TEXTURE_CUBE_MAP, (*cm)->id)) {
+		glBindTexture(GL_TEXTURE_CUBE_MAP, (*cm)->id);
+		hogl_gl_check();
+	}
 	(*cm)->cside = GL_TEXTURE_CUBE_MAP_POSITIVE_X;
 	return __parse_texture_from_desc(*cm, &desc);
 }
 
 void hogl_texture_bind(hogl_texture* texture, int slot) {
-	glActiveTexture(GL_TEXTURE0 + slot);
-	hogl_gl_check();
+	if (!hogl_gl_state_texture(slot, texture->target, texture->id)) {
+		return;
+	}
+
+	if (hogl_gl_state_active_texture(slot)) {
+		glActiveTexture(GL_TEXTURE0 + slot);
+		hogl_gl_check();
+	}
+
 	glBindTexture(texture->target, texture->id);
 	hogl_gl_check();
 }
@@ -664,8 +1570,11 @@ hogl_error hogl_cm_active_side(hogl_texture* cm, hogl_cm_side side) {
 }
 
 void hogl_set_texture_data(hogl_texture* texture, hogl_texture_data* data) {
-	glBindTexture(texture->target, texture->id);
-	hogl_gl_check();
+	if (hogl_gl_state_texture(HOGL_GL_STATE_ACTIVE_UNIT, texture->target, texture->id)) {
+		glBindTexture(texture->target, texture->id);
+		hogl_gl_check();
+	}
+
 	glTexImage2D(
 		texture->cside,
 		0,
@@ -680,13 +1589,17 @@ void hogl_set_texture_data(hogl_texture* texture, hogl_texture_data* data) {
 }
 
 void hogl_texture_gen_mipmap(hogl_texture* texture) {
-	glBindTexture(texture->target, texture->id);
-	hogl_gl_check();
+	if (hogl_gl_state_texture(HOGL_GL_STATE_ACTIVE_UNIT, texture->target, texture->id)) {
+		glBindTexture(texture->target, texture->id);
+		hogl_gl_check();
+	}
+
 	glGenerateMipmap(texture->target);
 	hogl_gl_check();
 }
 
 void hogl_texture_free(hogl_texture* texture) {
+	hogl_gl_state_forget_texture(texture->id);
 	glDeleteTextures(1, &texture->id);
 	hogl_gl_check();
 	hogl_free(texture);
@@ -696,8 +1609,10 @@ hogl_error hogl_framebuffer_new(hogl_framebuffer** framebuffer, hogl_framebuffer
 	(*framebuffer) = (hogl_framebuffer*)hogl_malloc(sizeof(hogl_framebuffer));
 	glGenFramebuffers(1, &(*framebuffer)->id);
 	hogl_gl_check();
-	glBindFramebuffer(GL_FRAMEBUFFER, (*framebuffer)->id);
-	hogl_gl_check();
+	if (hogl_gl_state_framebuffer((*framebuffer)->id)) {
+		glBindFramebuffer(GL_FRAMEBUFFER, (*framebuffer)->id);
+		hogl_gl_check();
+	}
 
 #ifndef HOGL_DISABLE_GL_WARNING
 	if (desc.ca_size > MIN_FBO_COLOR_ATTACHMENT) {
@@ -734,13 +1649,17 @@ hogl_error hogl_framebuffer_new(hogl_framebuffer** framebuffer, hogl_framebuffer
 }
 
 void hogl_framebuffer_bind(hogl_framebuffer* framebuffer) {
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->id);
-	hogl_gl_check();
+	if (hogl_gl_state_framebuffer(framebuffer->id)) {
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->id);
+		hogl_gl_check();
+	}
 }
 
 hogl_error hogl_framebuffer_ca(hogl_framebuffer* framebuffer, hogl_texture* texture, unsigned int slot, unsigned int mip) {
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->id);
-	hogl_gl_check();
+	if (hogl_gl_state_framebuffer(framebuffer->id)) {
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->id);
+		hogl_gl_check();
+	}
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + slot, texture->cside, texture->id, mip);
 	hogl_gl_check();
 
@@ -756,14 +1675,17 @@ hogl_error hogl_framebuffer_ca(hogl_framebuffer* framebuffer, hogl_texture* text
 }
 
 void hogl_framebuffer_free(hogl_framebuffer* framebuffer) {
+	hogl_gl_state_forget_framebuffer(framebuffer->id);
 	glDeleteFramebuffers(1, &framebuffer->id);
 	hogl_gl_check();
 	hogl_free(framebuffer);
 }
 
 void hogl_reset_framebuffer(void) {
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-	hogl_gl_check();
+	if (hogl_gl_state_framebuffer(0)) {
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		hogl_gl_check();
+	}
 }
 
 hogl_error hogl_renderbuffer_new(hogl_renderbuffer** renderbuffer, hogl_rbuffer_format format, unsigned int width, unsigned int height) {
@@ -33,6 +33,30 @@ typedef struct _hogl_shader hogl_shader;
 */
 typedef struct _hogl_ubo hogl_ubo;
 
+/**
+ * @brief Stream buffer is a persistently mapped buffer split into regions, one region is written by the CPU while
+ * the GPU reads the previous ones, each region is guarded by a fence so it is only reused once the GPU is done with it
+*/
+typedef struct _hogl_stream_buffer hogl_stream_buffer;
+
+/**
+ * @brief Uniform buffer ring is a stream buffer of uniform data, per draw uniform blocks are sub-allocated from the
+ * current frame and bound by offset so updating them needs no map or unmap
+*/
+typedef struct _hogl_ubo_ring hogl_ubo_ring;
+
+/**
+ * @brief Indirect buffer holds draw commands that are read by the GPU, filled on the CPU or by a compute shader and
+ * drawn with a single hogl_render_mei call
+*/
+typedef struct _hogl_indirect_buffer hogl_indirect_buffer;
+
+/**
+ * @brief Geometry pool is a single vao with one large vertex buffer and one large index buffer that many meshes of the
+ * same vertex format are sub-allocated from, so all of them are drawn without switching vaos
+*/
+typedef struct _hogl_geometry_pool hogl_geometry_pool;
+
 /**
  * @brief Framebuffer can be used as a target where objects will be rendered into
 */
@@ -99,6 +123,12 @@ typedef struct _hogl_vbo_desc {
 	hogl_ap_desc* ap_desc;
 	size_t desc_size;
 
+	/**
+	 * @brief Type of the indices, only used for element buffers, HOGL_IT_UINT16 halves the index memory of meshes with
+	 * at most 65536 vertices, see hogl_narrow_indices
+	*/
+	hogl_index_type index_type;
+
 	/**
 	 * @brief Size to allocate for a buffer, this can be changed later
 	*/
@@ -140,6 +170,95 @@ typedef struct _hogl_ubo_desc {
 	size_t offset;
 } hogl_ubo_desc;
 
+/**
+ * @brief Part of a ubo ring allocated for a single uniform block
+*/
+typedef struct _hogl_ubo_slice {
+	/**
+	 * @brief Offset of the slice inside the ring buffer
+	*/
+	size_t offset;
+
+	/**
+	 * @brief Size of the slice
+	*/
+	size_t size;
+} hogl_ubo_slice;
+
+/**
+ * @brief A single indexed draw inside an indirect buffer, the layout matches DrawElementsIndirectCommand
+*/
+typedef struct _hogl_draw_elements_indirect {
+	/**
+	 * @brief Number of indices to draw
+	*/
+	unsigned int count;
+
+	/**
+	 * @brief Number of instances, 1 for a regular draw
+	*/
+	unsigned int instance_count;
+
+	/**
+	 * @brief First index inside the element buffer
+	*/
+	unsigned int first_index;
+
+	/**
+	 * @brief Value added to every index before fetching vertices
+	*/
+	int base_vertex;
+
+	/**
+	 * @brief First instance, offsets instanced attributes
+	*/
+	unsigned int base_instance;
+} hogl_draw_elements_indirect;
+
+/**
+ * @brief Geometry pool description, containing the vertex format and the size of the pool
+*/
+typedef struct _hogl_geometry_pool_desc {
+	/**
+	 * @brief Attribute pointers of the interleaved vertex format, offsets are relative to a single vertex
+	*/
+	hogl_ap_desc* ap_desc;
+	size_t desc_size;
+
+	/**
+	 * @brief Size of a single vertex in bytes
+	*/
+	size_t vertex_size;
+
+	/**
+	 * @brief Number of vertices and indices the pool can hold
+	*/
+	size_t vertices;
+	size_t indices;
+
+	/**
+	 * @brief Type of the indices, HOGL_IT_UINT16 limits every range to 65536 vertices
+	*/
+	hogl_index_type index_type;
+} hogl_geometry_pool_desc;
+
+/**
+ * @brief Part of a geometry pool allocated for a single mesh
+*/
+typedef struct _hogl_geometry_range {
+	/**
+	 * @brief First vertex of the mesh, used as the base vertex when drawing
+	*/
+	size_t first_vertex;
+	size_t vertex_count;
+
+	/**
+	 * @brief First index of the mesh, indices are relative to first_vertex
+	*/
+	size_t first_index;
+	size_t index_count;
+} hogl_geometry_range;
+
 /**
  * @brief Texture description
 */
@@ -230,8 +349,12 @@ typedef struct _hogl_texture_data {
 /**
  * @brief Create a new vao with the specified description and store inside the pointer
  * @param vao Where to store the new vao
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the vao could not be allocated
+ * 		HOGL_ERROR_OPENGL_GENERIC	if hogl_gl_check failed at any point
 */
-HOGL_API void hogl_vao_new(hogl_vao** vao);
+HOGL_API hogl_error hogl_vao_new(hogl_vao** vao);
 
 /**
  * @brief Binds the specified vao to the OpenGL state machine
@@ -268,7 +391,9 @@ HOGL_API hogl_error hogl_vao_buffer_resize(hogl_vao* vao, int vbo, size_t size,
 
 /**
  * @brief Sets the data of a vertex buffer that is stored inside a vertex array, before using this function make sure to
- * allocate buffers inside a vao first
+ * allocate buffers inside a vao first. Updates up to the subdata threshold of the buffer usage are copied by the driver,
+ * larger ones only map the written range. Writing a whole STREAM buffer orphans it, partial writes to a STREAM buffer past
+ * everything written since it was last orphaned don't wait for the GPU, other partial writes do
  * @param vao Vertex array where the vertex buffer is being set
  * @param vbo Internal index of the vertex buffer
  * @param vbo_offset Offset int bytes from the start of the vbo internal buffer
@@ -288,6 +413,86 @@ HOGL_API hogl_error hogl_vao_buffer_data(hogl_vao* vao, int vbo, size_t vbo_offs
 */
 HOGL_API void hogl_vao_free(hogl_vao* vao);
 
+/**
+ * @brief Narrows 32 bit indices to 16 bit ones if every index fits, nothing is written otherwise
+ * @param indices Indices to narrow
+ * @param count Number of indices
+ * @param narrowed Where to write the 16 bit indices, can be the same memory as indices
+ * @return HOGL_IT_UINT16 if the indices were narrowed, HOGL_IT_UINT32 if an index does not fit
+*/
+HOGL_API hogl_index_type hogl_narrow_indices(const unsigned int* indices, size_t count, void* narrowed);
+
+/**
+ * @brief Create a new stream buffer, the buffer storage is immutable and stays mapped until it is freed so writing
+ * to it needs no OpenGL calls. Requires OpenGL 4.4
+ * @param sb Where to store the new stream buffer
+ * @param type Type of the buffer, only HOGL_VBOT_ARRAY_BUFFER is supported
+ * @param region_size Size of a single region, this is the most data that can be written between begin and end
+ * @param regions Number of regions, usually the number of frames that can be in flight plus one
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE					if operation was successful
+ *		HOGL_ERROR_BAD_ARGUMENT			if the type is not HOGL_VBOT_ARRAY_BUFFER
+ *		HOGL_ERROR_OUT_OF_RANGE			if the region size or count is 0
+ *		HOGL_ERROR_MEMORY				if the stream buffer could not be allocated
+ *		HOGL_ERROR_OPENGL_UNSUPPORTED	if the context has no buffer storage support
+ * 		HOGL_ERROR_OPENGL_GENERIC		if hogl_gl_check failed at any point or the buffer could not be mapped
+*/
+HOGL_API hogl_error hogl_stream_buffer_new(hogl_stream_buffer** sb, hogl_vbo_type type, size_t region_size, unsigned int regions);
+
+/**
+ * @brief Moves to the next region of the stream buffer and returns a pointer to it, if the GPU is still reading the
+ * region this waits until it is done. Call once per frame before writing
+ * @param sb Stream buffer
+ * @param data Where to store the pointer to the start of the region, can be NULL
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ * 		HOGL_ERROR_OPENGL_GENERIC	if hogl_gl_check failed at any point or waiting for the region failed
+*/
+HOGL_API hogl_error hogl_stream_buffer_begin(hogl_stream_buffer* sb, void** data);
+
+/**
+ * @brief Allocates size bytes from the current region without any OpenGL calls, not thread safe
+ * @param sb Stream buffer
+ * @param size Number of bytes to allocate
+ * @param alignment Alignment of the offset inside the buffer, 0 or 1 for none
+ * @param data Where to store the pointer to write the data to
+ * @param offset Where to store the offset of the data from the start of the buffer
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_OUT_OF_RANGE		if the data does not fit inside the remaining part of the region
+*/
+HOGL_API hogl_error hogl_stream_buffer_alloc(hogl_stream_buffer* sb, size_t size, size_t alignment, void** data, size_t* offset);
+
+/**
+ * @brief Points the attribute pointers of the vao at the current region of an array stream buffer, the offsets
+ * inside the descriptions are relative to the start of the region. Call after hogl_stream_buffer_begin
+ * @param sb Stream buffer
+ * @param vao VAO whose attributes to set
+ * @param descs Array of attribute pointer descriptions
+ * @param size Size of the descs array
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_BAD_ARGUMENT		if the stream buffer is not an array buffer
+ * 		HOGL_ERROR_OPENGL_GENERIC	if hogl_gl_check failed at any point
+*/
+HOGL_API hogl_error hogl_stream_buffer_attach(hogl_stream_buffer* sb, hogl_vao* vao, hogl_ap_desc* descs, size_t size);
+
+/**
+ * @brief Marks the end of the writes to the current region, the region is fenced and only reused once every
+ * command issued before this call has finished. Call after the last draw that reads the region
+ * @param sb Stream buffer
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ * 		HOGL_ERROR_OPENGL_GENERIC	if hogl_gl_check failed at any point
+*/
+HOGL_API hogl_error hogl_stream_buffer_end(hogl_stream_buffer* sb);
+
+/**
+ * @brief Frees all resources associated with the specified stream buffer
+ * @param sb Stream buffer to free
+*/
+HOGL_API void hogl_stream_buffer_free(hogl_stream_buffer* sb);
+
 /**
  * @brief Create a new buffer with the specified description and store inside the pointer
  * @param ubo Where to store the new ubo
@@ -300,7 +505,7 @@ HOGL_API void hogl_vao_free(hogl_vao* vao);
 HOGL_API hogl_error hogl_ubo_new(hogl_ubo** ubo, hogl_ubo_desc desc);
 
 /**
- * @brief Binds the specified ubo to the OpenGL state machine
+ * @brief Binds the specified ubo to the OpenGL state machine and its range back to the binding point it was created with
  * @param ubo UBO to bind
 */
 HOGL_API void hogl_ubo_bind(hogl_ubo* ubo);
@@ -322,6 +527,216 @@ HOGL_API hogl_error hogl_ubo_data(hogl_ubo* ubo, void* data, size_t size);
 */
 HOGL_API void hogl_ubo_free(hogl_ubo* ubo);
 
+/**
+ * @brief Create a new uniform buffer ring, the frame size is rounded up to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+ * Requires OpenGL 4.4
+ * @param ring Where to store the new ring
+ * @param frame_size Size of the uniform data that can be allocated in a single frame including alignment padding
+ * @param frames Number of frames, usually the number of frames that can be in flight plus one
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE					if operation was successful
+ *		HOGL_ERROR_OUT_OF_RANGE			if the frame size or count is 0
+ *		HOGL_ERROR_MEMORY				if the ring could not be allocated
+ *		HOGL_ERROR_OPENGL_UNSUPPORTED	if the context has no buffer storage support
+ * 		HOGL_ERROR_OPENGL_GENERIC		if hogl_gl_check failed at any point or the buffer could not be mapped
+*/
+HOGL_API hogl_error hogl_ubo_ring_new(hogl_ubo_ring** ring, size_t frame_size, unsigned int frames);
+
+/**
+ * @brief Starts a new frame of the ring, waits if the GPU is still reading the frame that is reused
+ * @param ring Ring to start the frame of
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ * 		HOGL_ERROR_OPENGL_GENERIC	if hogl_gl_check failed at any point or waiting for the frame failed
+*/
+HOGL_API hogl_error hogl_ubo_ring_begin(hogl_ubo_ring* ring);
+
+/**
+ * @brief Allocates an aligned slice from the current frame without any OpenGL calls, not thread safe
+ * @param ring Ring to allocate from
+ * @param size Size of the uniform block
+ * @param data Where to store the pointer to write the uniform block to
+ * @param slice Where to store the slice, pass it to hogl_ubo_ring_bind before the draw that uses it
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_OUT_OF_RANGE		if the frame has no space left for the slice
+*/
+HOGL_API hogl_error hogl_ubo_ring_alloc(hogl_ubo_ring* ring, size_t size, void** data, hogl_ubo_slice* slice);
+
+/**
+ * @brief Binds a slice of the ring to the specified binding point
+ * @param ring Ring the slice was allocated from
+ * @param slice Slice to bind
+ * @param bp Binding point
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ * 		HOGL_ERROR_OPENGL_GENERIC	if hogl_gl_check failed at any point
+*/
+HOGL_API hogl_error hogl_ubo_ring_bind(hogl_ubo_ring* ring, hogl_ubo_slice slice, unsigned int bp);
+
+/**
+ * @brief Copies the uniform block into a new slice and binds it to the specified binding point
+ * @param ring Ring to allocate from
+ * @param bp Binding point
+ * @param data Uniform block data
+ * @param size Size of the uniform block
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_OUT_OF_RANGE		if the frame has no space left for the slice
+ * 		HOGL_ERROR_OPENGL_GENERIC	if hogl_gl_check failed at any point
+*/
+HOGL_API hogl_error hogl_ubo_ring_push(hogl_ubo_ring* ring, unsigned int bp, void* data, size_t size);
+
+/**
+ * @brief Ends the current frame of the ring, call after the last draw that uses its slices
+ * @param ring Ring to end the frame of
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ * 		HOGL_ERROR_OPENGL_GENERIC	if hogl_gl_check failed at any point
+*/
+HOGL_API hogl_error hogl_ubo_ring_end(hogl_ubo_ring* ring);
+
+/**
+ * @brief Frees all resources associated with the specified ring
+ * @param ring Ring to free
+*/
+HOGL_API void hogl_ubo_ring_free(hogl_ubo_ring* ring);
+
+/**
+ * @brief Create a new indirect buffer. Requires OpenGL 4.3
+ * @param ib Where to store the new indirect buffer
+ * @param capacity Number of hogl_draw_elements_indirect commands the buffer can hold
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the indirect buffer could not be allocated
+ *		HOGL_ERROR_OUT_OF_RANGE		if the capacity is 0
+ *		HOGL_ERROR_OPENGL_UNSUPPORTED	if the context is older than OpenGL 4.3
+ * 		HOGL_ERROR_OPENGL_GENERIC	if hogl_gl_check failed at any point
+*/
+HOGL_API hogl_error hogl_indirect_new(hogl_indirect_buffer** ib, size_t capacity);
+
+/**
+ * @brief Binds the indirect buffer as the source of indirect draws
+ * @param ib Indirect buffer to bind
+*/
+HOGL_API void hogl_indirect_bind(hogl_indirect_buffer* ib);
+
+/**
+ * @brief Binds the indirect buffer to a shader storage binding point so a compute shader can write the commands.
+ * Call hogl_indirect_barrier after the dispatch and before drawing from the buffer
+ * @param ib Indirect buffer to bind
+ * @param bp Shader storage binding point
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ * 		HOGL_ERROR_OPENGL_GENERIC	if hogl_gl_check failed at any point
+*/
+HOGL_API hogl_error hogl_indirect_bind_storage(hogl_indirect_buffer* ib, unsigned int bp);
+
+/**
+ * @brief Makes commands written by shaders visible to the indirect draws that follow
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ * 		HOGL_ERROR_OPENGL_GENERIC	if hogl_gl_check failed at any point
+*/
+HOGL_API hogl_error hogl_indirect_barrier(void);
+
+/**
+ * @brief Writes draw commands into the indirect buffer
+ * @param ib Indirect buffer to write to
+ * @param first Index of the first command to write
+ * @param commands Commands to write
+ * @param count Number of commands
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_OUT_OF_RANGE		if the commands don't fit inside the buffer
+ * 		HOGL_ERROR_OPENGL_GENERIC	if hogl_gl_check failed at any point
+*/
+HOGL_API hogl_error hogl_indirect_data(hogl_indirect_buffer* ib, size_t first, const hogl_draw_elements_indirect* commands, size_t count);
+
+/**
+ * @brief Returns the number of commands the indirect buffer can hold
+ * @param ib Indirect buffer
+ * @return Capacity in commands
+*/
+HOGL_API size_t hogl_indirect_capacity(hogl_indirect_buffer* ib);
+
+/**
+ * @brief Frees all resources associated with the specified indirect buffer
+ * @param ib Indirect buffer to free
+*/
+HOGL_API void hogl_indirect_free(hogl_indirect_buffer* ib);
+
+/**
+ * @brief Create a new geometry pool with the specified description
+ * @param pool Where to store the new geometry pool
+ * @param desc Description of the pool
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_OUT_OF_RANGE		if the vertex size, vertex count or index count is 0
+ *		HOGL_ERROR_MEMORY			if the pool or its free lists could not be allocated
+ * 		HOGL_ERROR_OPENGL_GENERIC	if hogl_gl_check failed at any point
+*/
+HOGL_API hogl_error hogl_geometry_pool_new(hogl_geometry_pool** pool, hogl_geometry_pool_desc desc);
+
+/**
+ * @brief Allocates space for a mesh, the first free range that fits is used
+ * @param pool Geometry pool to allocate from
+ * @param vertices Number of vertices of the mesh
+ * @param indices Number of indices of the mesh
+ * @param range Where to store the allocated range
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_OUT_OF_RANGE		if there is no free range large enough
+ *		HOGL_ERROR_MEMORY			if the free lists could not be expanded
+*/
+HOGL_API hogl_error hogl_geometry_alloc(hogl_geometry_pool* pool, size_t vertices, size_t indices, hogl_geometry_range* range);
+
+/**
+ * @brief Writes the mesh data into its range
+ * @param pool Geometry pool of the range
+ * @param range Range returned by hogl_geometry_alloc
+ * @param vertices Vertex data, range.vertex_count vertices
+ * @param indices Index data relative to the first vertex of the mesh, range.index_count indices of the pool index type
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ * 		HOGL_ERROR_OPENGL_GENERIC	if hogl_gl_check failed at any point
+*/
+HOGL_API hogl_error hogl_geometry_data(hogl_geometry_pool* pool, const hogl_geometry_range* range, const void* vertices, const void* indices);
+
+/**
+ * @brief Returns the range to the pool, draws must no longer use it
+ * @param pool Geometry pool of the range
+ * @param range Range returned by hogl_geometry_alloc
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_OUT_OF_RANGE		if the range is outside of the pool
+ *		HOGL_ERROR_BAD_ARGUMENT		if a part of the range is already free
+ *		HOGL_ERROR_MEMORY			if the free lists could not be expanded, nothing is released
+*/
+HOGL_API hogl_error hogl_geometry_release(hogl_geometry_pool* pool, const hogl_geometry_range* range);
+
+/**
+ * @brief Returns the vao of the pool, bind it once and draw any range with hogl_render_ebv or an indirect buffer
+ * @param pool Geometry pool
+ * @return Vao of the pool
+*/
+HOGL_API hogl_vao* hogl_geometry_vao(hogl_geometry_pool* pool);
+
+/**
+ * @brief Returns the indirect command that draws the range
+ * @param range Range to draw
+ * @param instances Number of instances, 1 for a regular draw
+ * @param base_instance First instance
+ * @return Indirect command
+*/
+HOGL_API hogl_draw_elements_indirect hogl_geometry_command(const hogl_geometry_range* range, unsigned int instances, unsigned int base_instance);
+
+/**
+ * @brief Frees all resources associated with the specified geometry pool
+ * @param pool Geometry pool to free
+*/
+HOGL_API void hogl_geometry_pool_free(hogl_geometry_pool* pool);
+
 /**
  * @brief Create a new shader with the specified description and store inside the pointer
  * @param shader Where to store the new object
@@ -0,0 +1,374 @@
+#include "hogl_gl_state.h"
+
+#include <gl/glad.h>
+
+#include "hogl_core/graphics/hogl_render.h"
+#include "hogl_core/shared/hogl_memory.h"
+
+// Value of anything that is not known, every check against it fails
+#define STATE_UNKNOWN 0xFFFFFFFF
+
+// Texture units that are tracked, binds to higher units are always issued
+#define STATE_TEXTURE_UNITS 32
+
+// Tracked texture targets
+#define STATE_TEXTURE_2D 0
+#define STATE_TEXTURE_CUBE_MAP 1
+#define STATE_TEXTURE_TARGETS 2
+
+// Tracked buffer targets
+#define STATE_BUFFER_ARRAY 0
+#define STATE_BUFFER_ELEMENT 1
+#define STATE_BUFFER_UNIFORM 2
+#define STATE_BUFFER_COPY_WRITE 3
+#define STATE_BUFFER_DRAW_INDIRECT 4
+#define STATE_BUFFER_TARGETS 5
+
+// Uniform buffer binding points that are tracked, the minimum every OpenGL 4.3 context has
+#define STATE_UNIFORM_BINDINGS 36
+
+typedef struct _hogl_uniform_binding {
+	unsigned int id;
+	size_t offset;
+	size_t size;
+} hogl_uniform_binding;
+
+typedef struct _hogl_gl_state {
+	unsigned int program;
+	unsigned int vao;
+	unsigned int active_texture;
+	unsigned int textures[STATE_TEXTURE_UNITS][STATE_TEXTURE_TARGETS];
+	unsigned int buffers[STATE_BUFFER_TARGETS];
+	hogl_uniform_binding uniform_bindings[STATE_UNIFORM_BINDINGS];
+	unsigned int framebuffer;
+	unsigned int viewport[2];
+	unsigned int depth;
+
+	// Index type of the last vao bound through hogl, kept when the state is invalidated
+	unsigned int index_type;
+
+	hogl_gl_state_stats stats;
+} hogl_gl_state;
+
+// hogl renders from a single thread so there is one current state
+static hogl_gl_state* current = NULL;
+
+int __texture_slot(unsigned int target) {
+	switch (target) {
+	case GL_TEXTURE_2D:
+		return STATE_TEXTURE_2D;
+	case GL_TEXTURE_CUBE_MAP:
+		return STATE_TEXTURE_CUBE_MAP;
+	default:
+		return -1;
+	}
+}
+
+int __buffer_slot(unsigned int target) {
+	switch (target) {
+	case GL_ARRAY_BUFFER:
+		return STATE_BUFFER_ARRAY;
+	case GL_ELEMENT_ARRAY_BUFFER:
+		return STATE_BUFFER_ELEMENT;
+	case GL_UNIFORM_BUFFER:
+		return STATE_BUFFER_UNIFORM;
+	case GL_COPY_WRITE_BUFFER:
+		return STATE_BUFFER_COPY_WRITE;
+	case GL_DRAW_INDIRECT_BUFFER:
+		return STATE_BUFFER_DRAW_INDIRECT;
+	default:
+		return -1;
+	}
+}
+
+void __invalidate(hogl_gl_state* state) {
+	state->program = STATE_UNKNOWN;
+	state->vao = STATE_UNKNOWN;
+	state->active_texture = STATE_UNKNOWN;
+	state->framebuffer = STATE_UNKNOWN;
+	state->viewport[0] = STATE_UNKNOWN;
+	state->viewport[1] = STATE_UNKNOWN;
+	state->depth = STATE_UNKNOWN;
+
+	for (int i = 0; i < STATE_TEXTURE_UNITS; i++) {
+		for (int j = 0; j < STATE_TEXTURE_TARGETS; j++) {
+			state->textures[i][j] = STATE_UNKNOWN;
+		}
+	}
+
+	for (int i = 0; i < STATE_BUFFER_TARGETS; i++) {
+		state->buffers[i] = STATE_UNKNOWN;
+	}
+
+	for (int i = 0; i < STATE_UNIFORM_BINDINGS; i++) {
+		state->uniform_bindings[i].id = STATE_UNKNOWN;
+	}
+}
+
+// Updates the shadow value and the counters, returns true if the change has to be issued
+bool __change(unsigned int* value, unsigned int new_value, uint64_t* skips) {
+	if ((*value) == new_value) {
+		current->stats.skipped++;
+		(*skips)++;
+		return false;
+	}
+
+	(*value) = new_value;
+	current->stats.issued++;
+	return true;
+}
+
+hogl_gl_state* hogl_gl_state_new(void) {
+	hogl_gl_state* state = (hogl_gl_state*)hogl_malloc(sizeof(hogl_gl_state));
+	hogl_memset(&state->stats, 0, sizeof(hogl_gl_state_stats));
+	__invalidate(state);
+	state->index_type = GL_UNSIGNED_INT;
+
+	// A new context always starts on the first texture unit
+	state->active_texture = 0;
+	return state;
+}
+
+void hogl_gl_state_make_current(hogl_gl_state* state) {
+	current = state;
+}
+
+void hogl_gl_state_free(hogl_gl_state* state) {
+	if (current == state) {
+		current = NULL;
+	}
+
+	hogl_free(state);
+}
+
+bool hogl_gl_state_program(unsigned int id) {
+	if (current == NULL) {
+		return true;
+	}
+
+	return __change(&current->program, id, &current->stats.program_skips);
+}
+
+bool hogl_gl_state_vao(unsigned int id, unsigned int index_type) {
+	if (current == NULL) {
+		return true;
+	}
+
+	current->index_type = index_type;
+
+	if (!__change(&current->vao, id, &current->stats.vao_skips)) {
+		return false;
+	}
+
+	// The element buffer binding is part of the vertex array
+	current->buffers[STATE_BUFFER_ELEMENT] = STATE_UNKNOWN;
+	return true;
+}
+
+unsigned int hogl_gl_state_index_type(void) {
+	if (current == NULL) {
+		return GL_UNSIGNED_INT;
+	}
+
+	return current->index_type;
+}
+
+bool hogl_gl_state_active_texture(int unit) {
+	if (current == NULL) {
+		return true;
+	}
+
+	return __change(&current->active_texture, (unsigned int)unit, &current->stats.texture_skips);
+}
+
+bool hogl_gl_state_texture(int unit, unsigned int target, unsigned int id) {
+	int slot = __texture_slot(target);
+
+	if (current == NULL) {
+		return true;
+	}
+
+	if (unit == HOGL_GL_STATE_ACTIVE_UNIT) {
+		unit = (int)current->active_texture;
+	}
+
+	// Binding to an unknown active unit could change any of them
+	if (unit < 0) {
+		for (int i = 0; i < STATE_TEXTURE_UNITS; i++) {
+			current->textures[i][STATE_TEXTURE_2D] = STATE_UNKNOWN;
+			current->textures[i][STATE_TEXTURE_CUBE_MAP] = STATE_UNKNOWN;
+		}
+
+		current->stats.issued++;
+		return true;
+	}
+
+	// Untracked units and targets are always bound
+	if (unit >= STATE_TEXTURE_UNITS || slot < 0) {
+		if (unit < STATE_TEXTURE_UNITS) {
+			current->textures[unit][STATE_TEXTURE_2D] = STATE_UNKNOWN;
+			current->textures[unit][STATE_TEXTURE_CUBE_MAP] = STATE_UNKNOWN;
+		}
+
+		current->stats.issued++;
+		return true;
+	}
+
+	return __change(&current->textures[unit][slot], id, &current->stats.texture_skips);
+}
+
+bool hogl_gl_state_buffer(unsigned int target, unsigned int id) {
+	int slot = __buffer_slot(target);
+
+	if (current == NULL) {
+		return true;
+	}
+
+	if (slot < 0) {
+		current->stats.issued++;
+		return true;
+	}
+
+	return __change(&current->buffers[slot], id, &current->stats.buffer_skips);
+}
+
+void hogl_gl_state_buffer_changed(unsigned int target, unsigned int id) {
+	int slot = __buffer_slot(target);
+
+	if (current != NULL && slot >= 0) {
+		current->buffers[slot] = id;
+	}
+}
+
+bool hogl_gl_state_uniform_range(unsigned int bp, unsigned int id, size_t offset, size_t size) {
+	hogl_uniform_binding* binding = NULL;
+
+	if (current == NULL) {
+		return true;
+	}
+
+	// Untracked binding points are always bound
+	if (bp >= STATE_UNIFORM_BINDINGS) {
+		current->stats.issued++;
+		return true;
+	}
+
+	binding = &current->uniform_bindings[bp];
+
+	if (binding->id == id && binding->offset == offset && binding->size == size) {
+		current->stats.skipped++;
+		current->stats.uniform_skips++;
+		return false;
+	}
+
+	binding->id = id;
+	binding->offset = offset;
+	binding->size = size;
+	current->stats.issued++;
+	return true;
+}
+
+bool hogl_gl_state_framebuffer(unsigned int id) {
+	if (current == NULL) {
+		return true;
+	}
+
+	return __change(&current->framebuffer, id, &current->stats.framebuffer_skips);
+}
+
+bool hogl_gl_state_viewport(unsigned int width, unsigned int height) {
+	if (current == NULL) {
+		return true;
+	}
+
+	if (current->viewport[0] == width && current->viewport[1] == height) {
+		current->stats.skipped++;
+		current->stats.viewport_skips++;
+		return false;
+	}
+
+	current->viewport[0] = width;
+	current->viewport[1] = height;
+	current->stats.issued++;
+	return true;
+}
+
+bool hogl_gl_state_depth(hogl_render_depth depth) {
+	if (current == NULL) {
+		return true;
+	}
+
+	return __change(&current->depth, (unsigned int)depth, &current->stats.depth_skips);
+}
+
+void hogl_gl_state_forget_program(unsigned int id) {
+	if (current != NULL && current->program == id) {
+		current->program = 0;
+	}
+}
+
+void hogl_gl_state_forget_vao(unsigned int id) {
+	if (current != NULL && current->vao == id) {
+		current->vao = 0;
+		current->buffers[STATE_BUFFER_ELEMENT] = 0;
+	}
+}
+
+void hogl_gl_state_forget_texture(unsigned int id) {
+	if (current == NULL) {
+		return;
+	}
+
+	for (int i = 0; i < STATE_TEXTURE_UNITS; i++) {
+		for (int j = 0; j < STATE_TEXTURE_TARGETS; j++) {
+			if (current->textures[i][j] == id) {
+				current->textures[i][j] = 0;
+			}
+		}
+	}
+}
+
+void hogl_gl_state_forget_buffer(unsigned int id) {
+	if (current == NULL) {
+		return;
+	}
+
+	for (int i = 0; i < STATE_BUFFER_TARGETS; i++) {
+		if (current->buffers[i] == id) {
+			current->buffers[i] = 0;
+		}
+	}
+
+	for (int i = 0; i < STATE_UNIFORM_BINDINGS; i++) {
+		if (current->uniform_bindings[i].id == id) {
+			current->uniform_bindings[i].id = 0;
+		}
+	}
+}
+
+void hogl_gl_state_forget_framebuffer(unsigned int id) {
+	if (current != NULL && current->framebuffer == id) {
+		current->framebuffer = 0;
+	}
+}
+
+void hogl_get_gl_state_stats(hogl_gl_state_stats* stats) {
+	if (current == NULL) {
+		hogl_memset(stats, 0, sizeof(hogl_gl_state_stats));
+		return;
+	}
+
+	(*stats) = current->stats;
+}
+
+void hogl_reset_gl_state_stats(void) {
+	if (current != NULL) {
+		hogl_memset(&current->stats, 0, sizeof(hogl_gl_state_stats));
+	}
+}
+
+void hogl_invalidate_gl_state(void) {
+	if (current != NULL) {
+		__invalidate(current);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+/**
+* @brief hogl gl state file contains the shadow copy of the OpenGL state used to filter redundant state changes,
+* this is internal to the graphics suite and every bind inside hogl goes through it
+*/
+
+#ifndef _HOGL_GL_STATE_
+#define _HOGL_GL_STATE_
+
+#include <stdbool.h>
+#include "hogl_core/shared/hogl_def.h"
+
+/**
+ * @brief Shadow state of a single OpenGL context, owned by its window
+*/
+typedef struct _hogl_gl_state hogl_gl_state;
+
+/**
+ * @brief Pass as the unit to hogl_gl_state_texture to use the active texture unit
+*/
+#define HOGL_GL_STATE_ACTIVE_UNIT -1
+
+/**
+ * @brief Creates a new shadow state where every value is unknown
+ * @return Shadow state, free using hogl_gl_state_free
+*/
+hogl_gl_state* hogl_gl_state_new(void);
+
+/**
+ * @brief Makes the shadow state the one every check is made against, called when its context is made current
+ * @param state Shadow state or NULL to disable filtering
+*/
+void hogl_gl_state_make_current(hogl_gl_state* state);
+
+/**
+ * @brief Frees the shadow state, if it is current filtering is disabled
+ * @param state Shadow state to free
+*/
+void hogl_gl_state_free(hogl_gl_state* state);
+
+/**
+ * @brief Records the program as used
+ * @param id Program id
+ * @return True if the program is not in use and glUseProgram has to be called
+*/
+bool hogl_gl_state_program(unsigned int id);
+
+/**
+ * @brief Records the vertex array as bound, this also makes the element buffer binding unknown
+ * @param id Vertex array id
+ * @param index_type OpenGL type of the vertex array indices, used by the indexed draws
+ * @return True if the vertex array is not bound and glBindVertexArray has to be called
+*/
+bool hogl_gl_state_vao(unsigned int id, unsigned int index_type);
+
+/**
+ * @brief Returns the index type of the vertex array last bound through hogl
+ * @return GL_UNSIGNED_INT or GL_UNSIGNED_SHORT
+*/
+unsigned int hogl_gl_state_index_type(void);
+
+/**
+ * @brief Records the texture unit as active
+ * @param unit Texture unit starting from 0
+ * @return True if the unit is not active and glActiveTexture has to be called
+*/
+bool hogl_gl_state_active_texture(int unit);
+
+/**
+ * @brief Records the texture as bound to the unit
+ * @param unit Texture unit starting from 0 or HOGL_GL_STATE_ACTIVE_UNIT
+ * @param target Texture target, only GL_TEXTURE_2D and GL_TEXTURE_CUBE_MAP are tracked
+ * @param id Texture id
+ * @return True if the texture is not bound and glBindTexture has to be called
+*/
+bool hogl_gl_state_texture(int unit, unsigned int target, unsigned int id);
+
+/**
+ * @brief Records the buffer as bound to the target
+ * @param target Buffer target, other targets than array, element, uniform, copy write and draw indirect are not tracked
+ * @param id Buffer id
+ * @return True if the buffer is not bound and glBindBuffer has to be called
+*/
+bool hogl_gl_state_buffer(unsigned int target, unsigned int id);
+
+/**
+ * @brief Records a buffer binding that happened as a side effect of another call e.g. glBindBufferRange
+ * @param target Buffer target
+ * @param id Buffer id
+*/
+void hogl_gl_state_buffer_changed(unsigned int target, unsigned int id);
+
+/**
+ * @brief Records the buffer range as bound to the uniform buffer binding point
+ * @param bp Binding point, binding points past the tracked ones are always bound
+ * @param id Buffer id
+ * @param offset Offset of the range in bytes
+ * @param size Size of the range in bytes
+ * @return True if the range is not bound and glBindBufferRange has to be called
+*/
+bool hogl_gl_state_uniform_range(unsigned int bp, unsigned int id, size_t offset, size_t size);
+
+/**
+ * @brief Records the framebuffer as bound to GL_FRAMEBUFFER
+ * @param id Framebuffer id, 0 for the default one
+ * @return True if the framebuffer is not bound and glBindFramebuffer has to be called
+*/
+bool hogl_gl_state_framebuffer(unsigned int id);
+
+/**
+ * @brief Records the viewport size, the viewport always starts at 0, 0
+ * @param width Viewport width
+ * @param height Viewport height
+ * @return True if the viewport is different and glViewport has to be called
+*/
+bool hogl_gl_state_viewport(unsigned int width, unsigned int height);
+
+/**
+ * @brief Records the depth test state
+ * @param depth Depth test state
+ * @return True if the depth test is different and has to be set
+*/
+bool hogl_gl_state_depth(hogl_render_depth depth);
+
+/**
+ * @brief Forgets the deleted program everywhere it is bound, OpenGL unbinds deleted objects and reuses their ids
+ * @param id Program id
+*/
+void hogl_gl_state_forget_program(unsigned int id);
+
+/**
+ * @brief Forgets the deleted vertex array everywhere it is bound, OpenGL unbinds deleted objects and reuses their ids
+ * @param id Vertex array id
+*/
+void hogl_gl_state_forget_vao(unsigned int id);
+
+/**
+ * @brief Forgets the deleted texture everywhere it is bound, OpenGL unbinds deleted objects and reuses their ids
+ * @param id Texture id
+*/
+void hogl_gl_state_forget_texture(unsigned int id);
+
+/**
+ * @brief Forgets the deleted buffer everywhere it is bound, OpenGL unbinds deleted objects and reuses their ids
+ * @param id Buffer id
+*/
+void hogl_gl_state_forget_buffer(unsigned int id);
+
+/**
+ * @brief Forgets the deleted framebuffer everywhere it is bound, OpenGL unbinds deleted objects and reuses their ids
+ * @param id Framebuffer id
+*/
+void hogl_gl_state_forget_framebuffer(unsigned int id);
+
+#endif
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <gl/glad.h>
 #include <gl/glfw3.h>
 
+#include "hogl_core/graphics/hogl_gl_primitive.h"
+#include "hogl_core/graphics/hogl_gl_state.h"
 #include "hogl_core/shared/hogl_log.h"
 
 unsigned int __parse_mode(hogl_render_mode mode) {
@@ -16,6 +18,10 @@ unsigned int __parse_mode(hogl_render_mode mode) {
 	return 0;
 }
 
+size_t __index_size(unsigned int type) {
+	return type == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+}
+
 hogl_error hogl_render_clear(float r, float g, float b, float a) {
 	glClearColor(r, g, b, a);
 	hogl_gl_check();
@@ -25,8 +31,11 @@ hogl_error hogl_render_clear(float r, float g, float b, float a) {
 }
 
 hogl_error hogl_viewport(unsigned int width, unsigned int height) {
-	glViewport(0, 0, width, height);
-	hogl_gl_check();
+	if (hogl_gl_state_viewport(width, height)) {
+		glViewport(0, 0, width, height);
+		hogl_gl_check();
+	}
+
 	return HOGL_ERROR_NONE;
 }
 
@@ -55,6 +64,10 @@ void hogl_set_rstate(hogl_rstate rstate) {
 }
 
 hogl_error hogl_set_depth_test(hogl_render_depth depth) {
+	if (!hogl_gl_state_depth(depth)) {
+		return HOGL_ERROR_NONE;
+	}
+
 	if (depth == HOGL_RD_DISABLED)
 	{
 		glDisable(GL_DEPTH_TEST);
@@ -126,7 +139,7 @@ hogl_error hogl_render_e(hogl_render_mode mode, unsigned int vertices) {
 	}
 #endif
 
-	glDrawElements(__parse_mode(mode), vertices, GL_UNSIGNED_INT, 0);
+	glDrawElements(__parse_mode(mode), vertices, hogl_gl_state_index_type(), 0);
 	hogl_gl_check();
 	return HOGL_ERROR_NONE;
 }
@@ -152,7 +165,53 @@ hogl_error hogl_render_ei(hogl_render_mode mode, unsigned int vertices, unsigned
 	}
 #endif
 
-	glDrawElementsInstanced(__parse_mode(mode), vertices, GL_UNSIGNED_INT, 0, instances);
+	glDrawElementsInstanced(__parse_mode(mode), vertices, hogl_gl_state_index_type(), 0, instances);
 	hogl_gl_check();
 	return HOGL_ERROR_NONE;
 }
+
+
+hogl_error hogl_render_ebv(hogl_render_mode mode, unsigned int vertices, unsigned int first_index, int base_vertex) {
+#ifndef HOGL_DISABLE_GL_WARNING
+	if (__parse_mode(mode) == 0) {
+		hogl_log_error("Failed to parse a render mode: %ld", mode);
+		return HOGL_ERROR_UNKNOWN_MODE;
+	}
+#endif
+
+	unsigned int type = hogl_gl_state_index_type();
+	glDrawElementsBaseVertex(__parse_mode(mode), vertices, type, (const void*)(first_index * __index_size(type)), base_vertex);
+	hogl_gl_check();
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_render_ebvi(hogl_render_mode mode, unsigned int vertices, unsigned int first_index, int base_vertex, unsigned int instances) {
+#ifndef HOGL_DISABLE_GL_WARNING
+	if (__parse_mode(mode) == 0) {
+		hogl_log_error("Failed to parse a render mode: %ld", mode);
+		return HOGL_ERROR_UNKNOWN_MODE;
+	}
+#endif
+
+	unsigned int type = hogl_gl_state_index_type();
+	glDrawElementsInstancedBaseVertex(__parse_mode(mode), vertices, type, (const void*)(first_index * __index_size(type)), instances, base_vertex);
+	hogl_gl_check();
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_render_mei(hogl_render_mode mode, size_t first, size_t count) {
+#ifndef HOGL_DISABLE_GL_WARNING
+	if (__parse_mode(mode) == 0) {
+		hogl_log_error("Failed to parse a render mode: %ld", mode);
+		return HOGL_ERROR_UNKNOWN_MODE;
+	}
+#endif
+
+	if (count == 0) {
+		return HOGL_ERROR_NONE;
+	}
+
+	glMultiDrawElementsIndirect(__parse_mode(mode), hogl_gl_state_index_type(), (const void*)(first * sizeof(hogl_draw_elements_indirect)), (GLsizei)count, 0);
+	hogl_gl_check();
+	return HOGL_ERROR_NONE;
+}
\ No newline at end of file
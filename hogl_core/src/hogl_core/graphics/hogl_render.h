@@ -7,6 +7,8 @@
 #define _HOGL_RENDER_
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "hogl_core/shared/hogl_def.h"
 
 /**
@@ -17,6 +19,51 @@ typedef struct _hogl_rstate {
 	hogl_render_depth depth;
 } hogl_rstate;
 
+/**
+ * @brief Counters of the state changes made through hogl, every bind and render state change is checked against
+ * a shadow copy of the context state and skipped if nothing would change
+*/
+typedef struct _hogl_gl_state_stats {
+	/**
+	 * @brief State changes sent to OpenGL
+	*/
+	uint64_t issued;
+
+	/**
+	 * @brief Redundant state changes that were skipped
+	*/
+	uint64_t skipped;
+
+	/**
+	 * @brief Skipped changes by the kind of state
+	*/
+	uint64_t program_skips;
+	uint64_t vao_skips;
+	uint64_t texture_skips;
+	uint64_t buffer_skips;
+	uint64_t uniform_skips;
+	uint64_t framebuffer_skips;
+	uint64_t viewport_skips;
+	uint64_t depth_skips;
+} hogl_gl_state_stats;
+
+/**
+ * @brief Gets the state change counters of the current context
+ * @param stats Where to store the counters
+*/
+HOGL_API void hogl_get_gl_state_stats(hogl_gl_state_stats* stats);
+
+/**
+ * @brief Resets the state change counters of the current context to 0
+*/
+HOGL_API void hogl_reset_gl_state_stats(void);
+
+/**
+ * @brief Forgets the tracked state of the current context, call after changing state with OpenGL calls that don't
+ * go through hogl so the next binds are issued
+*/
+HOGL_API void hogl_invalidate_gl_state(void);
+
 /**
  * @brief Clears the color of the active window buffer with the specified color
  * @param r Red color channel value
@@ -81,7 +128,7 @@ HOGL_API hogl_error hogl_set_depth_test(hogl_render_depth depth);
 HOGL_API hogl_error hogl_render_a(hogl_render_mode mode, unsigned int vertices);
 
 /**
- * @brief Renders the currently bound vao using a index buffer
+ * @brief Renders the currently bound vao using a index buffer, indices are read with the index type of its element buffer
  * @param mode Mode to interpret data as
  * @param vertices Number of indices inside the ebo
  * @return Returns error codes:
@@ -110,4 +157,43 @@ HOGL_API hogl_error hogl_render_ai(hogl_render_mode mode, unsigned int vertices,
 */
 HOGL_API hogl_error hogl_render_ei(hogl_render_mode mode, unsigned int vertices, unsigned int instances);
 
+/**
+ * @brief Renders a part of the index buffer of the currently bound vao, used to draw meshes sharing one vao
+ * such as the ranges of a geometry pool
+ * @param mode Mode to interpret data as
+ * @param vertices Number of indices to draw
+ * @param first_index First index inside the ebo
+ * @param base_vertex Value added to every index before fetching vertices
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_UNKNOWN_MODE		if the specified render mode is invalid
+*/
+HOGL_API hogl_error hogl_render_ebv(hogl_render_mode mode, unsigned int vertices, unsigned int first_index, int base_vertex);
+
+/**
+ * @brief Instanced version of hogl_render_ebv
+ * @param mode Mode to interpret data as
+ * @param vertices Number of indices to draw
+ * @param first_index First index inside the ebo
+ * @param base_vertex Value added to every index before fetching vertices
+ * @param instances Number of instances
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_UNKNOWN_MODE		if the specified render mode is invalid
+*/
+HOGL_API hogl_error hogl_render_ebvi(hogl_render_mode mode, unsigned int vertices, unsigned int first_index, int base_vertex, unsigned int instances);
+
+/**
+ * @brief Renders the currently bound vao with the commands of the currently bound indirect buffer in a single call,
+ * requires OpenGL 4.3
+ * @param mode Mode to interpret data as
+ * @param first Index of the first command inside the indirect buffer
+ * @param count Number of commands to draw
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_UNKNOWN_MODE		if the specified render mode is invalid
+ * 		HOGL_ERROR_OPENGL_GENERIC	if hogl_gl_check failed at any point
+*/
+HOGL_API hogl_error hogl_render_mei(hogl_render_mode mode, size_t first, size_t count);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,293 @@
+#include "hogl_render_queue.h"
+
+#include "hogl_core/graphics/hogl_render.h"
+#include "hogl_core/shared/hogl_log.h"
+#include "hogl_core/shared/hogl_memory.h"
+
+#define RQ_DEFAULT_CAPACITY 256
+#define RQ_RADIX_BITS 8
+#define RQ_RADIX_BUCKETS (1 << RQ_RADIX_BITS)
+#define RQ_RADIX_PASSES (64 / RQ_RADIX_BITS)
+
+typedef struct _hogl_rq_entry {
+	uint64_t key;
+	uint32_t draw;
+} hogl_rq_entry;
+
+typedef struct _hogl_render_queue {
+	hogl_rq_draw* draws;
+	hogl_rq_entry* entries;
+	hogl_rq_entry* scratch;
+	size_t count;
+	size_t capacity;
+} hogl_render_queue;
+
+hogl_error __rq_reserve(hogl_render_queue* rq, size_t capacity) {
+	hogl_rq_draw* new_draws = NULL;
+	hogl_rq_entry* new_entries = NULL;
+	hogl_rq_entry* new_scratch = NULL;
+
+	if (capacity <= rq->capacity) {
+		return HOGL_ERROR_NONE;
+	}
+
+	new_draws = hogl_realloc(rq->draws, capacity * sizeof(hogl_rq_draw));
+	if (new_draws == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+	rq->draws = new_draws;
+
+	new_entries = hogl_realloc(rq->entries, capacity * sizeof(hogl_rq_entry));
+	if (new_entries == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+	rq->entries = new_entries;
+
+	new_scratch = hogl_realloc(rq->scratch, capacity * sizeof(hogl_rq_entry));
+	if (new_scratch == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+	rq->scratch = new_scratch;
+
+	rq->capacity = capacity;
+	return HOGL_ERROR_NONE;
+}
+
+// Least significant digit radix sort, stable so draws with equal keys keep their push order
+void __rq_sort(hogl_render_queue* rq) {
+	size_t histograms[RQ_RADIX_PASSES][RQ_RADIX_BUCKETS];
+	hogl_rq_entry* src = rq->entries;
+	hogl_rq_entry* dst = rq->scratch;
+	hogl_rq_entry* tmp = NULL;
+
+	hogl_memset(histograms, 0, sizeof(histograms));
+
+	for (size_t i = 0; i < rq->count; i++) {
+		uint64_t key = rq->entries[i].key;
+		for (int pass = 0; pass < RQ_RADIX_PASSES; pass++) {
+			histograms[pass][(key >> (pass * RQ_RADIX_BITS)) & (RQ_RADIX_BUCKETS - 1)]++;
+		}
+	}
+
+	for (int pass = 0; pass < RQ_RADIX_PASSES; pass++) {
+		size_t* histogram = histograms[pass];
+		int shift = pass * RQ_RADIX_BITS;
+		size_t offset = 0;
+
+		// Every key has the same digit, nothing would move
+		if (histogram[(src[0].key >> shift) & (RQ_RADIX_BUCKETS - 1)] == rq->count) {
+			continue;
+		}
+
+		for (int bucket = 0; bucket < RQ_RADIX_BUCKETS; bucket++) {
+			size_t bucket_count = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucket_count;
+		}
+
+		for (size_t i = 0; i < rq->count; i++) {
+			dst[histogram[(src[i].key >> shift) & (RQ_RADIX_BUCKETS - 1)]++] = src[i];
+		}
+
+		tmp = src;
+		src = dst;
+		dst = tmp;
+	}
+
+	// Keep the sorted entries in the entries array
+	if (src != rq->entries) {
+		rq->scratch = rq->entries;
+		rq->entries = src;
+	}
+}
+
+// Issues the sorted draws, or records them if cb is not NULL
+hogl_error __rq_emit(hogl_render_queue* rq, hogl_cmdbuf* cb) {
+	hogl_error err = HOGL_ERROR_NONE;
+	hogl_shader* shader = NULL;
+	hogl_vao* vao = NULL;
+	hogl_texture* textures[HOGL_RQ_MAX_TEXTURES] = { NULL };
+	hogl_ubo_ring* ring = NULL;
+	hogl_ubo_slice slice = { 0, 0 };
+	unsigned int bp = 0;
+
+	if (rq->count == 0) {
+		return HOGL_ERROR_NONE;
+	}
+
+	__rq_sort(rq);
+
+	for (size_t i = 0; i < rq->count && err == HOGL_ERROR_NONE; i++) {
+		hogl_rq_draw* draw = &rq->draws[rq->entries[i].draw];
+
+		if (draw->shader != shader) {
+			shader = draw->shader;
+			if (cb != NULL) {
+				err = hogl_cmdbuf_shader(cb, shader);
+			}
+			else {
+				hogl_shader_bind(shader);
+			}
+		}
+
+		if (err == HOGL_ERROR_NONE && draw->vao != vao) {
+			vao = draw->vao;
+			if (cb != NULL) {
+				err = hogl_cmdbuf_vao(cb, vao);
+			}
+			else {
+				hogl_vao_bind(vao);
+			}
+		}
+
+		for (unsigned int slot = 0; slot < draw->texture_count && err == HOGL_ERROR_NONE; slot++) {
+			if (draw->textures[slot] == textures[slot]) {
+				continue;
+			}
+
+			textures[slot] = draw->textures[slot];
+			if (cb != NULL) {
+				err = hogl_cmdbuf_texture(cb, textures[slot], slot);
+			}
+			else {
+				hogl_texture_bind(textures[slot], slot);
+			}
+		}
+
+		if (err == HOGL_ERROR_NONE && draw->ring != NULL &&
+			(draw->ring != ring || draw->bp != bp || draw->slice.offset != slice.offset || draw->slice.size != slice.size)) {
+			ring = draw->ring;
+			slice = draw->slice;
+			bp = draw->bp;
+			if (cb != NULL) {
+				err = hogl_cmdbuf_ubo_slice(cb, ring, slice, bp);
+			}
+			else {
+				err = hogl_ubo_ring_bind(ring, slice, bp);
+			}
+		}
+
+		if (err != HOGL_ERROR_NONE) {
+			break;
+		}
+
+		if (draw->indexed && (draw->first_index != 0 || draw->base_vertex != 0)) {
+			err = cb != NULL ?
+				hogl_cmdbuf_render_ebv(cb, draw->mode, draw->vertices, draw->first_index, draw->base_vertex, draw->instances) :
+				draw->instances != 0 ?
+					hogl_render_ebvi(draw->mode, draw->vertices, draw->first_index, draw->base_vertex, draw->instances) :
+					hogl_render_ebv(draw->mode, draw->vertices, draw->first_index, draw->base_vertex);
+		}
+		else if (draw->indexed) {
+			if (draw->instances != 0) {
+				err = cb != NULL ?
+					hogl_cmdbuf_render_ei(cb, draw->mode, draw->vertices, draw->instances) :
+					hogl_render_ei(draw->mode, draw->vertices, draw->instances);
+			}
+			else {
+				err = cb != NULL ?
+					hogl_cmdbuf_render_e(cb, draw->mode, draw->vertices) :
+					hogl_render_e(draw->mode, draw->vertices);
+			}
+		}
+		else {
+			if (draw->instances != 0) {
+				err = cb != NULL ?
+					hogl_cmdbuf_render_ai(cb, draw->mode, draw->vertices, draw->instances) :
+					hogl_render_ai(draw->mode, draw->vertices, draw->instances);
+			}
+			else {
+				err = cb != NULL ?
+					hogl_cmdbuf_render_a(cb, draw->mode, draw->vertices) :
+					hogl_render_a(draw->mode, draw->vertices);
+			}
+		}
+	}
+
+	return err;
+}
+
+hogl_error hogl_rq_new(hogl_render_queue** rq, size_t capacity) {
+	if (capacity == 0) {
+		capacity = RQ_DEFAULT_CAPACITY;
+	}
+
+	(*rq) = (hogl_render_queue*)hogl_malloc(sizeof(hogl_render_queue));
+	if ((*rq) == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	(*rq)->draws = NULL;
+	(*rq)->entries = NULL;
+	(*rq)->scratch = NULL;
+	(*rq)->count = 0;
+	(*rq)->capacity = 0;
+
+	if (__rq_reserve(*rq, capacity) != HOGL_ERROR_NONE) {
+		hogl_rq_free(*rq);
+		(*rq) = NULL;
+		return HOGL_ERROR_MEMORY;
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+uint64_t hogl_rq_key(unsigned int layer, unsigned int shader, unsigned int material, float depth) {
+	union {
+		float f;
+		uint32_t u;
+	} bits;
+	uint32_t depth_key = 0;
+
+	// Flip the float so its bits sort in the same order as the values
+	bits.f = depth;
+	depth_key = (bits.u & 0x80000000u) ? ~bits.u : (bits.u | 0x80000000u);
+
+	return ((uint64_t)(layer & 0xFF) << 56) |
+		((uint64_t)(shader & 0xFFFF) << 40) |
+		((uint64_t)(material & 0xFFFF) << 24) |
+		(uint64_t)(depth_key >> 8);
+}
+
+hogl_error hogl_rq_push(hogl_render_queue* rq, uint64_t key, const hogl_rq_draw* draw) {
+	if (draw->texture_count > HOGL_RQ_MAX_TEXTURES) {
+		hogl_log_error("Queued draw has %d textures, at most %d are supported", draw->texture_count, HOGL_RQ_MAX_TEXTURES);
+		return HOGL_ERROR_BAD_ARGUMENT;
+	}
+
+	if (rq->count == rq->capacity) {
+		if (rq->count >= UINT32_MAX || __rq_reserve(rq, rq->capacity * 2) != HOGL_ERROR_NONE) {
+			hogl_log_error("Failed to expand a render queue past %ld draws", rq->capacity);
+			return HOGL_ERROR_MEMORY;
+		}
+	}
+
+	rq->draws[rq->count] = *draw;
+	rq->entries[rq->count].key = key;
+	rq->entries[rq->count].draw = (uint32_t)rq->count;
+	rq->count++;
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_rq_submit(hogl_render_queue* rq) {
+	return __rq_emit(rq, NULL);
+}
+
+hogl_error hogl_rq_record(hogl_render_queue* rq, hogl_cmdbuf* cb) {
+	return __rq_emit(rq, cb);
+}
+
+size_t hogl_rq_count(hogl_render_queue* rq) {
+	return rq->count;
+}
+
+void hogl_rq_clear(hogl_render_queue* rq) {
+	rq->count = 0;
+}
+
+void hogl_rq_free(hogl_render_queue* rq) {
+	hogl_free(rq->draws);
+	hogl_free(rq->entries);
+	hogl_free(rq->scratch);
+	hogl_free(rq);
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+/**
+* @brief hogl render queue file contains a queue of draws that are sorted by a 64 bit key before they are issued,
+* so draws sharing a shader, material or vao are issued together and state changes are kept to a minimum
+*/
+
+#ifndef _HOGL_RENDER_QUEUE_
+#define _HOGL_RENDER_QUEUE_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hogl_core/shared/hogl_def.h"
+#include "hogl_core/graphics/hogl_gl_primitive.h"
+#include "hogl_core/graphics/hogl_cmdbuf.h"
+
+// Maximum number of textures a single queued draw can bind
+#define HOGL_RQ_MAX_TEXTURES 8
+
+/**
+ * @brief Render queue holds draws until they are sorted and submitted
+*/
+typedef struct _hogl_render_queue hogl_render_queue;
+
+/**
+ * @brief A single queued draw, everything it needs to be issued
+*/
+typedef struct _hogl_rq_draw {
+	/**
+	 * @brief Shader and vao to draw with
+	*/
+	hogl_shader* shader;
+	hogl_vao* vao;
+
+	/**
+	 * @brief Textures bound to slots 0 to texture_count - 1
+	*/
+	hogl_texture* textures[HOGL_RQ_MAX_TEXTURES];
+	unsigned int texture_count;
+
+	/**
+	 * @brief Per draw uniform data, ignored if ring is NULL
+	*/
+	hogl_ubo_ring* ring;
+	hogl_ubo_slice slice;
+	unsigned int bp;
+
+	/**
+	 * @brief Draw parameters, instances 0 draws without instancing
+	*/
+	hogl_render_mode mode;
+	unsigned int vertices;
+	unsigned int instances;
+	bool indexed;
+
+	/**
+	 * @brief Index range of an indexed draw, used to draw geometry pool ranges that share one vao
+	*/
+	unsigned int first_index;
+	int base_vertex;
+} hogl_rq_draw;
+
+/**
+ * @brief Creates a new empty render queue
+ * @param rq Where to store the new render queue
+ * @param capacity Number of draws to reserve space for, grows when needed, 0 for a default size
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the queue could not be allocated
+*/
+HOGL_API hogl_error hogl_rq_new(hogl_render_queue** rq, size_t capacity);
+
+/**
+ * @brief Builds a sort key, draws are sorted by layer first, then shader, then material and then depth,
+ * larger values go later
+ * @param layer Layer of the draw e.g. opaque, transparent, overlay, only the lowest 8 bits are used
+ * @param shader Sort id of the shader, only the lowest 16 bits are used
+ * @param material Sort id of the material, only the lowest 16 bits are used
+ * @param depth Distance to the camera, pass a negated distance to sort back to front, quantized to 24 bits
+ * @return Sort key
+*/
+HOGL_API uint64_t hogl_rq_key(unsigned int layer, unsigned int shader, unsigned int material, float depth);
+
+/**
+ * @brief Queues a draw, the draw is copied so it can be a temporary
+ * @param rq Render queue
+ * @param key Sort key, usually made with hogl_rq_key
+ * @param draw Draw to queue
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_BAD_ARGUMENT		if the draw has more than HOGL_RQ_MAX_TEXTURES textures
+ *		HOGL_ERROR_MEMORY			if the queue could not be expanded
+*/
+HOGL_API hogl_error hogl_rq_push(hogl_render_queue* rq, uint64_t key, const hogl_rq_draw* draw);
+
+/**
+ * @brief Sorts the queued draws and issues them, only binds that differ from the previous draw are made
+ * and those still go through the state cache, the queue keeps its draws until hogl_rq_clear
+ * @param rq Render queue
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		any error returned by the issued bind and render functions
+*/
+HOGL_API hogl_error hogl_rq_submit(hogl_render_queue* rq);
+
+/**
+ * @brief Same as hogl_rq_submit, but records the sorted commands into a command buffer instead of issuing them,
+ * can be called on any thread
+ * @param rq Render queue
+ * @param cb Command buffer to record to
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the command buffer could not be expanded
+*/
+HOGL_API hogl_error hogl_rq_record(hogl_render_queue* rq, hogl_cmdbuf* cb);
+
+/**
+ * @brief Returns the number of queued draws
+ * @param rq Render queue
+ * @return Number of draws
+*/
+HOGL_API size_t hogl_rq_count(hogl_render_queue* rq);
+
+/**
+ * @brief Removes all queued draws, keeps the allocated storage, usually called once per frame
+ * @param rq Render queue
+*/
+HOGL_API void hogl_rq_clear(hogl_render_queue* rq);
+
+/**
+ * @brief Frees the render queue
+ * @param rq Render queue to free
+*/
+HOGL_API void hogl_rq_free(hogl_render_queue* rq);
+
+#endif
\ No newline at end of file
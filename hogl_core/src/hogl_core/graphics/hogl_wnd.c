@@ -3,12 +3,19 @@
 #include <gl/glad.h>
 #include <gl/glfw3.h>
 
+#include "hogl_core/graphics/hogl_gl_state.h"
 #include "hogl_core/shared/hogl_log.h"
 #include "hogl_core/shared/hogl_memory.h"
 
 typedef struct _hogl_wnd {
 	GLFWwindow* window;
 	hogl_wi interface;
+
+	// Shadow copy of the context state
+	hogl_gl_state* state;
+
+	// Set once the OpenGL functions were loaded for the context
+	bool loaded;
 } hogl_wnd;
 
 void GLAPIENTRY gl_error_cb(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userPointer) {
@@ -16,6 +23,10 @@ void GLAPIENTRY gl_error_cb(GLenum source, GLenum type, GLuint id, GLenum severi
 	case GL_DEBUG_TYPE_ERROR:
 	case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:
 	case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:
+		if (type == GL_DEBUG_TYPE_ERROR) {
+			__hogl_gl_report(message);
+		}
+
 		hogl_log_error("%s", message)
 			break;
 
@@ -57,6 +68,9 @@ hogl_error hogl_new_window(hogl_wnd** p) {
 		return HOGL_ERROR_WND_CREATE;
 	}
 
+	(*p)->state = hogl_gl_state_new();
+	(*p)->loaded = false;
+
 	// Activate context
 	hogl_activate_context(*p);
 
@@ -67,9 +81,15 @@ hogl_error hogl_new_window(hogl_wnd** p) {
 		return HOGL_ERROR_GLAD_INIT;
 	}
 
+	(*p)->loaded = true;
+	__hogl_gl_set_context_current(1);
+
 	// OpenGL error handling
 #ifndef HOGL_SUPPRESS_GL_LOG
 	glEnable(GL_DEBUG_OUTPUT);
+
+	// Errors are reported inside the failing call while checking, so per frame checks know the last check site before it
+	__hogl_gl_apply_check_mode();
 	glDebugMessageCallback(gl_error_cb, NULL);
 
 	// Disables buffer mapping messages
@@ -97,9 +117,12 @@ hogl_error hogl_new_window(hogl_wnd** p) {
 void hogl_activate_context(hogl_wnd* window) {
 	hogl_log_info("Activating a context");
 	glfwMakeContextCurrent(window->window);
+	hogl_gl_state_make_current(window->state);
+	__hogl_gl_set_context_current(window->loaded);
 }
 
 void hogl_swap_window_buffer(hogl_wnd* window) {
+	hogl_gl_check_frame();
 	glfwSwapBuffers(window->window);
 }
 
@@ -113,6 +136,13 @@ hogl_wi* hogl_get_wi_ptr(hogl_wnd* window) {
 
 void hogl_destroy_window(hogl_wnd* window) {
 	hogl_log_info("Destroying a window");
+
+	// GLFW detaches the context if it is current
+	if (glfwGetCurrentContext() == window->window) {
+		__hogl_gl_set_context_current(0);
+	}
+
 	glfwDestroyWindow(window->window);
+	hogl_gl_state_free(window->state);
 	hogl_free(window);
 }
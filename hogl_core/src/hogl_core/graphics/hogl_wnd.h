@@ -61,7 +61,8 @@ HOGL_API hogl_error hogl_new_window(hogl_wnd** p);
 HOGL_API void hogl_activate_context(hogl_wnd* window);
 
 /**
- * @brief Internally calls glfwSwapBuffers on the specified window
+ * @brief Internally calls glfwSwapBuffers on the specified window, in per frame error check mode
+ * also reports OpenGL errors raised during the frame
  * @param window Window to swap buffers for
 */
 HOGL_API void hogl_swap_window_buffer(hogl_wnd* window);
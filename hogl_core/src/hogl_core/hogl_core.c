@@ -65,6 +65,8 @@ const char* hogl_error_desc(hogl_error err) {
 			return "A window could not be created";
 		case HOGL_ERROR_GLAD_INIT:
 			return "GLAD failed to initialize or load OpenGL symbols";
+		case HOGL_ERROR_OPENGL_UNSUPPORTED:
+			return "The OpenGL context does not support the requested functionality";
 	default:
 		return NULL;
 	}
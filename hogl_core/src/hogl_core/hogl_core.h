@@ -13,8 +13,13 @@
 * HOGL_DISABLE_MEM_TRACK			Disables memory allocation tracking
 * HOGL_DISABLE_GL_BOUND_CHECKING	Disables bound checking for vertex buffer objects
 * HOGL_DISABLE_GL_WARNING			Disables warning that occur when hogl detects an anomaly for example when the user tries to bind a vao before setting all data for vbos
+* HOGL_GL_CHECK_MODE				Default hogl_gl_check_mode, per call unless NDEBUG is defined then per frame, off with HOGL_DISABLE_GL_WARNING
 * HOGL_ENALBE_ALL_GL_LOGS			Enables all by default ignored error messages
 * HOGL_DISABLE_AL_WARNING			Disables warning that occur from OpenAL
+* HOGL_DISABLE_VF_VERIFY			Disables virtual file checksum verification when reading
+* HOGL_GL_SUBDATA_THRESHOLD		Largest DYNAMIC buffer update in bytes that is copied with glBufferSubData instead of mapping, 4096 by default
+* HOGL_GL_SUBDATA_THRESHOLD_STREAM	Same for STREAM buffers, 1024 by default
+* HOGL_GL_SUBDATA_THRESHOLD_STATIC	Same for STATIC buffers, 65536 by default
 */
 
 /**
@@ -26,11 +31,15 @@
 #include "hogl_core/shared/hogl_def.h"
 #include "hogl_core/shared/hogl_memory.h"
 #include "hogl_core/shared/hogl_log.h"
+#include "hogl_core/shared/hogl_job.h"
+#include "hogl_core/shared/hogl_endian.h"
 
 #ifdef HOGL_SUITE_GRAPHICS
 #include "hogl_core/graphics/hogl_wnd.h"
 #include "hogl_core/graphics/hogl_gl_primitive.h"
 #include "hogl_core/graphics/hogl_render.h"
+#include "hogl_core/graphics/hogl_cmdbuf.h"
+#include "hogl_core/graphics/hogl_render_queue.h"
 #endif
 
 #ifdef HOGL_SUITE_AUDIO
@@ -40,6 +49,10 @@
 
 #ifdef HOGL_SUITE_VF
 #include "hogl_core/io/hogl_vf.h"
+#include "hogl_core/io/hogl_vf_async.h"
+#include "hogl_core/io/hogl_vf_mount.h"
+#include "hogl_core/io/hogl_vf_cache.h"
+#include "hogl_core/io/hogl_vf_schema.h"
 #endif
 
 /**
@@ -1,27 +1,142 @@
 #include "hogl_vf.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
 #include "hogl_core/shared/hogl_log.h"
 #include "hogl_core/shared/hogl_memory.h"
+#include "hogl_core/shared/hogl_hash.h"
+#include "hogl_core/shared/hogl_endian.h"
+#include "hogl_core/os/hogl_os.h"
 
 /**
  * @brief VF format is as follows:
  * 4 Bytes for endian check
+ * VF_HEADER_LEN bytes for the header
+ * names_size bytes for the string table of item names
+ * item_count * sizeof(hogl_vf_entry) bytes for the item table
+ * buffer_size bytes of item data, item offsets are relative to the start of this block
+ *
+ * Items with identical data share the same data offset, the item table keeps a content hash
+ * of every item so that a loaded file can keep deduplicating without rehashing its data
+ *
+ * The header contains CRC32C checksums of the index (names and item table) and of the data block,
+ * the item table contains a CRC32C checksum for every item so items can be verified one by one
+ *
+ * Names are stored back to back inside the string table, each followed by a null terminator, and the item table
+ * keeps the offset and length of every name. max_name_len is only a limit for new names
+ *
+ * Removing items leaves holes inside the data block which are reused by new items, hogl_vf_compact removes them
+ *
+ * Everything up to the data block is the index of the file and can be read without touching the data
+ *
+ * A journaled file (VF_FLAG_JOURNAL set in the first header) is a plain file followed by any number of appended
+ * saves, each one made of the data added since the previous save, a new index block and a footer:
+ * data, header, segment count, segments, names, item table, VF_FOOTER_LEN bytes footer
+ * The footer holds the file offset of the latest index block and VF_JOURNAL_MAGIC. Item offsets are relative to
+ * the data of all saves placed back to back, the segment map tells where each part of that data is in the file
+ * hogl_vf_writer streams data right after the first header and writes a journaled file with a single index block
+ *
+ * The header and item table are stored in the byte order of the machine that wrote the file, the endian check
+ * tells the reader if they have to be swapped. Item data is stored as is, so every item table entry records the
+ * byte order its data was written in and typed data can be swapped with hogl_vf_swap_item when needed
 */
 
 #define ENDIAN_CHECK_VAL 0x01234567
 
+// Increment every time the layout of the file changes
+#define VF_FORMAT_REVISION 5
+
+// Header flags
+#define VF_FLAG_CHECKSUMS 0x1
+#define VF_FLAG_JOURNAL 0x2
+
+// Item table entry flags
+#define VF_ENTRY_HASHED 0x1
+#define VF_ENTRY_CHECKSUM 0x2
+#define VF_ENTRY_BIG_ENDIAN 0x4
+
+// Journal footer, offset of the latest index block followed by the magic value "HVFJRNL\0"
+#define VF_JOURNAL_MAGIC 0x004C4E524A465648ULL
+#define VF_FOOTER_LEN (2 * sizeof(uint64_t))
+
+// Position of the flags inside the file, after the endian check and the header fields before them
+#define VF_FLAGS_POSITION (sizeof(uint32_t) + 2 * sizeof(uint32_t) + 3 * sizeof(uint64_t) + sizeof(uint32_t))
+
+// Chunk size used when verifying data that is not in memory
+#define VF_VERIFY_CHUNK (1 << 20)
+
+// Prefetch ranges closer than this inside the file are merged into one request
+#define VF_PREFETCH_GAP (64 << 10)
+
+// Empty slot inside the dedup hash index
+#define VF_DEDUP_EMPTY ((size_t)-1)
+
+// Patch information item, always the last item of a patch made by hogl_vf_diff
+#define VF_PATCH_TYPE 0xFFFFFFFF
+#define VF_PATCH_NAME "hogl_vf_patch"
+#define VF_PATCH_MAGIC 0x50465648
+
+// Format revision
 // Version
 // Item count
 // Buffer size
-#define VF_HEADER_LEN sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint64_t) + sizeof(uint32_t)
+// Names size
+// Max name length
+// Flags
+// Index checksum
+// Data checksum
+#define VF_HEADER_LEN sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint64_t) + sizeof(uint64_t) + \
+	sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint32_t)
+
+/**
+ * @brief Item table entry, this is stored as is inside the file
+*/
+typedef struct _hogl_vf_entry {
+	uint32_t type;
+	uint32_t flags;
+	uint64_t size;
+	uint64_t offset;
+	uint64_t hash;
+	uint32_t crc;
+	uint32_t reserved;
+	uint32_t name_offset;
+	uint32_t name_length;
+} hogl_vf_entry;
+
+/**
+ * @brief Range of bytes inside the data buffer
+*/
+typedef struct _hogl_vf_span {
+	uint64_t offset;
+	uint64_t size;
+} hogl_vf_span;
+
+/**
+ * @brief Part of the data stored in one place inside the file, this is stored as is inside journaled files
+*/
+typedef struct _hogl_vf_segment {
+	uint64_t offset;
+	uint64_t file_offset;
+	uint64_t size;
+} hogl_vf_segment;
+
+/**
+ * @brief Payload of the patch information item, followed by removed_count null terminated names of the items to remove
+*/
+typedef struct _hogl_vf_patch_header {
+	uint32_t magic;
+	uint32_t base_version;
+	uint64_t base_fingerprint;
+	uint64_t target_fingerprint;
+	uint64_t removed_count;
+} hogl_vf_patch_header;
 
 typedef struct _hogl_vfi {
 	uint32_t* type;
 	uint64_t* data_length;
 
-	char* name;
 	char* data;
 } hogl_vfi;
 
@@ -30,352 +145,2975 @@ typedef struct _hogl_vf {
 	uint32_t version;
 	uint64_t item_count;
 	uint64_t buffer_size;
+	uint64_t names_size;
 	uint32_t max_name_len;
+	uint32_t flags;
+	uint32_t index_crc;
+	uint32_t data_crc;
 
 	// Data
+	hogl_vf_entry* table;
 	hogl_vfi* items;
 	char* name_buffer;
 	char* buffer;
+
+	// Renames append to the string table, the old names are dropped on save
+	uint64_t names_capacity;
+	uint64_t names_live;
+
+	// Set if the vf was opened using hogl_vf_open_index
+	hogl_file file;
+
+	// Where the data is inside the file it was read from or saved to
+	hogl_vf_segment* segments;
+	uint64_t segment_count;
+	uint64_t segment_capacity;
+
+	// Journal state, the first persisted_size bytes of data are already inside the file which is persisted_end long
+	bool journal;
+	char* persisted_path;
+	uint64_t persisted_size;
+	uint64_t persisted_end;
+
+	// Open addressing hash index of item table entries with unique data, built on first add
+	size_t* dedup_slots;
+	size_t dedup_capacity;
+	size_t dedup_count;
+
+	// Holes inside the data buffer left by removed items sorted by offset, built on first use
+	hogl_vf_span* holes;
+	size_t hole_count;
+	size_t hole_capacity;
+	bool holes_ready;
+
+	// Lazy item verification, one byte per item set once the item checksum was checked
+	bool verify;
+	uint8_t* verified;
+	size_t verified_size;
+
+	// Set once hogl_vf_map_item handed out a pointer into the data, items might have been edited in place since
+	bool mapped_items;
+
+	// Set if the vf was opened using hogl_vf_open_mapped, the whole file is mapped copy on write
+	char* mapping;
+	uint64_t mapping_size;
+
+	// Access recording, items in the order they were first mapped or read, the mutex guards it against async reads
+	// and the flag is read atomically so reads outside of a recording don't take the mutex
+	hogl_mutex* access_mutex;
+	int record_access;
+	uint8_t* accessed;
+	size_t* access_log;
+	size_t access_count;
+	size_t access_capacity;
 } hogl_vf;
 
+typedef struct _hogl_vf_writer {
+	// Index of the items written so far, the vf has no data buffer
+	hogl_vf* vf;
+	uint64_t table_capacity;
+
+	// Output file and a read handle to it used to confirm duplicates
+	FILE* fp;
+	hogl_file file;
+	char* path;
+	char* compare_buffer;
+
+	// First write error, the file is unusable after it
+	hogl_error error;
+} hogl_vf_writer;
+
 uint32_t get_endian(uint32_t val) {
 	volatile uint32_t i = val;
 	return (*((uint8_t*)(&i))) == 0x67; // 1 for big endian, 0 for little endian
 }
 
-hogl_error hogl_vf_read(hogl_vf** vf, const char* path) {
-	FILE* fp = NULL;
-	uint32_t echeck = 0;
-	size_t rsize = 0;
-	char header_buffer[VF_HEADER_LEN];
-	char* header_bp = &header_buffer[0];
-	
-	hogl_log_trace("Reading virtual file %s", path);
-	
-	fp = fopen(path, "rb");
+uint32_t __host_order_flag() {
+	return hogl_big_endian() ? VF_ENTRY_BIG_ENDIAN : 0;
+}
 
-	if (fp == NULL) {
-		hogl_log_error("Failed to open %s", path);
-		perror("Cause: ");
-		return HOGL_ERROR_BAD_PATH;
+void __swap_entries(hogl_vf_entry* table, uint64_t count) {
+	for (uint64_t i = 0; i < count; i++) {
+		hogl_byte_swap(&table[i].type, 2, sizeof(uint32_t));
+		hogl_byte_swap(&table[i].size, 3, sizeof(uint64_t));
+		hogl_byte_swap(&table[i].crc, 4, sizeof(uint32_t));
 	}
+}
 
-	// Endian check
-	rsize = fread(&echeck, sizeof(uint32_t), 1, fp);
+void __dedup_insert(hogl_vf* vf, size_t entry) {
+	size_t mask = vf->dedup_capacity - 1;
+	size_t slot = (size_t)vf->table[entry].hash & mask;
 
-	if (rsize != 1) {
-		hogl_log_error("Failed to read endian information from %s");
-		return HOGL_ERROR_BAD_READ;
+	while (vf->dedup_slots[slot] != VF_DEDUP_EMPTY) {
+		slot = (slot + 1) & mask;
 	}
-	echeck = get_endian(echeck);
 
-	*vf = (hogl_vf*)hogl_malloc((sizeof(hogl_vf)));
+	vf->dedup_slots[slot] = entry;
+	vf->dedup_count++;
+}
+
+hogl_error __dedup_reserve(hogl_vf* vf, size_t count) {
+	size_t new_capacity = vf->dedup_capacity == 0 ? 64 : vf->dedup_capacity;
+	size_t* old_slots = vf->dedup_slots;
+	size_t old_capacity = vf->dedup_capacity;
 
-	if (get_endian(ENDIAN_CHECK_VAL) != echeck) {
-		hogl_log_error("Virtual file %s and machine endianness don't match");
-		return HOGL_ERROR_ENDIAN_MISMATCH;
+	// Keep the load factor under 50%
+	while (new_capacity < (vf->dedup_count + count) * 2) {
+		new_capacity *= 2;
 	}
 
-	// Header
-	rsize = fread(header_buffer, VF_HEADER_LEN, 1, fp);
+	if (new_capacity == vf->dedup_capacity) {
+		return HOGL_ERROR_NONE;
+	}
 
-	if (rsize != 1) {
-		hogl_log_error("Failed to read header information from %s");
-		hogl_free(*vf);
-		return HOGL_ERROR_BAD_READ;
+	vf->dedup_slots = hogl_malloc(new_capacity * sizeof(size_t));
+
+	if (vf->dedup_slots == NULL) {
+		vf->dedup_slots = old_slots;
+		return HOGL_ERROR_MEMORY;
 	}
 
-	(*vf)->version = *(uint32_t*)header_bp;
-	(*vf)->item_count = *(uint64_t*)(header_bp + sizeof(uint32_t));
-	(*vf)->buffer_size = *(uint64_t*)(header_bp + sizeof(uint32_t) + sizeof(uint64_t));
-	(*vf)->max_name_len = *(uint32_t*)(header_bp + sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint64_t));
+	hogl_memset(vf->dedup_slots, 0xFF, new_capacity * sizeof(size_t));
+	vf->dedup_capacity = new_capacity;
+	vf->dedup_count = 0;
 
-	// Allocate buffers
-	(*vf)->items = NULL;
-	(*vf)->name_buffer = hogl_malloc((*vf)->item_count * (*vf)->max_name_len);
-	(*vf)->buffer = hogl_malloc((*vf)->buffer_size);
+	for (size_t i = 0; i < old_capacity; i++) {
+		if (old_slots[i] != VF_DEDUP_EMPTY) {
+			__dedup_insert(vf, old_slots[i]);
+		}
+	}
 
-	// Read name
-	rsize = fread((*vf)->name_buffer, (*vf)->item_count * (*vf)->max_name_len, 1, fp);
+	hogl_free(old_slots);
 
-	if (rsize != 1) {
-		hogl_log_error("Failed to read name information from %s");
-		hogl_vf_free((*vf));
-		return HOGL_ERROR_BAD_READ;
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error __append_name(hogl_vf* vf, const char* name, uint32_t length, uint32_t* offset) {
+	uint64_t required = vf->names_size + length + 1;
+
+	if (required > UINT32_MAX) {
+		hogl_log_error("Virtual file string table is full");
+		return HOGL_ERROR_MEMORY;
 	}
 
-	// Read data
-	rsize = fread((*vf)->buffer, (*vf)->buffer_size, 1, fp);
+	// Grow geometrically so renames and adds stay O(1) amortized
+	if (required > vf->names_capacity) {
+		uint64_t new_capacity = vf->names_capacity == 0 ? 256 : vf->names_capacity;
+		char* new_name_buffer = NULL;
 
-	if (rsize != 1) {
-		hogl_log_error("Failed to read data information from %s");
-		hogl_vf_free((*vf));
-		return HOGL_ERROR_BAD_READ;
+		while (new_capacity < required) {
+			new_capacity *= 2;
+		}
+
+		new_name_buffer = hogl_realloc(vf->name_buffer, new_capacity);
+
+		if (new_name_buffer == NULL) {
+			hogl_log_error("Failed to realloc virtual file string table");
+			return HOGL_ERROR_MEMORY;
+		}
+
+		vf->name_buffer = new_name_buffer;
+		vf->names_capacity = new_capacity;
 	}
 
-	// Create mappings
-	hogl_vf_map_vfi((*vf));
+	(*offset) = (uint32_t)vf->names_size;
 
-	// Close file
-	fclose(fp);
+	if (length != 0) {
+		hogl_smemcpy(vf->name_buffer + vf->names_size, name, length);
+	}
+	vf->name_buffer[vf->names_size + length] = '\0';
+
+	vf->names_size = required;
+	vf->names_live += length + 1;
 
 	return HOGL_ERROR_NONE;
 }
 
-hogl_vf* hogl_vf_new(uint32_t version, uint32_t max_name_len) {
-	hogl_vf* vf = hogl_malloc(sizeof(hogl_vf));
-	vf->buffer = NULL;
-	vf->name_buffer = NULL;
-	vf->items = NULL;
-	vf->item_count = 0;
-	vf->buffer_size = 0;
-	vf->version = version;
-	vf->max_name_len = max_name_len;
-	return vf;
-}
+hogl_error __compact_names(hogl_vf* vf) {
+	char* new_name_buffer = NULL;
+	uint64_t offset = 0;
 
-void hogl_vf_change_name_len(hogl_vf* vf, uint32_t new_name_len) {
-	char* new_name_buffer = hogl_malloc(new_name_len * vf->item_count);
+	if (vf->names_live == vf->names_size) {
+		return HOGL_ERROR_NONE;
+	}
+
+	new_name_buffer = hogl_malloc(vf->names_live);
+
+	if (new_name_buffer == NULL && vf->names_live != 0) {
+		hogl_log_error("Failed to allocate virtual file string table");
+		return HOGL_ERROR_MEMORY;
+	}
 
 	for (uint64_t i = 0; i < vf->item_count; i++) {
-		hogl_memcpy(new_name_buffer + i * new_name_len, vf->name_buffer + i * vf->max_name_len, vf->max_name_len);
+		hogl_vf_entry* entry = &vf->table[i];
+
+		hogl_smemcpy(new_name_buffer + offset, vf->name_buffer + entry->name_offset, entry->name_length + 1);
+		entry->name_offset = (uint32_t)offset;
+		offset += entry->name_length + 1;
 	}
 
 	hogl_free(vf->name_buffer);
 	vf->name_buffer = new_name_buffer;
-	vf->max_name_len = new_name_len;
+	vf->names_size = vf->names_live;
+	vf->names_capacity = vf->names_live;
 
-	hogl_vf_map_vfi(vf);
+	return HOGL_ERROR_NONE;
 }
 
-hogl_error hogl_vf_add_item(hogl_vf* vf, const char* name, uint32_t type, void* data, uint64_t size) {
-	uint64_t elment_stride = (sizeof(uint32_t) + sizeof(uint64_t) + size);
-	uint64_t prev_size = vf->buffer_size;
-	uint64_t new_size = prev_size + elment_stride;
-	char* new_name_buffer = NULL;
-	char* new_data_buffer = NULL;
+bool __dedup_find(hogl_vf* vf, uint64_t hash, void* data, uint64_t size, size_t* found) {
+	size_t mask = vf->dedup_capacity - 1;
+	size_t slot = (size_t)hash & mask;
 
-	if (vf->max_name_len < strlen(name)) {
-		hogl_log_error("Trying to assign name that doesn't fit inside a virtual file");
-		return HOGL_ERROR_BAD_ARGUMENT;
+	while (vf->dedup_slots[slot] != VF_DEDUP_EMPTY) {
+		hogl_vf_entry* entry = &vf->table[vf->dedup_slots[slot]];
+
+		// The hash only narrows down the candidates, the data has to match exactly and be in the same byte order
+		if (entry->hash == hash && entry->size == size && (entry->flags & VF_ENTRY_BIG_ENDIAN) == __host_order_flag() &&
+			(size == 0 || memcmp(vf->buffer + entry->offset, data, size) == 0)) {
+			(*found) = vf->dedup_slots[slot];
+			return true;
+		}
+
+		slot = (slot + 1) & mask;
 	}
 
-	// Need to expand memory
-	new_name_buffer = hogl_realloc(vf->name_buffer, vf->max_name_len * (vf->item_count + 1) * sizeof(char));
-	new_data_buffer = hogl_realloc(vf->buffer, new_size);
+	return false;
+}
 
-	if (new_name_buffer == NULL || new_data_buffer == NULL) {
-		hogl_log_error("Failed to realloc virtual file buffers");
+hogl_error __dedup_build(hogl_vf* vf) {
+	size_t unused = 0;
+
+	if (__dedup_reserve(vf, vf->item_count) != HOGL_ERROR_NONE) {
 		return HOGL_ERROR_MEMORY;
 	}
 
-	// NULL memory inside the name buffer
-	hogl_memset(new_name_buffer + vf->item_count * vf->max_name_len, 0, vf->max_name_len);
+	for (uint64_t i = 0; i < vf->item_count; i++) {
+		hogl_vf_entry* entry = &vf->table[i];
 
-	vf->item_count++;
-	vf->name_buffer = new_name_buffer;
-	vf->buffer = new_data_buffer;
-	vf->buffer_size = new_size;
+		// Files written by other tools might not have hashes
+		if ((entry->flags & VF_ENTRY_HASHED) == 0) {
+			entry->hash = hogl_hash64(vf->buffer + entry->offset, entry->size, 0);
+			entry->flags |= VF_ENTRY_HASHED;
+		}
 
-	// Store name and data
-	hogl_memcpy(vf->name_buffer + (vf->item_count - 1) * vf->max_name_len, name, strlen(name));
-	
-	*(uint32_t*)(vf->buffer + prev_size) = type;
-	*(uint64_t*)(vf->buffer + prev_size + sizeof(uint32_t)) = size;
-	hogl_smemcpy(vf->buffer + prev_size + sizeof(uint32_t) + sizeof(uint64_t), data, size);
+		if (!__dedup_find(vf, entry->hash, vf->buffer + entry->offset, entry->size, &unused)) {
+			__dedup_insert(vf, i);
+		}
+	}
 
 	return HOGL_ERROR_NONE;
 }
 
-hogl_error hogl_vf_rename_item(hogl_vf* vf, size_t index, const char* new_name)
-{
-	if (vf->item_count <= index) {
-		hogl_log_warn("Tried to access invalid virtual file item");
-		return HOGL_ERROR_OUT_OF_RANGE;
+int __span_compare(const void* a, const void* b) {
+	const hogl_vf_span* sa = (const hogl_vf_span*)a;
+	const hogl_vf_span* sb = (const hogl_vf_span*)b;
+	return sa->offset < sb->offset ? -1 : (sa->offset > sb->offset ? 1 : 0);
+}
+
+hogl_vf_span* __sorted_spans(hogl_vf* vf, size_t* count) {
+	hogl_vf_span* spans = hogl_malloc(vf->item_count * sizeof(hogl_vf_span));
+	(*count) = 0;
+
+	if (spans == NULL) {
+		return NULL;
 	}
 
-	if (vf->max_name_len < strlen(new_name)) {
-		hogl_log_error("Name %s cannot be assigned cause length &ld exceeds the max name length %ld of virtual file", new_name, strlen(new_name), vf->max_name_len)
-		return HOGL_ERROR_MEMORY;
+	for (uint64_t i = 0; i < vf->item_count; i++) {
+		if (vf->table[i].size != 0) {
+			spans[*count].offset = vf->table[i].offset;
+			spans[*count].size = vf->table[i].size;
+			(*count)++;
+		}
 	}
 
-	if (vf->items == NULL) {
-		hogl_log_warn("Ignoring unmapped virtual file item change");
-		return HOGL_ERROR_VF_VFI_MAP;
+	qsort(spans, *count, sizeof(hogl_vf_span), __span_compare);
+
+	return spans;
+}
+
+hogl_error __holes_reserve(hogl_vf* vf, size_t count) {
+	size_t new_capacity = vf->hole_capacity == 0 ? 16 : vf->hole_capacity;
+	hogl_vf_span* new_holes = NULL;
+
+	while (new_capacity < vf->hole_count + count) {
+		new_capacity *= 2;
+	}
+
+	if (new_capacity == vf->hole_capacity) {
+		return HOGL_ERROR_NONE;
 	}
 
-	// Delete the original name
-	hogl_memset(vf->items[index].name, 0, vf->max_name_len);
+	new_holes = hogl_realloc(vf->holes, new_capacity * sizeof(hogl_vf_span));
+
+	if (new_holes == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
 
-	// Write the new name
-	hogl_smemcpy(vf->items[index].name, new_name, vf->max_name_len);
+	vf->holes = new_holes;
+	vf->hole_capacity = new_capacity;
 
 	return HOGL_ERROR_NONE;
 }
 
-void hogl_vf_map_vfi(hogl_vf* vf) {
-	if (vf->items != NULL) {
-		hogl_free(vf->items);
-	}
+hogl_error __holes_build(hogl_vf* vf) {
+	size_t count = 0;
+	uint64_t cursor = 0;
+	hogl_vf_span* spans = NULL;
 
-	vf->items = hogl_malloc(sizeof(hogl_vfi) * vf->item_count);
+	vf->hole_count = 0;
 
-	// Parse data information
-	uint64_t offset = 0;
-	for (uint64_t i = 0; i < vf->item_count; i++) {
-		hogl_vfi* ivfi = &vf->items[i];
+	if (vf->item_count != 0) {
+		spans = __sorted_spans(vf, &count);
 
-		ivfi->type = (uint32_t*)(vf->buffer + offset);
-		offset += sizeof(uint32_t);
+		if (spans == NULL) {
+			return HOGL_ERROR_MEMORY;
+		}
+	}
 
-		ivfi->name = vf->name_buffer + (i * vf->max_name_len);
+	// Anything not covered by an item is a hole, files written by other tools can contain them too
+	for (size_t i = 0; i <= count; i++) {
+		uint64_t start = i < count ? spans[i].offset : vf->buffer_size;
 
-		ivfi->data_length = (uint64_t*)(vf->buffer + offset);
-		offset += sizeof(uint64_t);
+		if (start > cursor) {
+			if (__holes_reserve(vf, 1) != HOGL_ERROR_NONE) {
+				hogl_free(spans);
+				return HOGL_ERROR_MEMORY;
+			}
+
+			vf->holes[vf->hole_count].offset = cursor;
+			vf->holes[vf->hole_count].size = start - cursor;
+			vf->hole_count++;
+		}
 
-		ivfi->data = vf->buffer + offset;
-		offset += *ivfi->data_length;
+		if (i < count && spans[i].offset + spans[i].size > cursor) {
+			cursor = spans[i].offset + spans[i].size;
+		}
 	}
+
+	hogl_free(spans);
+	vf->holes_ready = true;
+
+	return HOGL_ERROR_NONE;
 }
 
-hogl_error hogl_vf_save(hogl_vf* vf, const char* path) {
-	FILE* fp = NULL;
-	uint32_t echeck = ENDIAN_CHECK_VAL;
-	size_t rsize = 0;
-	char header_buffer[VF_HEADER_LEN];
-	char* header_bp = &header_buffer[0];
+hogl_error __holes_insert(hogl_vf* vf, uint64_t offset, uint64_t size) {
+	size_t lo = 0;
+	size_t hi = vf->hole_count;
 
-	hogl_log_trace("Saving virtual file to %s", path);
+	// Holes at the end of the data are given back, unless they are already inside a journaled file
+	if (offset + size == vf->buffer_size && !(vf->journal && offset < vf->persisted_size)) {
+		vf->buffer_size = offset;
 
-	fp = fopen(path, "wb");
+		while (vf->hole_count != 0 && vf->holes[vf->hole_count - 1].offset + vf->holes[vf->hole_count - 1].size == vf->buffer_size &&
+			!(vf->journal && vf->holes[vf->hole_count - 1].offset < vf->persisted_size)) {
+			vf->buffer_size = vf->holes[vf->hole_count - 1].offset;
+			vf->hole_count--;
+		}
 
-	if (fp == NULL) {
-		hogl_log_error("Failed to open %s", path);
-		perror("Cause: ");
-		return HOGL_ERROR_BAD_PATH;
+		// Data inside the file no longer matches
+		if (vf->buffer_size < vf->persisted_size) {
+			vf->persisted_size = 0;
+		}
+
+		return HOGL_ERROR_NONE;
 	}
 
-	// Endian check
-	rsize = fwrite(&echeck, sizeof(uint32_t), 1, fp);
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
 
-	if (rsize != 1) {
-		hogl_log_error("Failed to write endian information to %s");
-		return HOGL_ERROR_BAD_WRITE;
+		if (vf->holes[mid].offset < offset) {
+			lo = mid + 1;
+		}
+		else {
+			hi = mid;
+		}
 	}
 
-	// Header
-	*(uint32_t*)(header_bp) = vf->version;
-	*(uint64_t*)(header_bp + sizeof(uint32_t)) = vf->item_count;
-	*(uint64_t*)(header_bp + sizeof(uint32_t) + sizeof(uint64_t)) = vf->buffer_size;
-	*(uint32_t*)(header_bp + sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint64_t)) = vf->max_name_len;
+	// Merge with neighbours
+	if (lo > 0 && vf->holes[lo - 1].offset + vf->holes[lo - 1].size == offset) {
+		vf->holes[lo - 1].size += size;
 
-	rsize = fwrite(header_buffer, VF_HEADER_LEN, 1, fp);
+		if (lo < vf->hole_count && offset + size == vf->holes[lo].offset) {
+			vf->holes[lo - 1].size += vf->holes[lo].size;
+			memmove(&vf->holes[lo], &vf->holes[lo + 1], (vf->hole_count - lo - 1) * sizeof(hogl_vf_span));
+			vf->hole_count--;
+		}
 
-	if (rsize != 1) {
-		hogl_log_error("Failed to write header information to %s");
-		return HOGL_ERROR_BAD_WRITE;
+		return HOGL_ERROR_NONE;
 	}
 
-	// Write name buffer
-	rsize = fwrite(vf->name_buffer, vf->item_count * vf->max_name_len, 1, fp);
-
-	if (rsize != 1) {
-		hogl_log_error("Failed to write name information to %s");
-		return HOGL_ERROR_BAD_WRITE;
+	if (lo < vf->hole_count && offset + size == vf->holes[lo].offset) {
+		vf->holes[lo].offset = offset;
+		vf->holes[lo].size += size;
+		return HOGL_ERROR_NONE;
 	}
 
-	// Write data
-	rsize = fwrite(vf->buffer, vf->buffer_size, 1, fp);
-
-	if (rsize != 1) {
-		hogl_log_error("Failed to write data information to %s");
-		return HOGL_ERROR_BAD_WRITE;
+	if (__holes_reserve(vf, 1) != HOGL_ERROR_NONE) {
+		return HOGL_ERROR_MEMORY;
 	}
 
-	// Close file
-	fclose(fp);
+	memmove(&vf->holes[lo + 1], &vf->holes[lo], (vf->hole_count - lo) * sizeof(hogl_vf_span));
+	vf->holes[lo].offset = offset;
+	vf->holes[lo].size = size;
+	vf->hole_count++;
 
 	return HOGL_ERROR_NONE;
 }
 
-hogl_error hogl_vf_get_item_index(hogl_vf* vf, const char* name, size_t* index) {
-	if (vf->items == NULL) {
-		hogl_log_warn("Ignoring unmapped virtual file item change");
-		return HOGL_ERROR_VF_VFI_MAP;
-	}
+bool __holes_find(hogl_vf* vf, uint64_t size, size_t* found) {
+	// Best fit keeps large holes for large items
+	bool any = false;
 
-	for (*index = 0; *index < vf->item_count; (*index)++) {
-		if (strcmp(name, vf->items[*index].name) == 0) {
-			return HOGL_ERROR_NONE;
+	for (size_t i = 0; i < vf->hole_count; i++) {
+		// Journaled saves only append so data already inside the file can't be overwritten
+		if (vf->journal && vf->holes[i].offset < vf->persisted_size) {
+			continue;
+		}
+
+		if (vf->holes[i].size >= size && (!any || vf->holes[i].size < vf->holes[*found].size)) {
+			(*found) = i;
+			any = true;
+
+			if (vf->holes[i].size == size) {
+				break;
+			}
 		}
 	}
 
-	return HOGL_ERROR_VF_BAD_NAME;
+	return any;
 }
 
-uint32_t hogl_vf_version(hogl_vf* vf) {
-	return vf->version;
+void __holes_consume(hogl_vf* vf, size_t hole, uint64_t size) {
+	vf->holes[hole].offset += size;
+	vf->holes[hole].size -= size;
+
+	if (vf->holes[hole].size == 0) {
+		memmove(&vf->holes[hole], &vf->holes[hole + 1], (vf->hole_count - hole - 1) * sizeof(hogl_vf_span));
+		vf->hole_count--;
+	}
 }
 
-void hogl_vf_set_version(hogl_vf* vf, uint32_t version) {
-	if (version < vf->version) {
-		hogl_log_warn("Setting new virtual file version to lower than the existing one");
+uint32_t __index_crc(hogl_vf* vf) {
+	uint32_t crc = 0;
+
+	if (vf->item_count != 0) {
+		crc = hogl_crc32c(crc, vf->name_buffer, vf->names_size);
+		crc = hogl_crc32c(crc, vf->table, vf->item_count * sizeof(hogl_vf_entry));
 	}
 
-	vf->version = version;
+	if ((vf->flags & VF_FLAG_JOURNAL) != 0 && vf->segment_count != 0) {
+		crc = hogl_crc32c(crc, vf->segments, vf->segment_count * sizeof(hogl_vf_segment));
+	}
+
+	return crc;
 }
 
-hogl_error hogl_vf_map_item(hogl_vf* vf, size_t index, void** target) {
-	if (vf->item_count <= index) {
-		hogl_log_warn("Tried to access invalid virtual file item");
-		return HOGL_ERROR_OUT_OF_RANGE;
+// Keeps a verified flag for every item, new items start out unverified
+void __verified_grow(hogl_vf* vf) {
+	uint8_t* new_verified = NULL;
+	size_t new_size = vf->verified_size;
+
+	if (vf->verified == NULL || vf->item_count <= vf->verified_size) {
+		return;
 	}
 
-	if (vf->items == NULL) {
-		hogl_log_warn("Ignoring unmapped virtual file item change");
-		return HOGL_ERROR_VF_VFI_MAP;
+	while (new_size < vf->item_count) {
+		new_size = new_size == 0 ? 16 : new_size * 2;
 	}
 
-	(*target) = vf->items[index].data;
+	new_verified = hogl_realloc(vf->verified, new_size);
 
-	return HOGL_ERROR_NONE;
+	if (new_verified == NULL) {
+		hogl_log_warn("Failed to expand the verified item flags, new items are verified on every read");
+		return;
+	}
+
+	hogl_memset(new_verified + vf->verified_size, 0, new_size - vf->verified_size);
+	vf->verified = new_verified;
+	vf->verified_size = new_size;
 }
 
-hogl_error hogl_vf_item_size(hogl_vf* vf, size_t index, uint64_t* target) {
-	if (vf->item_count <= index) {
-		hogl_log_warn("Tried to access invalid virtual file item");
-		return HOGL_ERROR_OUT_OF_RANGE;
+hogl_error __verify_item(hogl_vf* vf, size_t index, const void* data) {
+#ifndef HOGL_DISABLE_VF_VERIFY
+	// Items past the flag array could not be tracked and are checked on every read
+	bool tracked = index < vf->verified_size;
+
+	if (!vf->verify || vf->verified == NULL || (tracked && vf->verified[index]) || (vf->table[index].flags & VF_ENTRY_CHECKSUM) == 0) {
+		return HOGL_ERROR_NONE;
 	}
 
-	if (vf->items == NULL) {
-		hogl_log_warn("Ignoring unmapped virtual file item change");
-		return HOGL_ERROR_VF_VFI_MAP;
+	if (hogl_crc32c(0, data, vf->table[index].size) != vf->table[index].crc) {
+		hogl_log_error("Virtual file item %ld checksum mismatch, the data is corrupted", index);
+		return HOGL_ERROR_VF_CHECKSUM;
 	}
 
-	(*target) = *vf->items[index].data_length;
+	if (tracked) {
+		vf->verified[index] = 1;
+	}
+#endif
 
 	return HOGL_ERROR_NONE;
 }
 
-hogl_error hogl_vf_item_type(hogl_vf* vf, size_t index, uint32_t* target) {
-	if (vf->item_count <= index) {
-		hogl_log_warn("Tried to access invalid virtual file item");
-		return HOGL_ERROR_OUT_OF_RANGE;
+void __set_persisted(hogl_vf* vf, const char* path, uint64_t size, uint64_t end) {
+	size_t path_length = strlen(path);
+
+	hogl_free(vf->persisted_path);
+	vf->persisted_path = hogl_malloc(path_length + 1);
+
+	if (vf->persisted_path != NULL) {
+		hogl_smemcpy(vf->persisted_path, path, path_length + 1);
 	}
 
-	if (vf->items == NULL) {
-		hogl_log_warn("Ignoring unmapped virtual file item change");
-		return HOGL_ERROR_VF_VFI_MAP;
+	vf->persisted_size = size;
+	vf->persisted_end = end;
+}
+
+hogl_error __reserve_segments(hogl_vf* vf, uint64_t count) {
+	uint64_t new_capacity = vf->segment_capacity == 0 ? 4 : vf->segment_capacity;
+	hogl_vf_segment* new_segments = NULL;
+
+	while (new_capacity < count) {
+		new_capacity *= 2;
 	}
 
-	(*target) = *vf->items[index].type;
+	if (new_capacity == vf->segment_capacity) {
+		return HOGL_ERROR_NONE;
+	}
+
+	new_segments = hogl_realloc(vf->segments, new_capacity * sizeof(hogl_vf_segment));
+
+	if (new_segments == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	vf->segments = new_segments;
+	vf->segment_capacity = new_capacity;
 
 	return HOGL_ERROR_NONE;
 }
 
-void hogl_vf_free(hogl_vf* vf) {
-	hogl_free(vf->buffer);
-	hogl_free(vf->items);
-	hogl_free(vf->name_buffer);
+hogl_error __read_data(hogl_vf* vf, hogl_file file, uint64_t offset, void* dst, uint64_t size) {
+	size_t lo = 0;
+	size_t hi = vf->segment_count;
+	char* dst_bp = (char*)dst;
+
+	// Last segment starting at or before offset
+	while (hi - lo > 1) {
+		size_t mid = (lo + hi) / 2;
+
+		if (vf->segments[mid].offset <= offset) {
+			lo = mid;
+		}
+		else {
+			hi = mid;
+		}
+	}
+
+	while (size != 0) {
+		hogl_vf_segment* segment = NULL;
+		uint64_t skip = 0;
+		uint64_t part = 0;
+
+		if (lo >= vf->segment_count) {
+			return HOGL_ERROR_BAD_READ;
+		}
+
+		segment = &vf->segments[lo];
+
+		if (offset < segment->offset || offset - segment->offset >= segment->size) {
+			return HOGL_ERROR_BAD_READ;
+		}
+
+		skip = offset - segment->offset;
+		part = segment->size - skip < size ? segment->size - skip : size;
+
+		if (hogl_file_pread(file, dst_bp, part, segment->file_offset + skip) != part) {
+			return HOGL_ERROR_BAD_READ;
+		}
+
+		dst_bp += part;
+		offset += part;
+		size -= part;
+		lo++;
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+char* __mapped_data(hogl_vf* vf, uint64_t offset, uint64_t size) {
+	size_t lo = 0;
+	size_t hi = vf->segment_count;
+	hogl_vf_segment* segment = NULL;
+
+	if (vf->mapping == NULL || vf->segment_count == 0) {
+		return NULL;
+	}
+
+	// Last segment starting at or before offset
+	while (hi - lo > 1) {
+		size_t mid = (lo + hi) / 2;
+
+		if (vf->segments[mid].offset <= offset) {
+			lo = mid;
+		}
+		else {
+			hi = mid;
+		}
+	}
+
+	segment = &vf->segments[lo];
+
+	// Only data stored in one place inside the file can be used directly
+	if (offset < segment->offset || offset - segment->offset > segment->size || segment->size - (offset - segment->offset) < size) {
+		return NULL;
+	}
+
+	if (segment->file_offset + (offset - segment->offset) + size > vf->mapping_size) {
+		return NULL;
+	}
+
+	return vf->mapping + segment->file_offset + (offset - segment->offset);
+}
+
+void __record_access(hogl_vf* vf, size_t index) {
+	if (!hogl_atomic_get_b32(&vf->record_access)) {
+		return;
+	}
+
+	hogl_mutex_lock(vf->access_mutex);
+
+	if (vf->record_access && index < vf->access_capacity && vf->accessed[index] == 0) {
+		vf->accessed[index] = 1;
+		vf->access_log[vf->access_count++] = index;
+	}
+
+	hogl_mutex_unlock(vf->access_mutex);
+}
+
+hogl_error __read_vf_header(hogl_vf* vf, hogl_file file, uint64_t offset, bool swap, const char* path) {
+	char header_buffer[VF_HEADER_LEN];
+	char* header_bp = &header_buffer[0];
+
+	if (hogl_file_pread(file, header_buffer, VF_HEADER_LEN, offset) != VF_HEADER_LEN) {
+		hogl_log_error("Failed to read header information from %s", path);
+		return HOGL_ERROR_BAD_READ;
+	}
+
+	if (swap) {
+		// Revision, version
+		hogl_byte_swap(header_bp, 2, sizeof(uint32_t));
+		// Item count, buffer size, names size
+		hogl_byte_swap(header_bp + 2 * sizeof(uint32_t), 3, sizeof(uint64_t));
+		// Max name length, flags, index checksum, data checksum
+		hogl_byte_swap(header_bp + 2 * sizeof(uint32_t) + 3 * sizeof(uint64_t), 4, sizeof(uint32_t));
+	}
+
+	if (*(uint32_t*)header_bp != VF_FORMAT_REVISION) {
+		hogl_log_error("Virtual file %s format revision %ld is not supported, expected %ld", path, *(uint32_t*)header_bp, VF_FORMAT_REVISION);
+		return HOGL_ERROR_BAD_READ;
+	}
+
+	header_bp += sizeof(uint32_t);
+	vf->version = *(uint32_t*)header_bp;
+	header_bp += sizeof(uint32_t);
+	vf->item_count = *(uint64_t*)header_bp;
+	header_bp += sizeof(uint64_t);
+	vf->buffer_size = *(uint64_t*)header_bp;
+	header_bp += sizeof(uint64_t);
+	vf->names_size = *(uint64_t*)header_bp;
+	header_bp += sizeof(uint64_t);
+	vf->max_name_len = *(uint32_t*)header_bp;
+	header_bp += sizeof(uint32_t);
+	vf->flags = *(uint32_t*)header_bp;
+	header_bp += sizeof(uint32_t);
+	vf->index_crc = *(uint32_t*)header_bp;
+	header_bp += sizeof(uint32_t);
+	vf->data_crc = *(uint32_t*)header_bp;
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error __read_vf_index(hogl_vf* vf, hogl_file file, const char* path) {
+	uint32_t echeck = 0;
+	uint64_t offset = 0;
+	uint64_t file_size = hogl_file_size(file);
+	uint64_t footer[2];
+	uint64_t covered = 0;
+	bool swap = false;
+	hogl_error err = HOGL_ERROR_NONE;
+
+	// Endian check
+	if (hogl_file_pread(file, &echeck, sizeof(uint32_t), offset) != sizeof(uint32_t)) {
+		hogl_log_error("Failed to read endian information from %s", path);
+		return HOGL_ERROR_BAD_READ;
+	}
+	offset += sizeof(uint32_t);
+
+	if (get_endian(ENDIAN_CHECK_VAL) != get_endian(echeck)) {
+		hogl_log_trace("Virtual file %s was written with a different byte order, swapping index", path);
+		swap = true;
+	}
+
+	// Header
+	err = __read_vf_header(vf, file, offset, swap, path);
+
+	if (err != HOGL_ERROR_NONE) {
+		return err;
+	}
+	offset += VF_HEADER_LEN;
+
+	// Journaled files have their latest index at the end, the footer points to it
+	if ((vf->flags & VF_FLAG_JOURNAL) != 0) {
+		if (file_size < offset + VF_FOOTER_LEN || hogl_file_pread(file, footer, VF_FOOTER_LEN, file_size - VF_FOOTER_LEN) != VF_FOOTER_LEN) {
+			hogl_log_error("Failed to read journal footer from %s", path);
+			return HOGL_ERROR_BAD_READ;
+		}
+
+		if (swap) {
+			hogl_byte_swap(footer, 2, sizeof(uint64_t));
+		}
+
+		if (footer[1] != VF_JOURNAL_MAGIC || footer[0] + VF_HEADER_LEN + sizeof(uint64_t) > file_size - VF_FOOTER_LEN) {
+			hogl_log_error("Virtual file %s has an invalid journal footer", path);
+			return HOGL_ERROR_BAD_READ;
+		}
+
+		offset = footer[0];
+		err = __read_vf_header(vf, file, offset, swap, path);
+
+		if (err != HOGL_ERROR_NONE) {
+			return err;
+		}
+		offset += VF_HEADER_LEN;
+
+		// Segment map
+		if (hogl_file_pread(file, &vf->segment_count, sizeof(uint64_t), offset) != sizeof(uint64_t)) {
+			hogl_log_error("Failed to read segment map from %s", path);
+			return HOGL_ERROR_BAD_READ;
+		}
+		offset += sizeof(uint64_t);
+
+		if (swap) {
+			hogl_byte_swap(&vf->segment_count, 1, sizeof(uint64_t));
+		}
+
+		if (offset > file_size || vf->segment_count > (file_size - offset) / sizeof(hogl_vf_segment) ||
+			vf->segment_count * sizeof(hogl_vf_segment) > UINT32_MAX) {
+			hogl_log_error("Virtual file %s has an invalid segment map", path);
+			return HOGL_ERROR_BAD_READ;
+		}
+
+		if (vf->segment_count != 0) {
+			vf->segments = hogl_malloc(vf->segment_count * sizeof(hogl_vf_segment));
+			vf->segment_capacity = vf->segment_count;
+
+			if (hogl_file_pread(file, vf->segments, vf->segment_count * sizeof(hogl_vf_segment), offset) != vf->segment_count * sizeof(hogl_vf_segment)) {
+				hogl_log_error("Failed to read segment map from %s", path);
+				return HOGL_ERROR_BAD_READ;
+			}
+			offset += vf->segment_count * sizeof(hogl_vf_segment);
+		}
+	}
+
+	// Sizes come from the file so they are checked against what is left of it before allocating
+	if (offset > file_size) {
+		hogl_log_error("Virtual file %s index is truncated", path);
+		return HOGL_ERROR_BAD_READ;
+	}
+
+	// Names
+	if (vf->names_size > UINT32_MAX || vf->names_size > file_size - offset) {
+		hogl_log_error("Virtual file %s string table is too large", path);
+		return HOGL_ERROR_BAD_READ;
+	}
+
+	if (vf->names_size != 0) {
+		vf->name_buffer = hogl_malloc(vf->names_size);
+		vf->names_capacity = vf->names_size;
+		vf->names_live = vf->names_size;
+
+		if (hogl_file_pread(file, vf->name_buffer, vf->names_size, offset) != vf->names_size) {
+			hogl_log_error("Failed to read name information from %s", path);
+			return HOGL_ERROR_BAD_READ;
+		}
+		offset += vf->names_size;
+	}
+
+	// Item table
+	if (vf->item_count > (file_size - offset) / sizeof(hogl_vf_entry) || vf->item_count * sizeof(hogl_vf_entry) > UINT32_MAX) {
+		hogl_log_error("Virtual file %s item table is too large", path);
+		return HOGL_ERROR_BAD_READ;
+	}
+
+	if (vf->item_count != 0) {
+		vf->table = hogl_malloc(vf->item_count * sizeof(hogl_vf_entry));
+
+		if (hogl_file_pread(file, vf->table, vf->item_count * sizeof(hogl_vf_entry), offset) != vf->item_count * sizeof(hogl_vf_entry)) {
+			hogl_log_error("Failed to read item table from %s", path);
+			return HOGL_ERROR_BAD_READ;
+		}
+		offset += vf->item_count * sizeof(hogl_vf_entry);
+	}
+
+	// Plain files keep all data right after the index
+	if ((vf->flags & VF_FLAG_JOURNAL) == 0 && vf->buffer_size != 0) {
+		vf->segments = hogl_malloc(sizeof(hogl_vf_segment));
+		vf->segments[0].offset = 0;
+		vf->segments[0].file_offset = offset;
+		vf->segments[0].size = vf->buffer_size;
+		vf->segment_count = 1;
+		vf->segment_capacity = 1;
+	}
+
+#ifndef HOGL_DISABLE_VF_VERIFY
+	// The index is small so it is always verified
+	if ((vf->flags & VF_FLAG_CHECKSUMS) != 0 && __index_crc(vf) != vf->index_crc) {
+		hogl_log_error("Virtual file %s index checksum mismatch, the file is corrupted", path);
+		return HOGL_ERROR_VF_CHECKSUM;
+	}
+#endif
+
+	// Data is on disk as is so later saves can append to the file
+	__set_persisted(vf, path, (vf->flags & VF_FLAG_CHECKSUMS) != 0 ? vf->buffer_size : 0, file_size);
+	vf->journal = (vf->flags & VF_FLAG_JOURNAL) != 0;
+
+	// The checksum covers the table as stored so swap after verifying
+	if (swap) {
+		__swap_entries(vf->table, vf->item_count);
+
+		// Segments of plain files are not stored
+		if ((vf->flags & VF_FLAG_JOURNAL) != 0) {
+			hogl_byte_swap(vf->segments, vf->segment_count * 3, sizeof(uint64_t));
+		}
+
+		// The index will be written in this machine's byte order
+		vf->flags &= ~VF_FLAG_CHECKSUMS;
+		vf->persisted_size = 0;
+	}
+
+	// Segments have to cover the data in order
+	for (uint64_t i = 0; i < vf->segment_count; i++) {
+		if (vf->segments[i].offset != covered || vf->segments[i].file_offset > file_size || vf->segments[i].size > file_size - vf->segments[i].file_offset) {
+			hogl_log_error("Virtual file %s has an invalid segment map", path);
+			return HOGL_ERROR_BAD_READ;
+		}
+
+		covered += vf->segments[i].size;
+	}
+
+	if (covered != vf->buffer_size) {
+		hogl_log_error("Virtual file %s data is truncated", path);
+		return HOGL_ERROR_BAD_READ;
+	}
+
+	// Every name has to be inside the string table and terminated, every item inside the data
+	for (uint64_t i = 0; i < vf->item_count; i++) {
+		hogl_vf_entry* entry = &vf->table[i];
+
+		if ((uint64_t)entry->name_offset + entry->name_length >= vf->names_size || vf->name_buffer[entry->name_offset + entry->name_length] != '\0') {
+			hogl_log_error("Virtual file %s item %ld has an invalid name", path, i);
+			return HOGL_ERROR_BAD_READ;
+		}
+
+		if (entry->offset > vf->buffer_size || entry->size > vf->buffer_size - entry->offset) {
+			hogl_log_error("Virtual file %s item %ld is outside of the data", path, i);
+			return HOGL_ERROR_BAD_READ;
+		}
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_read(hogl_vf** vf, const char* path) {
+	hogl_file file = HOGL_INVALID_FILE;
+	hogl_error err = HOGL_ERROR_NONE;
+
+	hogl_log_trace("Reading virtual file %s", path);
+
+	file = hogl_file_open(path);
+
+	if (file == HOGL_INVALID_FILE) {
+		hogl_log_error("Failed to open %s", path);
+		perror("Cause: ");
+		return HOGL_ERROR_BAD_PATH;
+	}
+
+	*vf = hogl_vf_new(0, 0);
+
+	if (*vf == NULL) {
+		hogl_file_close(file);
+		return HOGL_ERROR_MEMORY;
+	}
+
+	err = __read_vf_index(*vf, file, path);
+
+	if (err != HOGL_ERROR_NONE) {
+		hogl_file_close(file);
+		hogl_vf_free(*vf);
+		return err;
+	}
+
+	// Read data
+	if ((*vf)->buffer_size != 0) {
+		(*vf)->buffer = hogl_malloc((*vf)->buffer_size);
+
+		if (__read_data(*vf, file, 0, (*vf)->buffer, (*vf)->buffer_size) != HOGL_ERROR_NONE) {
+			hogl_log_error("Failed to read data information from %s", path);
+			hogl_file_close(file);
+			hogl_vf_free(*vf);
+			return HOGL_ERROR_BAD_READ;
+		}
+	}
+
+	// Create mappings
+	hogl_vf_map_vfi((*vf));
+
+	// Close file
+	hogl_file_close(file);
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_open_index(hogl_vf** vf, const char* path) {
+	hogl_file file = HOGL_INVALID_FILE;
+	hogl_error err = HOGL_ERROR_NONE;
+
+	hogl_log_trace("Opening virtual file index %s", path);
+
+	file = hogl_file_open(path);
+
+	if (file == HOGL_INVALID_FILE) {
+		hogl_log_error("Failed to open %s", path);
+		perror("Cause: ");
+		return HOGL_ERROR_BAD_PATH;
+	}
+
+	*vf = hogl_vf_new(0, 0);
+
+	if (*vf == NULL) {
+		hogl_file_close(file);
+		return HOGL_ERROR_MEMORY;
+	}
+
+	err = __read_vf_index(*vf, file, path);
+
+	if (err != HOGL_ERROR_NONE) {
+		hogl_file_close(file);
+		hogl_vf_free(*vf);
+		return err;
+	}
+
+	// Keep the file open for item reads
+	(*vf)->file = file;
+
+	// Create mappings, data pointers stay NULL
+	hogl_vf_map_vfi((*vf));
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_open_mapped(hogl_vf** vf, const char* path) {
+	hogl_error err = HOGL_ERROR_NONE;
+	uint64_t size = 0;
+
+	err = hogl_vf_open_index(vf, path);
+
+	if (err != HOGL_ERROR_NONE) {
+		return err;
+	}
+
+	size = hogl_file_size((*vf)->file);
+	(*vf)->mapping = hogl_file_map((*vf)->file, size);
+
+	if ((*vf)->mapping == NULL) {
+		hogl_log_error("Failed to map %s into memory", path);
+		hogl_vf_free(*vf);
+		return HOGL_ERROR_BAD_READ;
+	}
+
+	(*vf)->mapping_size = size;
+
+	// Point the items into the mapping
+	hogl_vf_map_vfi((*vf));
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_vf* hogl_vf_new(uint32_t version, uint32_t max_name_len) {
+	hogl_vf* vf = hogl_malloc(sizeof(hogl_vf));
+
+	if (vf == NULL) {
+		return NULL;
+	}
+
+	vf->access_mutex = hogl_mutex_new();
+
+	if (vf->access_mutex == NULL) {
+		hogl_free(vf);
+		return NULL;
+	}
+
+	vf->buffer = NULL;
+	vf->name_buffer = NULL;
+	vf->table = NULL;
+	vf->items = NULL;
+	vf->item_count = 0;
+	vf->buffer_size = 0;
+	vf->version = version;
+	vf->max_name_len = max_name_len;
+	vf->names_size = 0;
+	vf->names_capacity = 0;
+	vf->names_live = 0;
+	vf->holes = NULL;
+	vf->hole_count = 0;
+	vf->hole_capacity = 0;
+	vf->holes_ready = false;
+	vf->file = HOGL_INVALID_FILE;
+	vf->segments = NULL;
+	vf->segment_count = 0;
+	vf->segment_capacity = 0;
+	vf->journal = false;
+	vf->persisted_path = NULL;
+	vf->persisted_size = 0;
+	vf->persisted_end = 0;
+	vf->dedup_slots = NULL;
+	vf->dedup_capacity = 0;
+	vf->dedup_count = 0;
+	vf->flags = 0;
+	vf->index_crc = 0;
+	vf->data_crc = 0;
+	vf->verify = true;
+	vf->verified = NULL;
+	vf->verified_size = 0;
+	vf->mapped_items = false;
+	vf->mapping = NULL;
+	vf->mapping_size = 0;
+	vf->record_access = 0;
+	vf->accessed = NULL;
+	vf->access_log = NULL;
+	vf->access_count = 0;
+	vf->access_capacity = 0;
+	return vf;
+}
+
+void hogl_vf_change_name_len(hogl_vf* vf, uint32_t new_name_len) {
+	// Names are only cut off when the limit shrinks, the cut bytes are dropped on save
+	if (new_name_len < vf->max_name_len) {
+		for (uint64_t i = 0; i < vf->item_count; i++) {
+			hogl_vf_entry* entry = &vf->table[i];
+
+			if (entry->name_length > new_name_len) {
+				vf->name_buffer[entry->name_offset + new_name_len] = '\0';
+				vf->names_live -= entry->name_length - new_name_len;
+				entry->name_length = new_name_len;
+				vf->flags &= ~VF_FLAG_CHECKSUMS;
+			}
+		}
+	}
+
+	vf->max_name_len = new_name_len;
+}
+
+hogl_error hogl_vf_add_item(hogl_vf* vf, const char* name, uint32_t type, void* data, uint64_t size) {
+	uint64_t hash = hogl_hash64(data, size, 0);
+	uint64_t offset = vf->buffer_size;
+	uint64_t new_size = vf->buffer_size + size;
+	uint32_t crc = 0;
+	uint32_t name_offset = 0;
+	size_t name_length = strlen(name);
+	size_t existing = 0;
+	size_t hole = 0;
+	bool duplicate = false;
+	bool reuse = false;
+	char* new_data_buffer = NULL;
+	hogl_vf_entry* new_table = NULL;
+
+	if (vf->max_name_len < name_length) {
+		hogl_log_error("Trying to assign name that doesn't fit inside a virtual file");
+		return HOGL_ERROR_BAD_ARGUMENT;
+	}
+
+	if (vf->file != HOGL_INVALID_FILE) {
+		hogl_log_error("Cannot add items to a virtual file opened with hogl_vf_open_index");
+		return HOGL_ERROR_VF_NOT_LOADED;
+	}
+
+	// Check if the same data is already stored
+	if (vf->dedup_slots == NULL && __dedup_build(vf) != HOGL_ERROR_NONE) {
+		hogl_log_error("Failed to build virtual file dedup index");
+		return HOGL_ERROR_MEMORY;
+	}
+
+	if (__dedup_reserve(vf, 1) != HOGL_ERROR_NONE) {
+		hogl_log_error("Failed to expand virtual file dedup index");
+		return HOGL_ERROR_MEMORY;
+	}
+
+	if (!vf->holes_ready && __holes_build(vf) != HOGL_ERROR_NONE) {
+		hogl_log_error("Failed to build virtual file free space map");
+		return HOGL_ERROR_MEMORY;
+	}
+
+	duplicate = __dedup_find(vf, hash, data, size, &existing);
+
+	if (duplicate) {
+		offset = vf->table[existing].offset;
+		crc = vf->table[existing].crc;
+		new_size = vf->buffer_size;
+	}
+	else {
+		crc = hogl_crc32c(0, data, size);
+
+		// Fill a hole left by a removed item
+		reuse = size != 0 && __holes_find(vf, size, &hole);
+
+		if (reuse) {
+			offset = vf->holes[hole].offset;
+			new_size = vf->buffer_size;
+		}
+	}
+
+	// Need to expand memory
+	new_table = hogl_realloc(vf->table, (vf->item_count + 1) * sizeof(hogl_vf_entry));
+	new_data_buffer = new_size != vf->buffer_size ? hogl_realloc(vf->buffer, new_size) : vf->buffer;
+
+	if (new_table != NULL) {
+		vf->table = new_table;
+	}
+
+	if (new_data_buffer != NULL) {
+		vf->buffer = new_data_buffer;
+	}
+
+	if (new_table == NULL || (new_data_buffer == NULL && new_size != 0)) {
+		hogl_log_error("Failed to realloc virtual file buffers");
+		return HOGL_ERROR_MEMORY;
+	}
+
+	// Store name, table entry and data
+	if (__append_name(vf, name, (uint32_t)name_length, &name_offset) != HOGL_ERROR_NONE) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	vf->table[vf->item_count].type = type;
+	vf->table[vf->item_count].flags = VF_ENTRY_HASHED | VF_ENTRY_CHECKSUM | __host_order_flag();
+	vf->table[vf->item_count].size = size;
+	vf->table[vf->item_count].offset = offset;
+	vf->table[vf->item_count].hash = hash;
+	vf->table[vf->item_count].crc = crc;
+	vf->table[vf->item_count].reserved = 0;
+	vf->table[vf->item_count].name_offset = name_offset;
+	vf->table[vf->item_count].name_length = (uint32_t)name_length;
+
+	if (!duplicate) {
+		if (size != 0) {
+			hogl_smemcpy(vf->buffer + offset, data, size);
+		}
+
+		if (reuse) {
+			__holes_consume(vf, hole, size);
+
+			// Data inside the file no longer matches
+			if (offset < vf->persisted_size) {
+				vf->persisted_size = 0;
+			}
+		}
+
+		__dedup_insert(vf, vf->item_count);
+	}
+
+	vf->item_count++;
+	vf->buffer_size = new_size;
+	__verified_grow(vf);
+
+	// File checksums no longer describe the contents
+	vf->flags &= ~VF_FLAG_CHECKSUMS;
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_remove_item(hogl_vf* vf, size_t index) {
+	hogl_vf_entry removed;
+	bool shared = false;
+
+	if (vf->item_count <= index) {
+		hogl_log_warn("Tried to access invalid virtual file item");
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+
+	if (vf->file != HOGL_INVALID_FILE) {
+		hogl_log_error("Cannot remove items from a virtual file opened with hogl_vf_open_index");
+		return HOGL_ERROR_VF_NOT_LOADED;
+	}
+
+	if (!vf->holes_ready && __holes_build(vf) != HOGL_ERROR_NONE) {
+		hogl_log_error("Failed to build virtual file free space map");
+		return HOGL_ERROR_MEMORY;
+	}
+
+	removed = vf->table[index];
+
+	// Deduplicated data stays while another item uses it
+	for (uint64_t i = 0; i < vf->item_count && !shared; i++) {
+		shared = i != index && vf->table[i].size != 0 && vf->table[i].offset == removed.offset;
+	}
+
+	if (!shared && removed.size != 0 && __holes_insert(vf, removed.offset, removed.size) != HOGL_ERROR_NONE) {
+		hogl_log_error("Failed to expand virtual file free space map");
+		return HOGL_ERROR_MEMORY;
+	}
+
+	// Keep the order of the remaining items
+	memmove(&vf->table[index], &vf->table[index + 1], (vf->item_count - index - 1) * sizeof(hogl_vf_entry));
+	vf->item_count--;
+	vf->names_live -= removed.name_length + 1;
+
+	// Verified flags follow their items, the freed flag at the end belongs to the next new item
+	if (index < vf->verified_size) {
+		memmove(&vf->verified[index], &vf->verified[index + 1], vf->verified_size - index - 1);
+		vf->verified[vf->verified_size - 1] = 0;
+	}
+
+	// Entry indices changed so the dedup index is rebuilt on the next add
+	hogl_free(vf->dedup_slots);
+	vf->dedup_slots = NULL;
+	vf->dedup_capacity = 0;
+	vf->dedup_count = 0;
+
+	vf->flags &= ~VF_FLAG_CHECKSUMS;
+
+	if (vf->items != NULL) {
+		hogl_vf_map_vfi(vf);
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_compact(hogl_vf* vf) {
+	hogl_vf_span* runs = NULL;
+	uint64_t* targets = NULL;
+	size_t count = 0;
+	size_t run_count = 0;
+	uint64_t cursor = 0;
+	char* new_data_buffer = NULL;
+
+	if (vf->file != HOGL_INVALID_FILE) {
+		hogl_log_error("Cannot compact a virtual file opened with hogl_vf_open_index");
+		return HOGL_ERROR_VF_NOT_LOADED;
+	}
+
+	if (__compact_names(vf) != HOGL_ERROR_NONE) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	if (vf->item_count != 0) {
+		runs = __sorted_spans(vf, &count);
+		targets = hogl_malloc((count + 1) * sizeof(uint64_t));
+
+		if (runs == NULL || targets == NULL) {
+			hogl_log_error("Failed to allocate virtual file compaction buffers");
+			hogl_free(runs);
+			hogl_free(targets);
+			return HOGL_ERROR_MEMORY;
+		}
+	}
+
+	// Merge adjacent items into runs, each run is slid down with a single move
+	for (size_t i = 0; i < count;) {
+		uint64_t run_start = runs[i].offset;
+		uint64_t run_end = runs[i].offset + runs[i].size;
+
+		for (i++; i < count && runs[i].offset <= run_end; i++) {
+			if (runs[i].offset + runs[i].size > run_end) {
+				run_end = runs[i].offset + runs[i].size;
+			}
+		}
+
+		if (run_start != cursor) {
+			memmove(vf->buffer + cursor, vf->buffer + run_start, run_end - run_start);
+		}
+
+		runs[run_count].offset = run_start;
+		runs[run_count].size = run_end - run_start;
+		targets[run_count] = cursor;
+		run_count++;
+
+		cursor += run_end - run_start;
+	}
+
+	// Move every entry along with its run
+	for (uint64_t i = 0; i < vf->item_count; i++) {
+		hogl_vf_entry* entry = &vf->table[i];
+		size_t lo = 0;
+		size_t hi = run_count;
+
+		if (entry->size == 0) {
+			entry->offset = 0;
+			continue;
+		}
+
+		while (hi - lo > 1) {
+			size_t mid = (lo + hi) / 2;
+
+			if (runs[mid].offset <= entry->offset) {
+				lo = mid;
+			}
+			else {
+				hi = mid;
+			}
+		}
+
+		entry->offset = targets[lo] + (entry->offset - runs[lo].offset);
+	}
+
+	hogl_free(runs);
+	hogl_free(targets);
+
+	if (cursor != vf->buffer_size) {
+		vf->buffer_size = cursor;
+		vf->flags &= ~VF_FLAG_CHECKSUMS;
+
+		// Data moved so the next save has to rewrite the file
+		vf->persisted_size = 0;
+
+		// If shrinking fails the old buffer is still valid
+		new_data_buffer = cursor != 0 ? hogl_realloc(vf->buffer, cursor) : NULL;
+
+		if (new_data_buffer != NULL) {
+			vf->buffer = new_data_buffer;
+		}
+	}
+
+	vf->hole_count = 0;
+	vf->holes_ready = true;
+
+	if (vf->items != NULL) {
+		hogl_vf_map_vfi(vf);
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+uint64_t __entry_hash(hogl_vf* vf, size_t index) {
+	hogl_vf_entry* entry = &vf->table[index];
+	return (entry->flags & VF_ENTRY_HASHED) != 0 ? entry->hash : hogl_hash64(vf->buffer + entry->offset, entry->size, 0);
+}
+
+uint64_t __fingerprint_entry(hogl_vf* vf, size_t index) {
+	hogl_vf_entry* entry = &vf->table[index];
+	uint64_t seed = __entry_hash(vf, index) ^ entry->size ^ ((uint64_t)entry->type << 32);
+
+	return hogl_hash64(vf->name_buffer + entry->name_offset, entry->name_length, seed);
+}
+
+uint64_t __fingerprint(hogl_vf* vf) {
+	uint64_t fingerprint = 0;
+
+	// Sum of per item hashes so the item order doesn't matter
+	for (uint64_t i = 0; i < vf->item_count; i++) {
+		fingerprint += __fingerprint_entry(vf, (size_t)i);
+	}
+
+	return fingerprint;
+}
+
+hogl_error __names_build(hogl_vf* vf, size_t** slots, size_t* capacity, bool* unique) {
+	(*capacity) = 64;
+	(*unique) = true;
+
+	while ((*capacity) < vf->item_count * 2) {
+		(*capacity) *= 2;
+	}
+
+	(*slots) = hogl_malloc((unsigned int)((*capacity) * sizeof(size_t)));
+
+	if ((*slots) == NULL) {
+		hogl_log_error("Failed to allocate virtual file name index");
+		return HOGL_ERROR_MEMORY;
+	}
+
+	hogl_memset((*slots), 0xFF, (*capacity) * sizeof(size_t));
+
+	for (uint64_t i = 0; i < vf->item_count; i++) {
+		hogl_vf_entry* entry = &vf->table[i];
+		size_t slot = (size_t)hogl_hash64(vf->name_buffer + entry->name_offset, entry->name_length, 0) & ((*capacity) - 1);
+
+		while ((*slots)[slot] != VF_DEDUP_EMPTY) {
+			hogl_vf_entry* other = &vf->table[(*slots)[slot]];
+
+			if (other->name_length == entry->name_length &&
+				memcmp(vf->name_buffer + other->name_offset, vf->name_buffer + entry->name_offset, entry->name_length) == 0) {
+				(*unique) = false;
+			}
+
+			slot = (slot + 1) & ((*capacity) - 1);
+		}
+
+		(*slots)[slot] = (size_t)i;
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+bool __names_find(hogl_vf* vf, size_t* slots, size_t capacity, const char* name, uint32_t length, size_t* found) {
+	size_t slot = (size_t)hogl_hash64(name, length, 0) & (capacity - 1);
+
+	while (slots[slot] != VF_DEDUP_EMPTY) {
+		hogl_vf_entry* entry = &vf->table[slots[slot]];
+
+		if (entry->name_length == length && memcmp(vf->name_buffer + entry->name_offset, name, length) == 0) {
+			(*found) = slots[slot];
+			return true;
+		}
+
+		slot = (slot + 1) & (capacity - 1);
+	}
+
+	return false;
+}
+
+int __index_compare_desc(const void* a, const void* b) {
+	size_t ia = *(const size_t*)a;
+	size_t ib = *(const size_t*)b;
+	return ia < ib ? 1 : (ia > ib ? -1 : 0);
+}
+
+// Finds items edited through pointers returned by hogl_vf_map_item, their checksums, hashes and persisted data are stale
+void __refresh_mapped_items(hogl_vf* vf) {
+	bool changed = false;
+
+	if (!vf->mapped_items || vf->buffer == NULL) {
+		return;
+	}
+
+	for (uint64_t i = 0; i < vf->item_count; i++) {
+		hogl_vf_entry* entry = &vf->table[i];
+		uint32_t crc = hogl_crc32c(0, vf->buffer + entry->offset, entry->size);
+
+		// Items without a checksum can't be compared so they are treated as edited
+		if ((entry->flags & VF_ENTRY_CHECKSUM) != 0 && crc == entry->crc) {
+			continue;
+		}
+
+		entry->crc = crc;
+		entry->flags = (entry->flags & ~VF_ENTRY_HASHED) | VF_ENTRY_CHECKSUM;
+		changed = true;
+
+		if (entry->offset < vf->persisted_size) {
+			vf->persisted_size = 0;
+		}
+	}
+
+	if (!changed) {
+		return;
+	}
+
+	// Hashes changed so the dedup index is rebuilt on the next add
+	hogl_free(vf->dedup_slots);
+	vf->dedup_slots = NULL;
+	vf->dedup_capacity = 0;
+	vf->dedup_count = 0;
+
+	vf->flags &= ~VF_FLAG_CHECKSUMS;
+}
+
+hogl_error hogl_vf_diff(hogl_vf* base, hogl_vf* target, hogl_vf** patch) {
+	hogl_vf* result = NULL;
+	hogl_vf_patch_header header;
+	size_t* slots = NULL;
+	size_t* target_slots = NULL;
+	size_t capacity = 0;
+	size_t target_capacity = 0;
+	bool unique = false;
+	bool target_unique = false;
+	uint8_t* matched = NULL;
+	char* info = NULL;
+	uint64_t info_size = sizeof(hogl_vf_patch_header);
+	uint64_t cursor = 0;
+	hogl_error error = HOGL_ERROR_NONE;
+
+	if (base->file != HOGL_INVALID_FILE || target->file != HOGL_INVALID_FILE) {
+		hogl_log_error("Cannot diff virtual files opened with hogl_vf_open_index");
+		return HOGL_ERROR_VF_NOT_LOADED;
+	}
+
+	// Items are compared by hash
+	__refresh_mapped_items(base);
+	__refresh_mapped_items(target);
+
+	matched = hogl_malloc((unsigned int)base->item_count + 1);
+
+	if (matched == NULL || __names_build(base, &slots, &capacity, &unique) != HOGL_ERROR_NONE ||
+		__names_build(target, &target_slots, &target_capacity, &target_unique) != HOGL_ERROR_NONE) {
+		hogl_free(matched);
+		hogl_free(slots);
+		return HOGL_ERROR_MEMORY;
+	}
+
+	hogl_free(target_slots);
+
+	// Items are matched by name
+	if (!unique || !target_unique) {
+		hogl_log_error("Cannot diff virtual files with duplicate item names");
+		hogl_free(matched);
+		hogl_free(slots);
+		return HOGL_ERROR_BAD_ARGUMENT;
+	}
+
+	hogl_memset(matched, 0, base->item_count + 1);
+	result = hogl_vf_new(target->version, target->max_name_len > sizeof(VF_PATCH_NAME) ? target->max_name_len : sizeof(VF_PATCH_NAME));
+
+	if (result == NULL) {
+		hogl_free(matched);
+		hogl_free(slots);
+		return HOGL_ERROR_MEMORY;
+	}
+
+	// Changed and new items
+	for (uint64_t i = 0; i < target->item_count && error == HOGL_ERROR_NONE; i++) {
+		hogl_vf_entry* entry = &target->table[i];
+		const char* name = target->name_buffer + entry->name_offset;
+		size_t found = VF_DEDUP_EMPTY;
+
+		if (__names_find(base, slots, capacity, name, entry->name_length, &found)) {
+			hogl_vf_entry* old = &base->table[found];
+
+			matched[found] = 1;
+
+			if (old->type == entry->type && old->size == entry->size &&
+				(old->flags & VF_ENTRY_BIG_ENDIAN) == (entry->flags & VF_ENTRY_BIG_ENDIAN) &&
+				__entry_hash(base, found) == __entry_hash(target, (size_t)i) &&
+				(entry->size == 0 || memcmp(base->buffer + old->offset, target->buffer + entry->offset, entry->size) == 0)) {
+				continue;
+			}
+		}
+
+		error = hogl_vf_add_item(result, name, entry->type, target->buffer + entry->offset, entry->size);
+
+		// Keep the byte order the data was written in
+		if (error == HOGL_ERROR_NONE) {
+			result->table[result->item_count - 1].flags &= ~VF_ENTRY_BIG_ENDIAN;
+			result->table[result->item_count - 1].flags |= entry->flags & VF_ENTRY_BIG_ENDIAN;
+		}
+	}
+
+	// Removed items
+	header.magic = VF_PATCH_MAGIC;
+	header.base_version = base->version;
+	header.base_fingerprint = __fingerprint(base);
+	header.target_fingerprint = __fingerprint(target);
+	header.removed_count = 0;
+
+	for (uint64_t i = 0; i < base->item_count; i++) {
+		if (!matched[i]) {
+			info_size += base->table[i].name_length + 1;
+			header.removed_count++;
+		}
+	}
+
+	info = error == HOGL_ERROR_NONE ? hogl_malloc((unsigned int)info_size) : NULL;
+
+	if (info != NULL) {
+		hogl_smemcpy(info, &header, sizeof(hogl_vf_patch_header));
+		cursor = sizeof(hogl_vf_patch_header);
+
+		for (uint64_t i = 0; i < base->item_count; i++) {
+			if (!matched[i]) {
+				hogl_smemcpy(info + cursor, base->name_buffer + base->table[i].name_offset, base->table[i].name_length + 1);
+				cursor += base->table[i].name_length + 1;
+			}
+		}
+
+		error = hogl_vf_add_item(result, VF_PATCH_NAME, VF_PATCH_TYPE, info, info_size);
+	}
+	else if (error == HOGL_ERROR_NONE) {
+		hogl_log_error("Failed to allocate patch information");
+		error = HOGL_ERROR_MEMORY;
+	}
+
+	hogl_free(info);
+	hogl_free(matched);
+	hogl_free(slots);
+
+	if (error != HOGL_ERROR_NONE) {
+		hogl_vf_free(result);
+		return error;
+	}
+
+	hogl_log_trace("Patch has %ld changed items and %ld removed items", result->item_count - 1, header.removed_count);
+
+	(*patch) = result;
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_apply_patch(hogl_vf* vf, hogl_vf* patch) {
+	hogl_vf_patch_header header;
+	hogl_vf_entry* info_entry = NULL;
+	const char* info = NULL;
+	const char* names = NULL;
+	size_t* slots = NULL;
+	size_t* replaced = NULL;
+	size_t* removed = NULL;
+	size_t capacity = 0;
+	size_t removed_count = 0;
+	size_t change_count = 0;
+	uint64_t base_count = vf->item_count;
+	uint64_t fingerprint = 0;
+	bool unique = false;
+	bool mapped = vf->items != NULL;
+	uint64_t cursor = 0;
+	hogl_error error = HOGL_ERROR_NONE;
+
+	if (vf->file != HOGL_INVALID_FILE || patch->file != HOGL_INVALID_FILE) {
+		hogl_log_error("Cannot patch virtual files opened with hogl_vf_open_index");
+		return HOGL_ERROR_VF_NOT_LOADED;
+	}
+
+	if (patch->item_count == 0) {
+		hogl_log_error("Virtual file is not a patch");
+		return HOGL_ERROR_BAD_ARGUMENT;
+	}
+
+	info_entry = &patch->table[patch->item_count - 1];
+	info = patch->buffer + info_entry->offset;
+
+	if (info_entry->type != VF_PATCH_TYPE || info_entry->size < sizeof(hogl_vf_patch_header) ||
+		strcmp(patch->name_buffer + info_entry->name_offset, VF_PATCH_NAME) != 0) {
+		hogl_log_error("Virtual file is not a patch");
+		return HOGL_ERROR_BAD_ARGUMENT;
+	}
+
+	// Patch data is checked up front so a corrupted patch doesn't leave the virtual file half patched
+	for (uint64_t i = 0; i < patch->item_count; i++) {
+		if (__verify_item(patch, (size_t)i, patch->buffer + patch->table[i].offset) != HOGL_ERROR_NONE) {
+			return HOGL_ERROR_VF_CHECKSUM;
+		}
+	}
+
+	hogl_smemcpy(&header, info, sizeof(hogl_vf_patch_header));
+
+	if ((info_entry->flags & VF_ENTRY_BIG_ENDIAN) != __host_order_flag()) {
+		hogl_byte_swap(&header.magic, 2, sizeof(uint32_t));
+		hogl_byte_swap(&header.base_fingerprint, 3, sizeof(uint64_t));
+	}
+
+	if (header.magic != VF_PATCH_MAGIC) {
+		hogl_log_error("Virtual file is not a patch");
+		return HOGL_ERROR_BAD_ARGUMENT;
+	}
+
+	fingerprint = __fingerprint(vf);
+
+	if (header.base_version != vf->version || header.base_fingerprint != fingerprint) {
+		hogl_log_error("Patch was made for a different virtual file");
+		return HOGL_ERROR_VF_PATCH_MISMATCH;
+	}
+
+	// Removed names have to be inside the patch information
+	names = info + sizeof(hogl_vf_patch_header);
+	cursor = sizeof(hogl_vf_patch_header);
+
+	for (uint64_t i = 0; i < header.removed_count; i++) {
+		const char* end = cursor < info_entry->size ? memchr(info + cursor, '\0', (size_t)(info_entry->size - cursor)) : NULL;
+
+		if (end == NULL) {
+			hogl_log_error("Patch information is truncated");
+			return HOGL_ERROR_BAD_READ;
+		}
+
+		cursor = (uint64_t)(end - info) + 1;
+	}
+
+	if (__names_build(vf, &slots, &capacity, &unique) != HOGL_ERROR_NONE) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	// The fingerprint is a sum of item hashes so the result is known before the virtual file is touched
+	for (uint64_t i = 0; i + 1 < patch->item_count; i++) {
+		hogl_vf_entry* entry = &patch->table[i];
+		size_t found = VF_DEDUP_EMPTY;
+
+		if (__names_find(vf, slots, capacity, patch->name_buffer + entry->name_offset, entry->name_length, &found)) {
+			fingerprint -= __fingerprint_entry(vf, found);
+		}
+
+		fingerprint += __fingerprint_entry(patch, (size_t)i);
+	}
+
+	for (uint64_t i = 0; i < header.removed_count; i++) {
+		size_t length = strlen(names);
+		size_t found = VF_DEDUP_EMPTY;
+
+		if (__names_find(vf, slots, capacity, names, (uint32_t)length, &found)) {
+			fingerprint -= __fingerprint_entry(vf, found);
+		}
+
+		names += length + 1;
+	}
+
+	names = info + sizeof(hogl_vf_patch_header);
+
+	if (fingerprint != header.target_fingerprint) {
+		hogl_log_error("Patched virtual file wouldn't match the patch target");
+		hogl_free(slots);
+		return HOGL_ERROR_VF_PATCH_MISMATCH;
+	}
+
+	replaced = hogl_malloc((unsigned int)(patch->item_count * sizeof(size_t)));
+	removed = hogl_malloc((unsigned int)((patch->item_count + header.removed_count) * sizeof(size_t)));
+
+	if (replaced == NULL || removed == NULL) {
+		hogl_log_error("Failed to allocate patch buffers");
+		hogl_free(slots);
+		hogl_free(replaced);
+		hogl_free(removed);
+		return HOGL_ERROR_MEMORY;
+	}
+
+	if (patch->max_name_len > vf->max_name_len) {
+		vf->max_name_len = patch->max_name_len;
+	}
+
+	// The item mapping is rebuilt once at the end instead of after every change
+	hogl_free(vf->items);
+	vf->items = NULL;
+
+	// All items are added before anything is removed so the new data can't land in a hole inside data
+	// that is already in the file, a journaled save then only appends the changed items
+	for (uint64_t i = 0; i + 1 < patch->item_count && error == HOGL_ERROR_NONE; i++) {
+		hogl_vf_entry* entry = &patch->table[i];
+		size_t found = VF_DEDUP_EMPTY;
+
+		replaced[change_count++] = __names_find(vf, slots, capacity, patch->name_buffer + entry->name_offset,
+			entry->name_length, &found) ? found : VF_DEDUP_EMPTY;
+
+		error = hogl_vf_add_item(vf, patch->name_buffer + entry->name_offset, entry->type, patch->buffer + entry->offset, entry->size);
+
+		if (error == HOGL_ERROR_NONE) {
+			vf->table[vf->item_count - 1].flags &= ~VF_ENTRY_BIG_ENDIAN;
+			vf->table[vf->item_count - 1].flags |= entry->flags & VF_ENTRY_BIG_ENDIAN;
+		}
+	}
+
+	// Changed items take the place of the old ones so item indices stay the same, the old entries are removed
+	for (size_t i = 0; i < change_count && error == HOGL_ERROR_NONE; i++) {
+		if (replaced[i] != VF_DEDUP_EMPTY) {
+			hogl_vf_entry swap = vf->table[replaced[i]];
+			vf->table[replaced[i]] = vf->table[base_count + i];
+			vf->table[base_count + i] = swap;
+			removed[removed_count++] = (size_t)base_count + i;
+
+			// The slot holds new data now
+			if (replaced[i] < vf->verified_size) {
+				vf->verified[replaced[i]] = 0;
+			}
+		}
+	}
+
+	for (uint64_t i = 0; i < header.removed_count && error == HOGL_ERROR_NONE; i++) {
+		size_t length = strlen(names);
+		size_t found = VF_DEDUP_EMPTY;
+
+		if (__names_find(vf, slots, capacity, names, (uint32_t)length, &found)) {
+			removed[removed_count++] = found;
+		}
+
+		names += length + 1;
+	}
+
+	// Dedup slots point at entries that were swapped
+	hogl_free(vf->dedup_slots);
+	vf->dedup_slots = NULL;
+	vf->dedup_capacity = 0;
+	vf->dedup_count = 0;
+
+	qsort(removed, removed_count, sizeof(size_t), __index_compare_desc);
+
+	for (size_t i = 0; i < removed_count && error == HOGL_ERROR_NONE; i++) {
+		error = hogl_vf_remove_item(vf, removed[i]);
+	}
+
+	hogl_free(slots);
+	hogl_free(replaced);
+	hogl_free(removed);
+
+	if (mapped) {
+		hogl_vf_map_vfi(vf);
+	}
+
+	if (error != HOGL_ERROR_NONE) {
+		hogl_log_error("Failed to apply patch, the virtual file is partially patched");
+		return error;
+	}
+
+	vf->version = patch->version;
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_rename_item(hogl_vf* vf, size_t index, const char* new_name)
+{
+	if (vf->item_count <= index) {
+		hogl_log_warn("Tried to access invalid virtual file item");
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+
+	uint32_t name_offset = 0;
+	size_t name_length = strlen(new_name);
+
+	if (vf->max_name_len < name_length) {
+		hogl_log_error("Name %s cannot be assigned cause length &ld exceeds the max name length %ld of virtual file", new_name, name_length, vf->max_name_len)
+		return HOGL_ERROR_MEMORY;
+	}
+
+	if (vf->items == NULL) {
+		hogl_log_warn("Ignoring unmapped virtual file item change");
+		return HOGL_ERROR_VF_VFI_MAP;
+	}
+
+	// The new name is appended, the original one stays in the string table until the next save
+	if (__append_name(vf, new_name, (uint32_t)name_length, &name_offset) != HOGL_ERROR_NONE) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	vf->names_live -= vf->table[index].name_length + 1;
+	vf->table[index].name_offset = name_offset;
+	vf->table[index].name_length = (uint32_t)name_length;
+
+	vf->flags &= ~VF_FLAG_CHECKSUMS;
+
+	return HOGL_ERROR_NONE;
+}
+
+void hogl_vf_map_vfi(hogl_vf* vf) {
+	if (vf->items != NULL) {
+		hogl_free(vf->items);
+		vf->items = NULL;
+	}
+
+	if (vf->verified != NULL) {
+		hogl_free(vf->verified);
+		vf->verified = NULL;
+		vf->verified_size = 0;
+	}
+
+	if (vf->item_count == 0) {
+		return;
+	}
+
+	vf->items = hogl_malloc(sizeof(hogl_vfi) * vf->item_count);
+	vf->verified = hogl_malloc(vf->item_count);
+	vf->verified_size = vf->item_count;
+	hogl_memset(vf->verified, 0, vf->item_count);
+
+	for (uint64_t i = 0; i < vf->item_count; i++) {
+		hogl_vfi* ivfi = &vf->items[i];
+
+		ivfi->type = &vf->table[i].type;
+		ivfi->data_length = &vf->table[i].size;
+
+		// Data is not loaded for index only virtual files, mapped files point into the mapping
+		ivfi->data = vf->buffer != NULL ? vf->buffer + vf->table[i].offset : __mapped_data(vf, vf->table[i].offset, vf->table[i].size);
+	}
+}
+
+void __fill_header(hogl_vf* vf, char* header_buffer) {
+	char* header_bp = header_buffer;
+
+	*(uint32_t*)header_bp = VF_FORMAT_REVISION;
+	header_bp += sizeof(uint32_t);
+	*(uint32_t*)header_bp = vf->version;
+	header_bp += sizeof(uint32_t);
+	*(uint64_t*)header_bp = vf->item_count;
+	header_bp += sizeof(uint64_t);
+	*(uint64_t*)header_bp = vf->buffer_size;
+	header_bp += sizeof(uint64_t);
+	*(uint64_t*)header_bp = vf->names_size;
+	header_bp += sizeof(uint64_t);
+	*(uint32_t*)header_bp = vf->max_name_len;
+	header_bp += sizeof(uint32_t);
+	*(uint32_t*)header_bp = vf->flags;
+	header_bp += sizeof(uint32_t);
+	*(uint32_t*)header_bp = vf->index_crc;
+	header_bp += sizeof(uint32_t);
+	*(uint32_t*)header_bp = vf->data_crc;
+}
+
+hogl_error __write_names_and_table(hogl_vf* vf, FILE* fp, const char* path) {
+	// Write string table
+	if (vf->names_size != 0 && fwrite(vf->name_buffer, vf->names_size, 1, fp) != 1) {
+		hogl_log_error("Failed to write name information to %s", path);
+		return HOGL_ERROR_BAD_WRITE;
+	}
+
+	// Write item table
+	if (vf->item_count != 0 && fwrite(vf->table, vf->item_count * sizeof(hogl_vf_entry), 1, fp) != 1) {
+		hogl_log_error("Failed to write item table to %s", path);
+		return HOGL_ERROR_BAD_WRITE;
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error __save_full(hogl_vf* vf, const char* path) {
+	FILE* fp = NULL;
+	uint32_t echeck = ENDIAN_CHECK_VAL;
+	uint64_t data_start = 0;
+	size_t rsize = 0;
+	char header_buffer[VF_HEADER_LEN];
+
+	fp = fopen(path, "wb");
+
+	if (fp == NULL) {
+		hogl_log_error("Failed to open %s", path);
+		perror("Cause: ");
+		return HOGL_ERROR_BAD_PATH;
+	}
+
+	// Endian check
+	rsize = fwrite(&echeck, sizeof(uint32_t), 1, fp);
+
+	if (rsize != 1) {
+		hogl_log_error("Failed to write endian information to %s", path);
+		fclose(fp);
+		return HOGL_ERROR_BAD_WRITE;
+	}
+
+	// Drop names left behind by renames
+	if (__compact_names(vf) != HOGL_ERROR_NONE) {
+		fclose(fp);
+		return HOGL_ERROR_MEMORY;
+	}
+
+	// Checksums, the data checksum is still valid if nothing changed since the file was read
+	if ((vf->flags & VF_FLAG_CHECKSUMS) == 0) {
+		vf->data_crc = vf->buffer_size != 0 ? hogl_crc32c(0, vf->buffer, vf->buffer_size) : 0;
+	}
+	vf->flags &= ~VF_FLAG_JOURNAL;
+	vf->index_crc = __index_crc(vf);
+	vf->flags |= VF_FLAG_CHECKSUMS;
+
+	// Header
+	__fill_header(vf, header_buffer);
+
+	rsize = fwrite(header_buffer, VF_HEADER_LEN, 1, fp);
+
+	if (rsize != 1) {
+		hogl_log_error("Failed to write header information to %s", path);
+		fclose(fp);
+		return HOGL_ERROR_BAD_WRITE;
+	}
+
+	if (__write_names_and_table(vf, fp, path) != HOGL_ERROR_NONE) {
+		fclose(fp);
+		return HOGL_ERROR_BAD_WRITE;
+	}
+
+	// Write data
+	if (vf->buffer_size != 0) {
+		rsize = fwrite(vf->buffer, vf->buffer_size, 1, fp);
+
+		if (rsize != 1) {
+			hogl_log_error("Failed to write data information to %s", path);
+			fclose(fp);
+			return HOGL_ERROR_BAD_WRITE;
+		}
+	}
+
+	// Close file
+	fclose(fp);
+
+	// All data is now in a single segment after the index
+	data_start = sizeof(uint32_t) + VF_HEADER_LEN + vf->names_size + vf->item_count * sizeof(hogl_vf_entry);
+	vf->segment_count = 0;
+
+	if (vf->buffer_size != 0 && __reserve_segments(vf, 1) == HOGL_ERROR_NONE) {
+		vf->segments[0].offset = 0;
+		vf->segments[0].file_offset = data_start;
+		vf->segments[0].size = vf->buffer_size;
+		vf->segment_count = 1;
+	}
+
+	__set_persisted(vf, path, vf->buffer_size, data_start + vf->buffer_size);
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error __save_journal(hogl_vf* vf, const char* path) {
+	FILE* fp = NULL;
+	uint64_t append_size = vf->buffer_size - vf->persisted_size;
+	uint64_t index_offset = vf->persisted_end + append_size;
+	uint64_t footer[2];
+	uint32_t first_flags = 0;
+	char header_buffer[VF_HEADER_LEN];
+
+	if (__reserve_segments(vf, vf->segment_count + 1) != HOGL_ERROR_NONE || __compact_names(vf) != HOGL_ERROR_NONE) {
+		hogl_log_error("Failed to prepare journal save of %s", path);
+		return HOGL_ERROR_MEMORY;
+	}
+
+	fp = fopen(path, "ab");
+
+	if (fp == NULL) {
+		hogl_log_error("Failed to open %s", path);
+		perror("Cause: ");
+		return HOGL_ERROR_BAD_PATH;
+	}
+
+	// New data
+	if (append_size != 0) {
+		if (fwrite(vf->buffer + vf->persisted_size, append_size, 1, fp) != 1) {
+			hogl_log_error("Failed to append data to %s", path);
+			fclose(fp);
+			return HOGL_ERROR_BAD_WRITE;
+		}
+
+		vf->segments[vf->segment_count].offset = vf->persisted_size;
+		vf->segments[vf->segment_count].file_offset = vf->persisted_end;
+		vf->segments[vf->segment_count].size = append_size;
+		vf->segment_count++;
+	}
+
+	// CRC32C can be continued so only the new data is checksummed
+	if ((vf->flags & VF_FLAG_CHECKSUMS) == 0) {
+		vf->data_crc = hogl_crc32c(vf->data_crc, vf->buffer + vf->persisted_size, append_size);
+	}
+	vf->flags |= VF_FLAG_JOURNAL;
+	vf->index_crc = __index_crc(vf);
+	vf->flags |= VF_FLAG_CHECKSUMS;
+
+	// Index block
+	__fill_header(vf, header_buffer);
+
+	if (fwrite(header_buffer, VF_HEADER_LEN, 1, fp) != 1 ||
+		fwrite(&vf->segment_count, sizeof(uint64_t), 1, fp) != 1 ||
+		(vf->segment_count != 0 && fwrite(vf->segments, vf->segment_count * sizeof(hogl_vf_segment), 1, fp) != 1)) {
+		hogl_log_error("Failed to append index to %s", path);
+		fclose(fp);
+		return HOGL_ERROR_BAD_WRITE;
+	}
+
+	if (__write_names_and_table(vf, fp, path) != HOGL_ERROR_NONE) {
+		fclose(fp);
+		return HOGL_ERROR_BAD_WRITE;
+	}
+
+	// Footer goes last so a save that didn't finish fails the magic check instead of reading a partial index
+	footer[0] = index_offset;
+	footer[1] = VF_JOURNAL_MAGIC;
+
+	if (fwrite(footer, VF_FOOTER_LEN, 1, fp) != 1) {
+		hogl_log_error("Failed to append journal footer to %s", path);
+		fclose(fp);
+		return HOGL_ERROR_BAD_WRITE;
+	}
+
+	fclose(fp);
+
+	// The first save of a plain file marks it as journaled, this is the only write that is not an append
+	fp = fopen(path, "r+b");
+
+	if (fp == NULL || fseek(fp, VF_FLAGS_POSITION, SEEK_SET) != 0 || fread(&first_flags, sizeof(uint32_t), 1, fp) != 1) {
+		hogl_log_error("Failed to read flags of %s", path);
+		if (fp != NULL) {
+			fclose(fp);
+		}
+		return HOGL_ERROR_BAD_READ;
+	}
+
+	if ((first_flags & VF_FLAG_JOURNAL) == 0) {
+		first_flags |= VF_FLAG_JOURNAL;
+
+		if (fseek(fp, VF_FLAGS_POSITION, SEEK_SET) != 0 || fwrite(&first_flags, sizeof(uint32_t), 1, fp) != 1) {
+			hogl_log_error("Failed to mark %s as journaled", path);
+			fclose(fp);
+			return HOGL_ERROR_BAD_WRITE;
+		}
+	}
+
+	fclose(fp);
+
+	vf->persisted_size = vf->buffer_size;
+	vf->persisted_end = index_offset + VF_HEADER_LEN + sizeof(uint64_t) + vf->segment_count * sizeof(hogl_vf_segment) +
+		vf->names_size + vf->item_count * sizeof(hogl_vf_entry) + VF_FOOTER_LEN;
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_save(hogl_vf* vf, const char* path) {
+	hogl_file file = HOGL_INVALID_FILE;
+	uint64_t file_size = 0;
+
+	hogl_log_trace("Saving virtual file to %s", path);
+
+	if (vf->file != HOGL_INVALID_FILE) {
+		hogl_log_error("Cannot save a virtual file opened with hogl_vf_open_index");
+		return HOGL_ERROR_VF_NOT_LOADED;
+	}
+
+	__refresh_mapped_items(vf);
+
+	// Append only if the file is still exactly what was read or saved last time
+	if (vf->journal && vf->persisted_size != 0 && vf->persisted_path != NULL && strcmp(vf->persisted_path, path) == 0) {
+		file = hogl_file_open(path);
+
+		if (file != HOGL_INVALID_FILE) {
+			file_size = hogl_file_size(file);
+			hogl_file_close(file);
+
+			if (file_size == vf->persisted_end) {
+				return __save_journal(vf, path);
+			}
+
+			hogl_log_warn("Virtual file %s changed on disk, rewriting it", path);
+		}
+	}
+
+	return __save_full(vf, path);
+}
+
+void hogl_vf_set_journal(hogl_vf* vf, bool enabled) {
+	vf->journal = enabled;
+}
+
+hogl_error hogl_vf_get_item_index(hogl_vf* vf, const char* name, size_t* index) {
+	size_t name_length = strlen(name);
+
+	if (vf->items == NULL) {
+		hogl_log_warn("Ignoring unmapped virtual file item change");
+		return HOGL_ERROR_VF_VFI_MAP;
+	}
+
+	// Lengths are inside the item table so most items are rejected without touching the string table
+	for (*index = 0; *index < vf->item_count; (*index)++) {
+		hogl_vf_entry* entry = &vf->table[*index];
+
+		if (entry->name_length == name_length && memcmp(name, vf->name_buffer + entry->name_offset, name_length) == 0) {
+			return HOGL_ERROR_NONE;
+		}
+	}
+
+	return HOGL_ERROR_VF_BAD_NAME;
+}
+
+size_t hogl_vf_item_count(hogl_vf* vf) {
+	return (size_t)vf->item_count;
+}
+
+hogl_error hogl_vf_item_name(hogl_vf* vf, size_t index, const char** target) {
+	if (vf->item_count <= index) {
+		hogl_log_warn("Tried to access invalid virtual file item");
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+
+	(*target) = vf->name_buffer + vf->table[index].name_offset;
+
+	return HOGL_ERROR_NONE;
+}
+
+uint32_t hogl_vf_version(hogl_vf* vf) {
+	return vf->version;
+}
+
+void hogl_vf_set_version(hogl_vf* vf, uint32_t version) {
+	if (version < vf->version) {
+		hogl_log_warn("Setting new virtual file version to lower than the existing one");
+	}
+
+	vf->version = version;
+}
+
+hogl_error hogl_vf_map_item(hogl_vf* vf, size_t index, void** target) {
+	if (vf->item_count <= index) {
+		hogl_log_warn("Tried to access invalid virtual file item");
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+
+	if (vf->items == NULL) {
+		hogl_log_warn("Ignoring unmapped virtual file item change");
+		return HOGL_ERROR_VF_VFI_MAP;
+	}
+
+	if (vf->items[index].data == NULL) {
+		hogl_log_warn("Tried to map an item of a virtual file opened with hogl_vf_open_index, use hogl_vf_read_item");
+		return HOGL_ERROR_VF_NOT_LOADED;
+	}
+
+	(*target) = vf->items[index].data;
+	vf->mapped_items = true;
+
+	__record_access(vf, index);
+
+	return __verify_item(vf, index, vf->items[index].data);
+}
+
+hogl_error hogl_vf_read_item(hogl_vf* vf, size_t index, void* dst, uint64_t size) {
+	char* mapped = NULL;
+
+	if (vf->item_count <= index) {
+		hogl_log_warn("Tried to access invalid virtual file item");
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+
+	if (vf->table[index].size < size) {
+		hogl_log_error("Trying to read %ld bytes from an item whose size is only %ld", size, vf->table[index].size);
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+
+	__record_access(vf, index);
+
+	// Data is already in memory
+	if (vf->buffer != NULL) {
+		hogl_smemcpy(dst, vf->buffer + vf->table[index].offset, size);
+		return size == vf->table[index].size ? __verify_item(vf, index, dst) : HOGL_ERROR_NONE;
+	}
+
+	mapped = __mapped_data(vf, vf->table[index].offset, size);
+
+	if (mapped != NULL) {
+		hogl_smemcpy(dst, mapped, size);
+		return size == vf->table[index].size ? __verify_item(vf, index, dst) : HOGL_ERROR_NONE;
+	}
+
+	if (vf->file == HOGL_INVALID_FILE) {
+		hogl_log_error("Virtual file has no data and no backing file");
+		return HOGL_ERROR_VF_NOT_LOADED;
+	}
+
+	if (__read_data(vf, vf->file, vf->table[index].offset, dst, size) != HOGL_ERROR_NONE) {
+		hogl_log_error("Failed to read item %ld from virtual file", index);
+		return HOGL_ERROR_BAD_READ;
+	}
+
+	// Partial reads can't be verified
+	return size == vf->table[index].size ? __verify_item(vf, index, dst) : HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_item_foreign(hogl_vf* vf, size_t index, bool* target) {
+	if (vf->item_count <= index) {
+		hogl_log_warn("Tried to access invalid virtual file item");
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+
+	(*target) = (vf->table[index].flags & VF_ENTRY_BIG_ENDIAN) != __host_order_flag();
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_swap_item(hogl_vf* vf, size_t index, uint32_t width) {
+	hogl_vf_entry* entry = NULL;
+	hogl_error err = HOGL_ERROR_NONE;
+
+	if (vf->item_count <= index) {
+		hogl_log_warn("Tried to access invalid virtual file item");
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+
+	entry = &vf->table[index];
+
+	if ((entry->flags & VF_ENTRY_BIG_ENDIAN) == __host_order_flag()) {
+		return HOGL_ERROR_NONE;
+	}
+
+	if (vf->buffer == NULL) {
+		hogl_log_warn("Tried to swap an item of a virtual file opened with hogl_vf_open_index, swap the read data instead");
+		return HOGL_ERROR_VF_NOT_LOADED;
+	}
+
+	if ((width != 2 && width != 4 && width != 8) || entry->size % width != 0) {
+		hogl_log_error("Cannot swap virtual file item of size %ld as elements of %ld bytes", entry->size, width);
+		return HOGL_ERROR_BAD_ARGUMENT;
+	}
+
+	// The checksum was computed on the stored bytes
+	err = __verify_item(vf, index, vf->buffer + entry->offset);
+
+	if (err != HOGL_ERROR_NONE) {
+		return err;
+	}
+
+	hogl_byte_swap(vf->buffer + entry->offset, entry->size / width, width);
+
+	// Deduplicated items share the data so all of them change byte order
+	for (uint64_t i = 0; i < vf->item_count; i++) {
+		hogl_vf_entry* other = &vf->table[i];
+
+		if (i == index || (other->offset == entry->offset && other->size == entry->size && other->size != 0)) {
+			other->flags = (other->flags & ~(VF_ENTRY_BIG_ENDIAN | VF_ENTRY_HASHED)) | __host_order_flag();
+			other->crc = (other->flags & VF_ENTRY_CHECKSUM) != 0 ? hogl_crc32c(0, vf->buffer + other->offset, other->size) : 0;
+		}
+	}
+
+	// Hashes changed so the dedup index is rebuilt on the next add
+	hogl_free(vf->dedup_slots);
+	vf->dedup_slots = NULL;
+	vf->dedup_capacity = 0;
+	vf->dedup_count = 0;
+
+	vf->flags &= ~VF_FLAG_CHECKSUMS;
+
+	// Data inside the file no longer matches
+	if (entry->offset < vf->persisted_size) {
+		vf->persisted_size = 0;
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+void hogl_vf_set_verify(hogl_vf* vf, bool enabled) {
+	vf->verify = enabled;
+}
+
+hogl_error hogl_vf_verify(hogl_vf* vf) {
+	char* chunk = NULL;
+	uint32_t crc = 0;
+
+	// Whole file checksums can only be used if nothing changed since the file was read
+	if ((vf->flags & VF_FLAG_CHECKSUMS) != 0) {
+		if (__index_crc(vf) != vf->index_crc) {
+			hogl_log_error("Virtual file index checksum mismatch, the index is corrupted");
+			return HOGL_ERROR_VF_CHECKSUM;
+		}
+
+		if (vf->buffer != NULL) {
+			crc = vf->buffer_size != 0 ? hogl_crc32c(0, vf->buffer, vf->buffer_size) : 0;
+		}
+		else if (vf->file != HOGL_INVALID_FILE && vf->buffer_size != 0) {
+			// Stream the data block from disk
+			chunk = hogl_malloc(VF_VERIFY_CHUNK);
+
+			for (uint64_t offset = 0; offset < vf->buffer_size; offset += VF_VERIFY_CHUNK) {
+				uint64_t size = vf->buffer_size - offset < VF_VERIFY_CHUNK ? vf->buffer_size - offset : VF_VERIFY_CHUNK;
+
+				if (__read_data(vf, vf->file, offset, chunk, size) != HOGL_ERROR_NONE) {
+					hogl_log_error("Failed to read virtual file data for verification");
+					hogl_free(chunk);
+					return HOGL_ERROR_BAD_READ;
+				}
+
+				crc = hogl_crc32c(crc, chunk, size);
+			}
+
+			hogl_free(chunk);
+		}
+
+		if (crc != vf->data_crc) {
+			hogl_log_error("Virtual file data checksum mismatch, the data is corrupted");
+			return HOGL_ERROR_VF_CHECKSUM;
+		}
+
+		if (vf->verified != NULL) {
+			hogl_memset(vf->verified, 1, vf->item_count < vf->verified_size ? vf->item_count : vf->verified_size);
+		}
+
+		return HOGL_ERROR_NONE;
+	}
+
+	if (vf->buffer == NULL) {
+		hogl_log_error("Virtual file has no data in memory to verify");
+		return HOGL_ERROR_VF_NOT_LOADED;
+	}
+
+	// Check each item by itself
+	for (uint64_t i = 0; i < vf->item_count; i++) {
+		if ((vf->table[i].flags & VF_ENTRY_CHECKSUM) != 0 &&
+			hogl_crc32c(0, vf->buffer + vf->table[i].offset, vf->table[i].size) != vf->table[i].crc) {
+			hogl_log_error("Virtual file item %ld checksum mismatch, the data is corrupted", i);
+			return HOGL_ERROR_VF_CHECKSUM;
+		}
+	}
+
+	if (vf->verified != NULL) {
+		hogl_memset(vf->verified, 1, vf->item_count < vf->verified_size ? vf->item_count : vf->verified_size);
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_item_size(hogl_vf* vf, size_t index, uint64_t* target) {
+	if (vf->item_count <= index) {
+		hogl_log_warn("Tried to access invalid virtual file item");
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+
+	if (vf->items == NULL) {
+		hogl_log_warn("Ignoring unmapped virtual file item change");
+		return HOGL_ERROR_VF_VFI_MAP;
+	}
+
+	(*target) = *vf->items[index].data_length;
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_item_type(hogl_vf* vf, size_t index, uint32_t* target) {
+	if (vf->item_count <= index) {
+		hogl_log_warn("Tried to access invalid virtual file item");
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+
+	if (vf->items == NULL) {
+		hogl_log_warn("Ignoring unmapped virtual file item change");
+		return HOGL_ERROR_VF_VFI_MAP;
+	}
+
+	(*target) = *vf->items[index].type;
+
+	return HOGL_ERROR_NONE;
+}
+
+void __prefetch_flush(hogl_vf* vf, hogl_vf_span* run) {
+	if (run->size == 0) {
+		return;
+	}
+
+	if (vf->mapping != NULL) {
+		hogl_memory_prefetch(vf->mapping + run->offset, run->size);
+	}
+	else {
+		hogl_file_prefetch(vf->file, run->offset, run->size);
+	}
+
+	run->size = 0;
+}
+
+void __prefetch_range(hogl_vf* vf, uint64_t offset, uint64_t size, hogl_vf_span* run) {
+	size_t lo = 0;
+	size_t hi = vf->segment_count;
+
+	// Last segment starting at or before offset
+	while (hi - lo > 1) {
+		size_t mid = (lo + hi) / 2;
+
+		if (vf->segments[mid].offset <= offset) {
+			lo = mid;
+		}
+		else {
+			hi = mid;
+		}
+	}
+
+	while (size != 0 && lo < vf->segment_count) {
+		hogl_vf_segment* segment = &vf->segments[lo];
+		uint64_t skip = 0;
+		uint64_t part = 0;
+		uint64_t file_offset = 0;
+
+		if (offset < segment->offset || offset - segment->offset >= segment->size) {
+			return;
+		}
+
+		skip = offset - segment->offset;
+		part = segment->size - skip < size ? segment->size - skip : size;
+		file_offset = segment->file_offset + skip;
+
+		if (vf->mapping != NULL && file_offset + part > vf->mapping_size) {
+			return;
+		}
+
+		// Extend the current run if the data is right after it, otherwise start a new one
+		if (run->size != 0 && file_offset >= run->offset && file_offset <= run->offset + run->size + VF_PREFETCH_GAP) {
+			uint64_t end = file_offset + part > run->offset + run->size ? file_offset + part : run->offset + run->size;
+			run->size = end - run->offset;
+		}
+		else {
+			__prefetch_flush(vf, run);
+			run->offset = file_offset;
+			run->size = part;
+		}
+
+		offset += part;
+		size -= part;
+		lo++;
+	}
+}
+
+hogl_error hogl_vf_prefetch(hogl_vf* vf, const size_t* indices, size_t count) {
+	hogl_vf_span run = { 0, 0 };
+
+	for (size_t i = 0; i < count; i++) {
+		if (vf->item_count <= indices[i]) {
+			hogl_log_warn("Tried to prefetch invalid virtual file item");
+			return HOGL_ERROR_OUT_OF_RANGE;
+		}
+	}
+
+	// Data in memory needs no prefetching
+	if (vf->buffer != NULL || (vf->mapping == NULL && vf->file == HOGL_INVALID_FILE)) {
+		return HOGL_ERROR_NONE;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		__prefetch_range(vf, vf->table[indices[i]].offset, vf->table[indices[i]].size, &run);
+	}
+
+	__prefetch_flush(vf, &run);
+
+	return HOGL_ERROR_NONE;
+}
+
+void hogl_vf_set_access_pattern(hogl_vf* vf, hogl_access_pattern pattern) {
+	if (vf->mapping != NULL) {
+		hogl_memory_advise(vf->mapping, vf->mapping_size, pattern);
+	}
+	else if (vf->file != HOGL_INVALID_FILE) {
+		hogl_file_advise(vf->file, pattern);
+	}
+}
+
+void hogl_vf_record_access(hogl_vf* vf, bool enabled) {
+	uint8_t* accessed = NULL;
+	size_t* access_log = NULL;
+
+	hogl_mutex_lock(vf->access_mutex);
+	hogl_atomic_set_b32(&vf->record_access, 0);
+
+	if (!enabled) {
+		hogl_mutex_unlock(vf->access_mutex);
+		return;
+	}
+
+	// Start a new recording
+	hogl_free(vf->accessed);
+	hogl_free(vf->access_log);
+	vf->accessed = NULL;
+	vf->access_log = NULL;
+	vf->access_count = 0;
+	vf->access_capacity = 0;
+
+	if (vf->item_count == 0) {
+		hogl_mutex_unlock(vf->access_mutex);
+		return;
+	}
+
+	accessed = hogl_malloc((unsigned int)vf->item_count);
+	access_log = hogl_malloc((unsigned int)(vf->item_count * sizeof(size_t)));
+
+	if (accessed == NULL || access_log == NULL) {
+		hogl_mutex_unlock(vf->access_mutex);
+		hogl_log_error("Failed to allocate virtual file access log");
+		hogl_free(accessed);
+		hogl_free(access_log);
+		return;
+	}
+
+	hogl_memset(accessed, 0, vf->item_count);
+	vf->accessed = accessed;
+	vf->access_log = access_log;
+	vf->access_capacity = (size_t)vf->item_count;
+	hogl_atomic_set_b32(&vf->record_access, 1);
+
+	hogl_mutex_unlock(vf->access_mutex);
+}
+
+hogl_error hogl_vf_save_access_log(hogl_vf* vf, const char* path) {
+	hogl_error err = HOGL_ERROR_NONE;
+	FILE* fp = fopen(path, "wb");
+
+	if (fp == NULL) {
+		hogl_log_error("Failed to open %s", path);
+		perror("Cause: ");
+		return HOGL_ERROR_BAD_PATH;
+	}
+
+	hogl_mutex_lock(vf->access_mutex);
+
+	// Names are stored with their null terminators, they stay valid when items move between versions
+	for (size_t i = 0; i < vf->access_count; i++) {
+		hogl_vf_entry* entry = NULL;
+
+		if (vf->access_log[i] >= vf->item_count) {
+			continue;
+		}
+
+		entry = &vf->table[vf->access_log[i]];
+
+		if (fwrite(vf->name_buffer + entry->name_offset, 1, entry->name_length + 1, fp) != entry->name_length + 1) {
+			hogl_log_error("Failed to write access log %s", path);
+			err = HOGL_ERROR_BAD_WRITE;
+			break;
+		}
+	}
+
+	hogl_mutex_unlock(vf->access_mutex);
+
+	if (err != HOGL_ERROR_NONE) {
+		fclose(fp);
+		return err;
+	}
+
+	if (fclose(fp) != 0) {
+		hogl_log_error("Failed to write access log %s", path);
+		return HOGL_ERROR_BAD_WRITE;
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_prefetch_access_log(hogl_vf* vf, const char* path) {
+	hogl_file file = HOGL_INVALID_FILE;
+	hogl_error err = HOGL_ERROR_NONE;
+	char* log = NULL;
+	uint64_t size = 0;
+	size_t* slots = NULL;
+	size_t capacity = 0;
+	size_t* indices = NULL;
+	size_t count = 0;
+	size_t skipped = 0;
+	uint64_t cursor = 0;
+	bool unique = true;
+
+	file = hogl_file_open(path);
+
+	if (file == HOGL_INVALID_FILE) {
+		hogl_log_error("Failed to open %s", path);
+		return HOGL_ERROR_BAD_PATH;
+	}
+
+	size = hogl_file_size(file);
+
+	if (size == 0 || vf->item_count == 0) {
+		hogl_file_close(file);
+		return HOGL_ERROR_NONE;
+	}
+
+	log = hogl_malloc((unsigned int)size);
+
+	if (log == NULL) {
+		hogl_file_close(file);
+		return HOGL_ERROR_MEMORY;
+	}
+
+	if (hogl_file_pread(file, log, size, 0) != size) {
+		hogl_log_error("Failed to read access log %s", path);
+		hogl_file_close(file);
+		hogl_free(log);
+		return HOGL_ERROR_BAD_READ;
+	}
+
+	hogl_file_close(file);
+
+	err = __names_build(vf, &slots, &capacity, &unique);
+
+	if (err != HOGL_ERROR_NONE) {
+		hogl_free(log);
+		return err;
+	}
+
+	// Every name takes at least its null terminator
+	indices = hogl_malloc((unsigned int)(size * sizeof(size_t)));
+
+	if (indices == NULL) {
+		hogl_free(log);
+		hogl_free(slots);
+		return HOGL_ERROR_MEMORY;
+	}
+
+	while (cursor < size) {
+		const char* name = log + cursor;
+		const char* end = memchr(name, 0, (size_t)(size - cursor));
+		uint32_t length = 0;
+
+		// Truncated log, drop the last name
+		if (end == NULL) {
+			break;
+		}
+
+		length = (uint32_t)(end - name);
+
+		// Items that no longer exist are skipped
+		if (__names_find(vf, slots, capacity, name, length, &indices[count])) {
+			count++;
+		}
+		else {
+			skipped++;
+		}
+
+		cursor += length + 1;
+	}
+
+	if (skipped != 0) {
+		hogl_log_trace("Skipped %ld unknown items from access log %s", skipped, path);
+	}
+
+	err = hogl_vf_prefetch(vf, indices, count);
+
+	hogl_free(log);
+	hogl_free(slots);
+	hogl_free(indices);
+
+	return err;
+}
+
+void hogl_vf_free(hogl_vf* vf) {
+	if (vf->mapping != NULL) {
+		hogl_file_unmap(vf->mapping, vf->mapping_size);
+	}
+
+	if (vf->file != HOGL_INVALID_FILE) {
+		hogl_file_close(vf->file);
+	}
+
+	hogl_free(vf->buffer);
+	hogl_free(vf->items);
+	hogl_free(vf->table);
+	hogl_free(vf->name_buffer);
+	hogl_free(vf->dedup_slots);
+	hogl_free(vf->holes);
+	hogl_free(vf->segments);
+	hogl_free(vf->persisted_path);
+	hogl_free(vf->verified);
+	hogl_free(vf->accessed);
+	hogl_free(vf->access_log);
+	hogl_mutex_free(vf->access_mutex);
 	hogl_free(vf);
 }
+
+// Data of a streamed file starts right after the first header
+#define VF_WRITER_DATA_START (sizeof(uint32_t) + VF_HEADER_LEN)
+
+bool __writer_find(hogl_vf_writer* writer, uint64_t hash, uint32_t crc, const void* data, uint64_t size, size_t* found) {
+	hogl_vf* vf = writer->vf;
+	size_t mask = vf->dedup_capacity - 1;
+	size_t slot = (size_t)hash & mask;
+
+	while (vf->dedup_slots[slot] != VF_DEDUP_EMPTY) {
+		hogl_vf_entry* entry = &vf->table[vf->dedup_slots[slot]];
+
+		if (entry->hash == hash && entry->size == size && entry->crc == crc &&
+			(entry->flags & VF_ENTRY_BIG_ENDIAN) == __host_order_flag()) {
+			uint64_t compared = 0;
+
+			// Data is only on disk, read it back to make sure it really matches
+			if (fflush(writer->fp) != 0) {
+				return false;
+			}
+
+			while (compared < size) {
+				uint64_t chunk = size - compared < VF_VERIFY_CHUNK ? size - compared : VF_VERIFY_CHUNK;
+
+				if (hogl_file_pread(writer->file, writer->compare_buffer, chunk, VF_WRITER_DATA_START + entry->offset + compared) != chunk ||
+					memcmp(writer->compare_buffer, (const char*)data + compared, chunk) != 0) {
+					break;
+				}
+
+				compared += chunk;
+			}
+
+			if (compared == size) {
+				(*found) = vf->dedup_slots[slot];
+				return true;
+			}
+		}
+
+		slot = (slot + 1) & mask;
+	}
+
+	return false;
+}
+
+hogl_error hogl_vf_writer_open(hogl_vf_writer** writer, const char* path, uint32_t version, uint32_t max_name_len) {
+	hogl_vf_writer* w = NULL;
+	uint32_t echeck = ENDIAN_CHECK_VAL;
+	size_t path_length = strlen(path);
+	char header_buffer[VF_HEADER_LEN];
+
+	hogl_log_trace("Writing virtual file to %s", path);
+
+	w = hogl_malloc(sizeof(hogl_vf_writer));
+
+	if (w == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	w->vf = hogl_vf_new(version, max_name_len);
+	w->table_capacity = 0;
+	w->file = HOGL_INVALID_FILE;
+	w->path = hogl_malloc((unsigned int)path_length + 1);
+	w->compare_buffer = hogl_malloc(VF_VERIFY_CHUNK);
+	w->error = HOGL_ERROR_NONE;
+
+	if (w->vf == NULL || w->path == NULL || w->compare_buffer == NULL ||
+		__dedup_reserve(w->vf, 1) != HOGL_ERROR_NONE || __reserve_segments(w->vf, 1) != HOGL_ERROR_NONE) {
+		hogl_log_error("Failed to allocate virtual file writer");
+		if (w->vf != NULL) {
+			hogl_vf_free(w->vf);
+		}
+		hogl_free(w->path);
+		hogl_free(w->compare_buffer);
+		hogl_free(w);
+		return HOGL_ERROR_MEMORY;
+	}
+
+	hogl_smemcpy(w->path, path, path_length + 1);
+
+	w->fp = fopen(path, "wb");
+
+	if (w->fp == NULL) {
+		hogl_log_error("Failed to open %s", path);
+		perror("Cause: ");
+		w->error = HOGL_ERROR_BAD_PATH;
+		hogl_vf_writer_close(w);
+		return HOGL_ERROR_BAD_PATH;
+	}
+
+	// The file is written as a journaled file with the index at the end, the first header stays empty
+	w->vf->flags = VF_FLAG_JOURNAL | VF_FLAG_CHECKSUMS;
+	__fill_header(w->vf, header_buffer);
+
+	if (fwrite(&echeck, sizeof(uint32_t), 1, w->fp) != 1 || fwrite(header_buffer, VF_HEADER_LEN, 1, w->fp) != 1 ||
+		fflush(w->fp) != 0) {
+		hogl_log_error("Failed to write header information to %s", path);
+		w->error = HOGL_ERROR_BAD_WRITE;
+		hogl_vf_writer_close(w);
+		return HOGL_ERROR_BAD_WRITE;
+	}
+
+	w->file = hogl_file_open(path);
+
+	if (w->file == HOGL_INVALID_FILE) {
+		hogl_log_error("Failed to open %s for reading", path);
+		w->error = HOGL_ERROR_BAD_PATH;
+		hogl_vf_writer_close(w);
+		return HOGL_ERROR_BAD_PATH;
+	}
+
+	(*writer) = w;
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_writer_add(hogl_vf_writer* writer, const char* name, uint32_t type, const void* data, uint64_t size) {
+	return hogl_vf_writer_add_hashed(writer, name, type, data, size, hogl_hash64(data, size, 0), hogl_crc32c(0, data, size));
+}
+
+hogl_error hogl_vf_writer_add_hashed(hogl_vf_writer* writer, const char* name, uint32_t type, const void* data,
+	uint64_t size, uint64_t hash, uint32_t crc) {
+	hogl_vf* vf = writer->vf;
+	hogl_vf_entry* entry = NULL;
+	uint64_t offset = vf->buffer_size;
+	uint32_t name_offset = 0;
+	size_t name_length = strlen(name);
+	size_t existing = 0;
+	bool duplicate = false;
+
+	if (writer->error != HOGL_ERROR_NONE) {
+		return writer->error;
+	}
+
+	if (vf->max_name_len < name_length) {
+		hogl_log_error("Trying to assign name that doesn't fit inside a virtual file");
+		return HOGL_ERROR_BAD_ARGUMENT;
+	}
+
+	if (__dedup_reserve(vf, 1) != HOGL_ERROR_NONE) {
+		hogl_log_error("Failed to expand virtual file dedup index");
+		return HOGL_ERROR_MEMORY;
+	}
+
+	// Grow the table geometrically, packs can have a lot of items
+	if (vf->item_count == writer->table_capacity) {
+		uint64_t new_capacity = writer->table_capacity == 0 ? 64 : writer->table_capacity * 2;
+		hogl_vf_entry* new_table = hogl_realloc(vf->table, new_capacity * sizeof(hogl_vf_entry));
+
+		if (new_table == NULL) {
+			hogl_log_error("Failed to realloc virtual file item table");
+			return HOGL_ERROR_MEMORY;
+		}
+
+		vf->table = new_table;
+		writer->table_capacity = new_capacity;
+	}
+
+	if (__append_name(vf, name, (uint32_t)name_length, &name_offset) != HOGL_ERROR_NONE) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	duplicate = __writer_find(writer, hash, crc, data, size, &existing);
+
+	if (duplicate) {
+		offset = vf->table[existing].offset;
+	}
+	else if (size != 0) {
+		if (fwrite(data, size, 1, writer->fp) != 1) {
+			hogl_log_error("Failed to write data information to %s", writer->path);
+			writer->error = HOGL_ERROR_BAD_WRITE;
+			return HOGL_ERROR_BAD_WRITE;
+		}
+
+		vf->data_crc = hogl_crc32c(vf->data_crc, data, size);
+	}
+
+	entry = &vf->table[vf->item_count];
+	entry->type = type;
+	entry->flags = VF_ENTRY_HASHED | VF_ENTRY_CHECKSUM | __host_order_flag();
+	entry->size = size;
+	entry->offset = offset;
+	entry->hash = hash;
+	entry->crc = crc;
+	entry->reserved = 0;
+	entry->name_offset = name_offset;
+	entry->name_length = (uint32_t)name_length;
+
+	if (!duplicate) {
+		__dedup_insert(vf, vf->item_count);
+		vf->buffer_size += size;
+	}
+
+	vf->item_count++;
+	__verified_grow(vf);
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_writer_close(hogl_vf_writer* writer) {
+	hogl_vf* vf = writer->vf;
+	hogl_error error = writer->error;
+	uint64_t footer[2];
+	char header_buffer[VF_HEADER_LEN];
+
+	if (error == HOGL_ERROR_NONE) {
+		// All data is a single segment after the first header
+		vf->segment_count = 0;
+
+		if (vf->buffer_size != 0) {
+			vf->segments[0].offset = 0;
+			vf->segments[0].file_offset = VF_WRITER_DATA_START;
+			vf->segments[0].size = vf->buffer_size;
+			vf->segment_count = 1;
+		}
+
+		vf->index_crc = __index_crc(vf);
+		__fill_header(vf, header_buffer);
+
+		footer[0] = VF_WRITER_DATA_START + vf->buffer_size;
+		footer[1] = VF_JOURNAL_MAGIC;
+
+		if (fwrite(header_buffer, VF_HEADER_LEN, 1, writer->fp) != 1 ||
+			fwrite(&vf->segment_count, sizeof(uint64_t), 1, writer->fp) != 1 ||
+			(vf->segment_count != 0 && fwrite(vf->segments, vf->segment_count * sizeof(hogl_vf_segment), 1, writer->fp) != 1) ||
+			__write_names_and_table(vf, writer->fp, writer->path) != HOGL_ERROR_NONE ||
+			fwrite(footer, VF_FOOTER_LEN, 1, writer->fp) != 1) {
+			hogl_log_error("Failed to write index to %s", writer->path);
+			error = HOGL_ERROR_BAD_WRITE;
+		}
+	}
+
+	if (writer->fp != NULL && fclose(writer->fp) != 0 && error == HOGL_ERROR_NONE) {
+		hogl_log_error("Failed to close %s", writer->path);
+		error = HOGL_ERROR_BAD_WRITE;
+	}
+
+	if (writer->file != HOGL_INVALID_FILE) {
+		hogl_file_close(writer->file);
+	}
+
+	hogl_vf_free(vf);
+	hogl_free(writer->path);
+	hogl_free(writer->compare_buffer);
+	hogl_free(writer);
+
+	return error;
+}
\ No newline at end of file
@@ -6,38 +6,72 @@
 #define _HOGL_VF_
 
 #include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
 #include "hogl_core/shared/hogl_def.h"
 
 /**
  * @brief Virtual file object containing the data use hogl_vf_ and hogl_vfe_ API to manipulate,
  * its not smart to try and store very small data as separate items since an item storage meta data
- * is 32 bytes + max_name_len long and storing anything less than this becomes wasteful
+ * is 48 bytes + name length + 1 long and storing anything less than this becomes wasteful
 */
 typedef struct _hogl_vf hogl_vf;
 
 /**
- * @brief Reads the specified virtual file pointed to by path
+ * @brief Reads the specified virtual file pointed to by path, files written on a machine with a different
+ * byte order are supported, the index is converted on load and item data can be converted with hogl_vf_swap_item
  * @param vf The result will be stored inside the vf pointer
  * @param path Path to the virtual file to read
  * @return Returns error codes:
  *		HOGL_ERROR_NONE				if reading was successful
  *		HOGL_ERROR_BAD_PATH			if the specified path does not resolve to a vf file (e.g. doesn't exist)
  *		HOGL_ERROR_BAD_READ			if a bad value was encountered when reading the file
- *		HOGL_ERROR_ENDIAN_MISMATCH	if endianess of the machine and virtual file don't match
+ *		HOGL_ERROR_VF_CHECKSUM		if the index of the file is corrupted
 */
 HOGL_API hogl_error hogl_vf_read(hogl_vf** vf, const char* path);
 
+/**
+ * @brief Opens the specified virtual file but only reads its index (header, names and item table), the data
+ * stays on disk and the file is kept open until hogl_vf_free is called. Items can then be fetched using
+ * hogl_vf_read_item, hogl_vf_map_item is not available for a virtual file opened this way, neither is
+ * adding items or saving
+ * @param vf The result will be stored inside the vf pointer
+ * @param path Path to the virtual file to open
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if opening was successful
+ *		HOGL_ERROR_BAD_PATH			if the specified path does not resolve to a vf file (e.g. doesn't exist)
+ *		HOGL_ERROR_BAD_READ			if a bad value was encountered when reading the file
+ *		HOGL_ERROR_VF_CHECKSUM		if the index of the file is corrupted
+*/
+HOGL_API hogl_error hogl_vf_open_index(hogl_vf** vf, const char* path);
+
+/**
+ * @brief Opens the specified virtual file like hogl_vf_open_index and maps the whole file into memory copy on write,
+ * nothing but the index is read until an item is touched. hogl_vf_map_item returns pointers into the mapping,
+ * changes to mapped items are private and never reach the file. Adding items and saving is not available.
+ * Use hogl_vf_prefetch to load items ahead of their first access
+ * @param vf The result will be stored inside the vf pointer
+ * @param path Path to the virtual file to open
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if opening was successful
+ *		HOGL_ERROR_BAD_PATH			if the specified path does not resolve to a vf file (e.g. doesn't exist)
+ *		HOGL_ERROR_BAD_READ			if a bad value was encountered when reading the file or it could not be mapped
+ *		HOGL_ERROR_VF_CHECKSUM		if the index of the file is corrupted
+*/
+HOGL_API hogl_error hogl_vf_open_mapped(hogl_vf** vf, const char* path);
+
 /**
  * @brief Creates a new empty virtual file
  * @param version Version of the virtual file
- * @param max_name_len The maximum amount of characters for an item this can be changed later, but the operation is costly
- * @return Virtual file pointer free using hogl_vf_free
+ * @param max_name_len The maximum amount of characters for an item name, names only take up as much space as they need
+ * and this can be changed later
+ * @return Virtual file pointer free using hogl_vf_free, NULL if it could not be allocated
 */
 HOGL_API hogl_vf* hogl_vf_new(uint32_t version, uint32_t max_name_len);
 
 /**
  * @brief Changes the maximum name length for a virtual file, if the new length is smaller then the previous one then
- * the name will be cutoff and internal buffer shrunk
+ * longer names will be cutoff
  * @param vf Virtual file to edit
  * @param new_name_len New length for the virtual file name
 */
@@ -47,7 +81,8 @@ HOGL_API void hogl_vf_change_name_len(hogl_vf* vf, uint32_t new_name_len);
  * @brief Adds an item to the virtual file, causes a realloc in a virtual file.
  * Name parameter must return a valid length from strlen, that means it needs to be a null terminated string, 
  * data is stored as is so checking struct padding is up to the user. The internal vfi data is invalidated and should
- * be regenerated using hogl_vf_map_vfi
+ * be regenerated using hogl_vf_map_vfi. If an item with exactly the same data already exists the data is not stored
+ * again and both items reference the same data, so changing mapped data of one changes all of them
  * @param vf Virtual file
  * @param name Name of the new item
  * @param type Type of the new item
@@ -56,6 +91,8 @@ HOGL_API void hogl_vf_change_name_len(hogl_vf* vf, uint32_t new_name_len);
  * @return Returns error codes:
  *		HOGL_ERROR_NONE				if item was added successfully
  *		HOGL_ERROR_MEMORY			if reallocs failed, contents stay unchanged
+ *		HOGL_ERROR_BAD_ARGUMENT		if the name is longer than the max name length
+ *		HOGL_ERROR_VF_NOT_LOADED	if the virtual file was opened using hogl_vf_open_index
 */
 HOGL_API hogl_error hogl_vf_add_item(hogl_vf* vf, const char* name, uint32_t type, void* data, uint64_t size);
 
@@ -72,6 +109,64 @@ HOGL_API hogl_error hogl_vf_add_item(hogl_vf* vf, const char* name, uint32_t typ
 */
 HOGL_API hogl_error hogl_vf_rename_item(hogl_vf* vf, size_t index, const char* new_name);
 
+/**
+ * @brief Removes the specified item, items after it move down by one index. The data of the item is left as a
+ * hole inside the virtual file which is reused by hogl_vf_add_item, use hogl_vf_compact to remove holes.
+ * If the item mapping was built it is rebuilt
+ * @param vf Virtual file
+ * @param index Index of the item to remove
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the item was removed
+ *		HOGL_ERROR_OUT_OF_RANGE		if index was out of range in virtual file
+ *		HOGL_ERROR_MEMORY			if the free space map could not be expanded
+ *		HOGL_ERROR_VF_NOT_LOADED	if the virtual file was opened using hogl_vf_open_index
+*/
+HOGL_API hogl_error hogl_vf_remove_item(hogl_vf* vf, size_t index);
+
+/**
+ * @brief Removes all holes left by removed items by moving the data of the remaining items down and shrinks
+ * the virtual file, item indices don't change. If the item mapping was built it is rebuilt
+ * @param vf Virtual file to compact
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the virtual file was compacted
+ *		HOGL_ERROR_MEMORY			if there was not enough memory for the compaction
+ *		HOGL_ERROR_VF_NOT_LOADED	if the virtual file was opened using hogl_vf_open_index
+*/
+HOGL_API hogl_error hogl_vf_compact(hogl_vf* vf);
+
+/**
+ * @brief Compares two versions of a virtual file item by item and creates a patch containing only the items
+ * that are new or changed in target and a list of the items that were removed. Items are matched by name so
+ * names have to be unique. The patch is a virtual file itself and can be saved using hogl_vf_save
+ * @param base Old version of the virtual file
+ * @param target New version of the virtual file
+ * @param patch The result will be stored inside the patch pointer
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the patch was created
+ *		HOGL_ERROR_BAD_ARGUMENT		if an item name is used more than once
+ *		HOGL_ERROR_MEMORY			if the patch could not be allocated
+ *		HOGL_ERROR_VF_NOT_LOADED	if either virtual file was opened using hogl_vf_open_index
+*/
+HOGL_API hogl_error hogl_vf_diff(hogl_vf* base, hogl_vf* target, hogl_vf** patch);
+
+/**
+ * @brief Applies a patch created by hogl_vf_diff in place, changed items take the place of the items they replace,
+ * new items are added at the end and removed items leave holes. Saving the virtual file in journal mode afterwards only appends the
+ * changed data, hogl_vf_compact reclaims the space of removed and replaced items before a full save
+ * @param vf Virtual file to patch, must be the base the patch was created from
+ * @param patch Patch to apply
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE					if the patch was applied
+ *		HOGL_ERROR_BAD_ARGUMENT			if patch is not a patch
+ *		HOGL_ERROR_BAD_READ				if the patch is truncated
+ *		HOGL_ERROR_VF_CHECKSUM			if the patch is corrupted
+ *		HOGL_ERROR_VF_PATCH_MISMATCH	if the patch was created for a different virtual file or the result
+ *										wouldn't match the patch target, the virtual file is not changed
+ *		HOGL_ERROR_MEMORY				if the virtual file could not be expanded, it is left partially patched
+ *		HOGL_ERROR_VF_NOT_LOADED		if either virtual file was opened using hogl_vf_open_index
+*/
+HOGL_API hogl_error hogl_vf_apply_patch(hogl_vf* vf, hogl_vf* patch);
+
 /**
  * @brief Remaps the item pointers for the virtual file, this is needed when an internal mapping changes for example when
  * new items are added or data size changed
@@ -80,16 +175,31 @@ HOGL_API hogl_error hogl_vf_rename_item(hogl_vf* vf, size_t index, const char* n
 HOGL_API void hogl_vf_map_vfi(hogl_vf* vf);
 
 /**
- * @brief Saves the specified virtual file to the specified path
+ * @brief Saves the specified virtual file to the specified path. In journal mode, if path is the file the virtual
+ * file was read from or last saved to, only the data added since then and a new index are appended to the file,
+ * otherwise the whole file is written
  * @param vf Virtual file to save
  * @param path File to save to
  * @return Returns error codes:
  *		HOGL_ERROR_NONE				if saving was successful
  *		HOGL_ERROR_BAD_PATH			if the specified path does not resolve to a vf file (e.g. doesn't exist)
  *		HOGL_ERROR_BAD_WRITE		if a bad value was encountered when writing the file
+ *		HOGL_ERROR_BAD_READ			if a journaled file could not be read back
+ *		HOGL_ERROR_MEMORY			if there was not enough memory to prepare the index
+ *		HOGL_ERROR_VF_NOT_LOADED	if the virtual file was opened using hogl_vf_open_index
 */
 HOGL_API hogl_error hogl_vf_save(hogl_vf* vf, const char* path);
 
+/**
+ * @brief Enables/Disables journal mode, files read from a journaled file start in journal mode. While journaling,
+ * holes inside data that is already in the file are not reused and every save leaves the previous index inside the
+ * file, disable journal mode and save to drop the old indices (hogl_vf_compact drops the holes). Compacting the virtual file or swapping its items
+ * makes the next save write the whole file
+ * @param vf Virtual file
+ * @param enabled True to append on save, false to rewrite the file
+*/
+HOGL_API void hogl_vf_set_journal(hogl_vf* vf, bool enabled);
+
 /**
  * @brief Gets the index of the item with the specified name and stores it in index
  * @param vf Virtual file
@@ -102,6 +212,25 @@ HOGL_API hogl_error hogl_vf_save(hogl_vf* vf, const char* path);
 */
 HOGL_API hogl_error hogl_vf_get_item_index(hogl_vf* vf, const char* name, size_t* index);
 
+/**
+ * @brief Gets the number of items inside the virtual file
+ * @param vf Virtual file
+ * @return Item count
+*/
+HOGL_API size_t hogl_vf_item_count(hogl_vf* vf);
+
+/**
+ * @brief Gets the name of the specified item, the name stays valid until the item is renamed or the
+ * virtual file is saved, compacted or freed
+ * @param vf Virtual file
+ * @param index Index of the item
+ * @param target Target pointer, receives the null terminated name
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_OUT_OF_RANGE		if index was out of range in virtual file
+*/
+HOGL_API hogl_error hogl_vf_item_name(hogl_vf* vf, size_t index, const char** target);
+
 /**
  * @brief Gets the virtual file version
  * @param vf Virtual file
@@ -118,7 +247,7 @@ HOGL_API void hogl_vf_set_version(hogl_vf* vf, uint32_t version);
 
 /**
  * @brief Get data of the specified item from virtual file to the specified pointer, no memcpy happens changing it
- * changes the item directly
+ * changes the item directly, edited items get new checksums and are rewritten on the next save
  * @param vf Virtual file
  * @param index Index of the item
  * @param target Target pointer
@@ -126,9 +255,133 @@ HOGL_API void hogl_vf_set_version(hogl_vf* vf, uint32_t version);
  *		HOGL_ERROR_NONE				if mapping was successful
  *		HOGL_ERROR_OUT_OF_RANGE		if index was out of range in virtual file
  * 		HOGL_ERROR_VF_VFI_MAP		if the item mapping has not be built, should call hogl_vf_map_vfi before
+ *		HOGL_ERROR_VF_NOT_LOADED	if the virtual file was opened using hogl_vf_open_index
+ *		HOGL_ERROR_VF_CHECKSUM		if verification is enabled and the item data is corrupted, target is still set
 */
 HOGL_API hogl_error hogl_vf_map_item(hogl_vf* vf, size_t index, void** target);
 
+/**
+ * @brief Copies size bytes from the start of the specified item into dst, if the virtual file was opened
+ * using hogl_vf_open_index the data is read directly from disk without touching the rest of the file.
+ * This function can be called from multiple threads on the same virtual file
+ * @param vf Virtual file
+ * @param index Index of the item
+ * @param dst Caller owned memory, must be at least size bytes long
+ * @param size Number of bytes to read, can be less than the item size for partial reads
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if reading was successful
+ *		HOGL_ERROR_OUT_OF_RANGE		if index was out of range in virtual file or size is larger than the item
+ *		HOGL_ERROR_BAD_READ			if the item could not be read from disk
+ *		HOGL_ERROR_VF_NOT_LOADED	if the virtual file has no data in memory and no backing file
+ *		HOGL_ERROR_VF_CHECKSUM		if verification is enabled and the item data is corrupted, partial reads are not verified
+*/
+HOGL_API hogl_error hogl_vf_read_item(hogl_vf* vf, size_t index, void* dst, uint64_t size);
+
+/**
+ * @brief Asks the operating system to start loading the data of the specified items in the background so their
+ * first access does not stall on disk reads. Requests are issued in the given order and items next to each other
+ * inside the file are merged. Only has an effect for virtual files opened using hogl_vf_open_mapped or
+ * hogl_vf_open_index
+ * @param vf Virtual file
+ * @param indices Indices of the items to prefetch, in the order they will be needed
+ * @param count Number of indices
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the prefetch was requested
+ *		HOGL_ERROR_OUT_OF_RANGE		if an index was out of range in virtual file, nothing is prefetched
+*/
+HOGL_API hogl_error hogl_vf_prefetch(hogl_vf* vf, const size_t* indices, size_t count);
+
+/**
+ * @brief Tells the operating system how the items will be accessed so it can adjust how much it reads ahead,
+ * only has an effect for virtual files opened using hogl_vf_open_mapped or hogl_vf_open_index
+ * @param vf Virtual file
+ * @param pattern HOGL_ACCESS_SEQUENTIAL when items are read in file order, HOGL_ACCESS_RANDOM for scattered reads
+*/
+HOGL_API void hogl_vf_set_access_pattern(hogl_vf* vf, hogl_access_pattern pattern);
+
+/**
+ * @brief Enables/Disables access recording, enabling starts a new recording of the items in the order they are first
+ * mapped or read. Disabling stops the recording but keeps it so it can be saved using hogl_vf_save_access_log.
+ * Items read by the async loader are recorded as well, in the order their reads ran
+ * @param vf Virtual file
+ * @param enabled True to start recording, false to stop
+*/
+HOGL_API void hogl_vf_record_access(hogl_vf* vf, bool enabled);
+
+/**
+ * @brief Saves the recorded access order to a file as item names, so it stays usable when the virtual file changes
+ * @param vf Virtual file
+ * @param path Path of the access log
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the access log was saved
+ *		HOGL_ERROR_BAD_PATH			if the file could not be opened for writing
+ *		HOGL_ERROR_BAD_WRITE		if writing the file failed
+*/
+HOGL_API hogl_error hogl_vf_save_access_log(hogl_vf* vf, const char* path);
+
+/**
+ * @brief Reads an access log saved by hogl_vf_save_access_log and prefetches the items in the recorded order,
+ * names that are not inside the virtual file are skipped. Call right after opening the virtual file so the data
+ * is loading while the rest of the startup runs
+ * @param vf Virtual file
+ * @param path Path of the access log
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the prefetch was requested
+ *		HOGL_ERROR_BAD_PATH			if the access log could not be opened
+ *		HOGL_ERROR_BAD_READ			if the access log could not be read
+ *		HOGL_ERROR_MEMORY			if there was not enough memory to resolve the names
+*/
+HOGL_API hogl_error hogl_vf_prefetch_access_log(hogl_vf* vf, const char* path);
+
+/**
+ * @brief Checks if the item data was written on a machine with a different byte order, such data has to be
+ * swapped before use either with hogl_vf_swap_item or by calling hogl_byte_swap on data from hogl_vf_read_item
+ * @param vf Virtual file
+ * @param index Index of the item
+ * @param target Set to true if the item data is in a different byte order than the machine
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if there were no errors
+ *		HOGL_ERROR_OUT_OF_RANGE		if index was out of range in virtual file
+*/
+HOGL_API hogl_error hogl_vf_item_foreign(hogl_vf* vf, size_t index, bool* target);
+
+/**
+ * @brief Converts the data of an item written on a machine with a different byte order to the byte order of
+ * this machine in place, treating it as an array of elements of the specified width. Does nothing if the item
+ * is already in the byte order of this machine, so it is safe to call for every item after reading
+ * @param vf Virtual file
+ * @param index Index of the item
+ * @param width Size of a single element in bytes, 2 for uint16, 4 for uint32 and float, 8 for uint64 and double
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the item is in the byte order of this machine
+ *		HOGL_ERROR_OUT_OF_RANGE		if index was out of range in virtual file
+ *		HOGL_ERROR_BAD_ARGUMENT		if width is not supported or the item size is not a multiple of it
+ *		HOGL_ERROR_VF_NOT_LOADED	if the virtual file was opened using hogl_vf_open_index
+ *		HOGL_ERROR_VF_CHECKSUM		if verification is enabled and the item data is corrupted
+*/
+HOGL_API hogl_error hogl_vf_swap_item(hogl_vf* vf, size_t index, uint32_t width);
+
+/**
+ * @brief Enables/Disables lazy item verification, when enabled the checksum of an item is checked the first time
+ * the item is mapped or fully read. Enabled by default unless HOGL_DISABLE_VF_VERIFY is defined
+ * @param vf Virtual file
+ * @param enabled True to verify items, false otherwise
+*/
+HOGL_API void hogl_vf_set_verify(hogl_vf* vf, bool enabled);
+
+/**
+ * @brief Verifies the whole virtual file, if nothing was changed since the file was read the file checksums are
+ * used, otherwise every item checksum is checked. For a virtual file opened using hogl_vf_open_index the data
+ * is streamed from disk
+ * @param vf Virtual file to verify
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the virtual file is intact
+ *		HOGL_ERROR_VF_CHECKSUM		if the index or the data is corrupted
+ *		HOGL_ERROR_BAD_READ			if the data could not be read from disk
+ *		HOGL_ERROR_VF_NOT_LOADED	if the virtual file was changed and has no data in memory
+*/
+HOGL_API hogl_error hogl_vf_verify(hogl_vf* vf);
+
 /**
  * @brief Get the item data size of the specified item and stores it inside target
  * @param vf Virtual file
@@ -159,4 +412,65 @@ HOGL_API hogl_error hogl_vf_item_type(hogl_vf* vf, size_t index, uint32_t* targe
 */
 HOGL_API void hogl_vf_free(hogl_vf* vf);
 
+/**
+ * @brief Streaming virtual file writer, item data is written to the file as items are added so only the index
+ * is kept in memory. Used to build virtual files that don't fit into memory
+*/
+typedef struct _hogl_vf_writer hogl_vf_writer;
+
+/**
+ * @brief Creates the file pointed to by path and starts writing a virtual file into it, the file is
+ * only readable after hogl_vf_writer_close returns successfully
+ * @param writer The result will be stored inside the writer pointer
+ * @param path Path of the virtual file to write, an existing file is overwritten
+ * @param version Version of the virtual file
+ * @param max_name_len Maximum length of item names
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the file was created
+ *		HOGL_ERROR_BAD_PATH			if the file could not be created
+ *		HOGL_ERROR_BAD_WRITE		if the file header could not be written
+ *		HOGL_ERROR_MEMORY			if the writer could not be allocated
+*/
+HOGL_API hogl_error hogl_vf_writer_open(hogl_vf_writer** writer, const char* path, uint32_t version, uint32_t max_name_len);
+
+/**
+ * @brief Adds an item to the virtual file being written, same as hogl_vf_add_item items with identical data
+ * share the same data
+ * @param writer Writer
+ * @param name Name of the item
+ * @param type Type of the item
+ * @param data Data of the item, not used after the call returns
+ * @param size Size of the data
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the item was added
+ *		HOGL_ERROR_BAD_ARGUMENT		if the name is longer than the maximum name length
+ *		HOGL_ERROR_BAD_WRITE		if the data could not be written, the writer can only be closed after this
+ *		HOGL_ERROR_MEMORY			if the index could not be expanded
+*/
+HOGL_API hogl_error hogl_vf_writer_add(hogl_vf_writer* writer, const char* name, uint32_t type, const void* data, uint64_t size);
+
+/**
+ * @brief Same as hogl_vf_writer_add but takes the hash and checksum of the data, so they can be computed
+ * on other threads while the writer is busy
+ * @param writer Writer
+ * @param name Name of the item
+ * @param type Type of the item
+ * @param data Data of the item, not used after the call returns
+ * @param size Size of the data
+ * @param hash hogl_hash64(data, size, 0)
+ * @param crc hogl_crc32c(0, data, size)
+ * @return Returns error codes: same as hogl_vf_writer_add
+*/
+HOGL_API hogl_error hogl_vf_writer_add_hashed(hogl_vf_writer* writer, const char* name, uint32_t type, const void* data,
+	uint64_t size, uint64_t hash, uint32_t crc);
+
+/**
+ * @brief Writes the index of the virtual file, closes the file and frees the writer
+ * @param writer Writer to close
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the virtual file was written
+ *		HOGL_ERROR_BAD_WRITE		if writing any part of the file failed
+*/
+HOGL_API hogl_error hogl_vf_writer_close(hogl_vf_writer* writer);
+
 #endif
\ No newline at end of file
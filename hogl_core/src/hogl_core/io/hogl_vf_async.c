@@ -0,0 +1,221 @@
+#include "hogl_vf_async.h"
+
+#include <stdlib.h>
+#include "hogl_core/shared/hogl_log.h"
+#include "hogl_core/shared/hogl_memory.h"
+#include "hogl_core/shared/hogl_job.h"
+#include "hogl_core/os/hogl_os.h"
+
+#define COMPLETION_QUEUE_INITIAL_CAPACITY 64
+
+typedef struct _hogl_vf_async {
+	hogl_job_system* js;
+
+	// Completed requests without a callback
+	hogl_mutex* mutex;
+	hogl_vf_request** completed;
+	size_t completed_count;
+	size_t completed_capacity;
+
+	// Slots promised to completed and in flight requests, reserved on submit so completing never allocates
+	size_t completed_reserved;
+} hogl_vf_async;
+
+void __complete_request(hogl_vf_request* request) {
+	hogl_vf_async* async = request->async;
+
+	if (request->callback != NULL) {
+		request->callback(request);
+		return;
+	}
+
+	// The slot was reserved when the request was submitted
+	hogl_mutex_lock(async->mutex);
+	async->completed[async->completed_count++] = request;
+
+	hogl_mutex_unlock(async->mutex);
+}
+
+void __execute_request(void* p) {
+	hogl_vf_request* request = (hogl_vf_request*)p;
+	request->result = hogl_vf_read_item(request->vf, request->index, request->dst, request->size);
+	__complete_request(request);
+}
+
+int __compare_requests(const void* a, const void* b) {
+	const hogl_vf_request* ra = *(const hogl_vf_request**)a;
+	const hogl_vf_request* rb = *(const hogl_vf_request**)b;
+
+	if (ra->vf != rb->vf) {
+		return (uintptr_t)ra->vf < (uintptr_t)rb->vf ? -1 : 1;
+	}
+
+	if (ra->index != rb->index) {
+		return ra->index < rb->index ? -1 : 1;
+	}
+
+	return 0;
+}
+
+hogl_error hogl_vf_async_new(hogl_vf_async** async, unsigned int threads) {
+	hogl_error err = HOGL_ERROR_NONE;
+
+	(*async) = hogl_malloc(sizeof(hogl_vf_async));
+
+	if ((*async) == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	(*async)->js = NULL;
+	(*async)->mutex = hogl_mutex_new();
+	(*async)->completed = hogl_malloc(COMPLETION_QUEUE_INITIAL_CAPACITY * sizeof(hogl_vf_request*));
+	(*async)->completed_count = 0;
+	(*async)->completed_capacity = COMPLETION_QUEUE_INITIAL_CAPACITY;
+	(*async)->completed_reserved = 0;
+
+	// Threads are started last so nothing has to be stopped if an allocation failed
+	if ((*async)->mutex == NULL || (*async)->completed == NULL) {
+		err = HOGL_ERROR_MEMORY;
+	}
+	else {
+		err = hogl_js_new(&(*async)->js, threads);
+
+		if (err != HOGL_ERROR_NONE) {
+			hogl_log_error("Failed to start virtual file I/O threads");
+		}
+	}
+
+	if (err != HOGL_ERROR_NONE) {
+		if ((*async)->mutex != NULL) {
+			hogl_mutex_free((*async)->mutex);
+		}
+
+		hogl_free((*async)->completed);
+		hogl_free(*async);
+		(*async) = NULL;
+		return err;
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error __reserve_completions(hogl_vf_async* async, size_t count) {
+	hogl_vf_request** new_completed = NULL;
+	size_t new_capacity = async->completed_capacity;
+
+	hogl_mutex_lock(async->mutex);
+
+	while (new_capacity < async->completed_reserved + count) {
+		new_capacity *= 2;
+	}
+
+	if (new_capacity != async->completed_capacity) {
+		new_completed = hogl_realloc(async->completed, new_capacity * sizeof(hogl_vf_request*));
+
+		if (new_completed == NULL) {
+			hogl_mutex_unlock(async->mutex);
+			hogl_log_error("Failed to expand the completion queue to %ld requests", new_capacity);
+			return HOGL_ERROR_MEMORY;
+		}
+
+		async->completed = new_completed;
+		async->completed_capacity = new_capacity;
+	}
+
+	async->completed_reserved += count;
+
+	hogl_mutex_unlock(async->mutex);
+	return HOGL_ERROR_NONE;
+}
+
+void __release_completions(hogl_vf_async* async, size_t count) {
+	hogl_mutex_lock(async->mutex);
+	async->completed_reserved -= count;
+	hogl_mutex_unlock(async->mutex);
+}
+
+hogl_error hogl_vf_async_submit(hogl_vf_async* async, hogl_vf_request* requests, size_t count) {
+	hogl_vf_request** ordered = NULL;
+	hogl_error err = HOGL_ERROR_NONE;
+	size_t queued = 0;
+
+	if (count == 0) {
+		return HOGL_ERROR_NONE;
+	}
+
+	// Requests without a callback end up in the completion queue
+	for (size_t i = 0; i < count; i++) {
+		if (requests[i].callback == NULL) {
+			queued++;
+		}
+	}
+
+	if (queued != 0) {
+		err = __reserve_completions(async, queued);
+
+		if (err != HOGL_ERROR_NONE) {
+			return err;
+		}
+	}
+
+	ordered = hogl_malloc(count * sizeof(hogl_vf_request*));
+
+	if (ordered == NULL) {
+		__release_completions(async, queued);
+		return HOGL_ERROR_MEMORY;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		requests[i].async = async;
+		requests[i].result = HOGL_ERROR_NONE;
+		ordered[i] = &requests[i];
+	}
+
+	// Issue reads from the same file in item order
+	qsort(ordered, count, sizeof(hogl_vf_request*), __compare_requests);
+
+	err = hogl_js_submit_n(async->js, __execute_request, (void**)ordered, count);
+
+	hogl_free(ordered);
+
+	if (err != HOGL_ERROR_NONE) {
+		__release_completions(async, queued);
+	}
+
+	return err;
+}
+
+size_t hogl_vf_async_poll(hogl_vf_async* async, hogl_vf_request** completed, size_t max) {
+	size_t count = 0;
+
+	hogl_mutex_lock(async->mutex);
+
+	count = async->completed_count < max ? async->completed_count : max;
+
+	for (size_t i = 0; i < count; i++) {
+		completed[i] = async->completed[i];
+	}
+
+	// Move the remaining requests to the front
+	for (size_t i = count; i < async->completed_count; i++) {
+		async->completed[i - count] = async->completed[i];
+	}
+
+	async->completed_count -= count;
+	async->completed_reserved -= count;
+
+	hogl_mutex_unlock(async->mutex);
+
+	return count;
+}
+
+void hogl_vf_async_wait(hogl_vf_async* async) {
+	hogl_js_wait(async->js);
+}
+
+void hogl_vf_async_free(hogl_vf_async* async) {
+	hogl_js_free(async->js);
+	hogl_mutex_free(async->mutex);
+	hogl_free(async->completed);
+	hogl_free(async);
+}
\ No newline at end of file
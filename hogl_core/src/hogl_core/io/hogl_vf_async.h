@@ -0,0 +1,119 @@
+/**
+* @brief hogl virtual file async header contains functionality for loading virtual file items on background I/O threads
+*/
+
+#ifndef _HOGL_VF_ASYNC_
+#define _HOGL_VF_ASYNC_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "hogl_core/shared/hogl_def.h"
+#include "hogl_core/io/hogl_vf.h"
+
+/**
+ * @brief Async loader object, owns the I/O threads and the completion queue
+*/
+typedef struct _hogl_vf_async hogl_vf_async;
+
+/**
+ * @brief Forward declared request so it can be used in the callback
+*/
+typedef struct _hogl_vf_request hogl_vf_request;
+
+/**
+ * @brief Request completion callback, called on one of the I/O threads so it should be short and thread safe
+*/
+typedef void (*hogl_vf_request_cb)(hogl_vf_request* request);
+
+/**
+ * @brief Single item read request, the memory of the request is owned by the caller and must stay valid
+ * until the request is completed
+*/
+typedef struct _hogl_vf_request {
+	/**
+	 * @brief Virtual file to read from, usually opened using hogl_vf_open_index
+	*/
+	hogl_vf* vf;
+
+	/**
+	 * @brief Index of the item inside the virtual file
+	*/
+	size_t index;
+
+	/**
+	 * @brief Caller owned destination memory, must be at least size bytes long
+	*/
+	void* dst;
+
+	/**
+	 * @brief Number of bytes to read from the start of the item
+	*/
+	uint64_t size;
+
+	/**
+	 * @brief Called when the request completes, if NULL the request is instead pushed to the completion
+	 * queue that can be polled using hogl_vf_async_poll
+	*/
+	hogl_vf_request_cb callback;
+
+	/**
+	 * @brief User pointer, not used by hogl
+	*/
+	void* usrp;
+
+	/**
+	 * @brief Result of the read, valid once the request is completed
+	*/
+	hogl_error result;
+
+	/**
+	 * @brief Loader the request was submitted to, set by hogl_vf_async_submit
+	*/
+	hogl_vf_async* async;
+} hogl_vf_request;
+
+/**
+ * @brief Creates a new async loader and starts its I/O threads
+ * @param async Where to store the new loader
+ * @param threads Number of I/O threads, 0 to use one thread per logical processor
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the loader could not be allocated or the I/O threads could not be started
+*/
+HOGL_API hogl_error hogl_vf_async_new(hogl_vf_async** async, unsigned int threads);
+
+/**
+ * @brief Submits a batch of read requests, the function doesn't block on disk. Requests of the batch are issued
+ * ordered by virtual file and item index so that reads from the same file are as sequential as possible
+ * @param async Async loader
+ * @param requests Array of requests, each request must stay valid until it is completed
+ * @param count Number of requests
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the requests could not be queued, none of the requests are submitted
+*/
+HOGL_API hogl_error hogl_vf_async_submit(hogl_vf_async* async, hogl_vf_request* requests, size_t count);
+
+/**
+ * @brief Takes up to max completed requests without a callback from the completion queue, never blocks
+ * @param async Async loader
+ * @param completed Array where pointers to the completed requests are stored
+ * @param max Size of the completed array
+ * @return Number of requests stored inside completed
+*/
+HOGL_API size_t hogl_vf_async_poll(hogl_vf_async* async, hogl_vf_request** completed, size_t max);
+
+/**
+ * @brief Blocks until all submitted requests are completed
+ * @param async Async loader
+*/
+HOGL_API void hogl_vf_async_wait(hogl_vf_async* async);
+
+/**
+ * @brief Waits for all submitted requests, stops the I/O threads and frees the loader, completed requests
+ * that were not polled are dropped
+ * @param async Loader to free
+*/
+HOGL_API void hogl_vf_async_free(hogl_vf_async* async);
+
+#endif
\ No newline at end of file
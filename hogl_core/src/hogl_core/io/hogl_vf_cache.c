@@ -0,0 +1,366 @@
+#include "hogl_vf_cache.h"
+
+#include <string.h>
+#include <stdbool.h>
+#include "hogl_core/shared/hogl_log.h"
+#include "hogl_core/shared/hogl_memory.h"
+#include "hogl_core/shared/hogl_hash.h"
+
+#define CACHE_SLOT_EMPTY ((size_t)-1)
+
+typedef struct _hogl_vf_cache_entry {
+	// NULL if the entry is free
+	hogl_vf* vf;
+	size_t index;
+	uint64_t hash;
+
+	void* data;
+	uint64_t size;
+
+	uint32_t pins;
+	bool referenced;
+} hogl_vf_cache_entry;
+
+typedef struct _hogl_vf_cache {
+	uint64_t budget;
+	hogl_vf_cache_stats stats;
+
+	// Entries are never moved so the CLOCK hand can walk them in order, free entries are kept in a stack
+	hogl_vf_cache_entry* entries;
+	size_t entry_count;
+	size_t entry_capacity;
+	size_t* free_entries;
+	size_t free_count;
+	size_t hand;
+
+	// Open addressing index of (vf, item) keys to entries
+	size_t* slots;
+	size_t slot_capacity;
+} hogl_vf_cache;
+
+uint64_t __cache_hash(hogl_vf* vf, size_t index) {
+	uintptr_t key[2];
+	key[0] = (uintptr_t)vf;
+	key[1] = (uintptr_t)index;
+	return hogl_hash64(key, sizeof(key), 0);
+}
+
+size_t __cache_find(hogl_vf_cache* cache, hogl_vf* vf, size_t index, uint64_t hash) {
+	size_t mask = cache->slot_capacity - 1;
+	size_t slot = (size_t)hash & mask;
+
+	while (cache->slots[slot] != CACHE_SLOT_EMPTY) {
+		hogl_vf_cache_entry* entry = &cache->entries[cache->slots[slot]];
+
+		if (entry->vf == vf && entry->index == index) {
+			return slot;
+		}
+
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+void __cache_slot_insert(hogl_vf_cache* cache, size_t entry) {
+	size_t mask = cache->slot_capacity - 1;
+	size_t slot = (size_t)cache->entries[entry].hash & mask;
+
+	while (cache->slots[slot] != CACHE_SLOT_EMPTY) {
+		slot = (slot + 1) & mask;
+	}
+
+	cache->slots[slot] = entry;
+}
+
+void __cache_slot_remove(hogl_vf_cache* cache, size_t slot) {
+	size_t mask = cache->slot_capacity - 1;
+	size_t next = slot;
+
+	// Backward shift deletion, moves following entries of the probe chain into the gap so no tombstones are needed
+	while (true) {
+		size_t home = 0;
+
+		next = (next + 1) & mask;
+
+		if (cache->slots[next] == CACHE_SLOT_EMPTY) {
+			break;
+		}
+
+		home = (size_t)cache->entries[cache->slots[next]].hash & mask;
+
+		if (((next - home) & mask) >= ((next - slot) & mask)) {
+			cache->slots[slot] = cache->slots[next];
+			slot = next;
+		}
+	}
+
+	cache->slots[slot] = CACHE_SLOT_EMPTY;
+}
+
+void __cache_evict(hogl_vf_cache* cache, size_t entry_index) {
+	hogl_vf_cache_entry* entry = &cache->entries[entry_index];
+
+	__cache_slot_remove(cache, __cache_find(cache, entry->vf, entry->index, entry->hash));
+
+	hogl_free(entry->data);
+	cache->stats.resident_bytes -= entry->size;
+	cache->stats.resident_items--;
+	cache->stats.evictions++;
+
+	entry->vf = NULL;
+	entry->data = NULL;
+	cache->free_entries[cache->free_count++] = entry_index;
+}
+
+bool __cache_evict_one(hogl_vf_cache* cache) {
+	// Two passes are enough, the first one clears the reference bits it passes
+	for (size_t scanned = 0; scanned < cache->entry_count * 2; scanned++) {
+		size_t current = cache->hand;
+		hogl_vf_cache_entry* entry = &cache->entries[current];
+
+		cache->hand = (cache->hand + 1) % cache->entry_count;
+
+		if (entry->vf == NULL || entry->pins != 0) {
+			continue;
+		}
+
+		if (entry->referenced) {
+			entry->referenced = false;
+			continue;
+		}
+
+		__cache_evict(cache, current);
+		return true;
+	}
+
+	return false;
+}
+
+void __cache_make_room(hogl_vf_cache* cache, uint64_t size) {
+	while (cache->stats.resident_bytes + size > cache->budget && __cache_evict_one(cache)) {
+	}
+}
+
+hogl_error __cache_reserve(hogl_vf_cache* cache) {
+	// Entry array
+	if (cache->free_count == 0 && cache->entry_count == cache->entry_capacity) {
+		size_t new_capacity = cache->entry_capacity * 2;
+		hogl_vf_cache_entry* new_entries = hogl_realloc(cache->entries, new_capacity * sizeof(hogl_vf_cache_entry));
+		size_t* new_free = NULL;
+
+		if (new_entries == NULL) {
+			return HOGL_ERROR_MEMORY;
+		}
+
+		cache->entries = new_entries;
+
+		new_free = hogl_realloc(cache->free_entries, new_capacity * sizeof(size_t));
+
+		if (new_free == NULL) {
+			return HOGL_ERROR_MEMORY;
+		}
+
+		cache->free_entries = new_free;
+		cache->entry_capacity = new_capacity;
+	}
+
+	// Index, keep the load factor under 50%
+	if ((cache->stats.resident_items + 1) * 2 > cache->slot_capacity) {
+		size_t new_capacity = cache->slot_capacity * 2;
+		size_t* new_slots = hogl_malloc((unsigned int)(new_capacity * sizeof(size_t)));
+
+		if (new_slots == NULL) {
+			return HOGL_ERROR_MEMORY;
+		}
+
+		hogl_free(cache->slots);
+		cache->slots = new_slots;
+		cache->slot_capacity = new_capacity;
+		hogl_memset(cache->slots, 0xFF, new_capacity * sizeof(size_t));
+
+		for (size_t i = 0; i < cache->entry_count; i++) {
+			if (cache->entries[i].vf != NULL) {
+				__cache_slot_insert(cache, i);
+			}
+		}
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_cache_new(hogl_vf_cache** cache, uint64_t budget) {
+	hogl_vf_cache* result = hogl_malloc(sizeof(hogl_vf_cache));
+
+	if (result == NULL) {
+		hogl_log_error("Failed to allocate item cache");
+		return HOGL_ERROR_MEMORY;
+	}
+
+	hogl_memset(result, 0, sizeof(hogl_vf_cache));
+	result->budget = budget;
+	result->entry_capacity = 64;
+	result->slot_capacity = 128;
+	result->entries = hogl_malloc(result->entry_capacity * sizeof(hogl_vf_cache_entry));
+	result->free_entries = hogl_malloc(result->entry_capacity * sizeof(size_t));
+	result->slots = hogl_malloc(result->slot_capacity * sizeof(size_t));
+
+	if (result->entries == NULL || result->free_entries == NULL || result->slots == NULL) {
+		hogl_log_error("Failed to allocate item cache");
+		hogl_vf_cache_free(result);
+		return HOGL_ERROR_MEMORY;
+	}
+
+	hogl_memset(result->slots, 0xFF, result->slot_capacity * sizeof(size_t));
+
+	(*cache) = result;
+
+	return HOGL_ERROR_NONE;
+}
+
+void hogl_vf_cache_set_budget(hogl_vf_cache* cache, uint64_t budget) {
+	cache->budget = budget;
+	__cache_make_room(cache, 0);
+}
+
+hogl_error hogl_vf_cache_pin(hogl_vf_cache* cache, hogl_vf* vf, size_t index, const void** data, uint64_t* size) {
+	uint64_t hash = __cache_hash(vf, index);
+	size_t slot = __cache_find(cache, vf, index, hash);
+	size_t entry_index = 0;
+	hogl_vf_cache_entry* entry = NULL;
+	uint64_t item_size = 0;
+	void* item_data = NULL;
+	hogl_error error = HOGL_ERROR_NONE;
+
+	if (cache->slots[slot] != CACHE_SLOT_EMPTY) {
+		entry = &cache->entries[cache->slots[slot]];
+
+		if (entry->pins == 0) {
+			cache->stats.pinned_items++;
+		}
+
+		entry->pins++;
+		entry->referenced = true;
+		cache->stats.hits++;
+
+		(*data) = entry->data;
+		if (size != NULL) {
+			(*size) = entry->size;
+		}
+
+		return HOGL_ERROR_NONE;
+	}
+
+	error = hogl_vf_item_size(vf, index, &item_size);
+
+	if (error != HOGL_ERROR_NONE) {
+		return error;
+	}
+
+	if (__cache_reserve(cache) != HOGL_ERROR_NONE) {
+		hogl_log_error("Failed to expand item cache");
+		return HOGL_ERROR_MEMORY;
+	}
+
+	__cache_make_room(cache, item_size);
+
+	if (item_size != 0) {
+		item_data = hogl_malloc((unsigned int)item_size);
+
+		if (item_data == NULL) {
+			hogl_log_error("Failed to allocate %ld bytes for cached item", item_size);
+			return HOGL_ERROR_MEMORY;
+		}
+
+		error = hogl_vf_read_item(vf, index, item_data, item_size);
+
+		if (error != HOGL_ERROR_NONE) {
+			hogl_free(item_data);
+			return error;
+		}
+	}
+
+	// Evictions may have shifted the probe chain
+	slot = __cache_find(cache, vf, index, hash);
+	entry_index = cache->free_count != 0 ? cache->free_entries[--cache->free_count] : cache->entry_count++;
+
+	entry = &cache->entries[entry_index];
+	entry->vf = vf;
+	entry->index = index;
+	entry->hash = hash;
+	entry->data = item_data;
+	entry->size = item_size;
+	entry->pins = 1;
+	entry->referenced = true;
+	cache->slots[slot] = entry_index;
+
+	cache->stats.misses++;
+	cache->stats.resident_bytes += item_size;
+	cache->stats.resident_items++;
+	cache->stats.pinned_items++;
+
+	(*data) = item_data;
+	if (size != NULL) {
+		(*size) = item_size;
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_cache_unpin(hogl_vf_cache* cache, hogl_vf* vf, size_t index) {
+	size_t slot = __cache_find(cache, vf, index, __cache_hash(vf, index));
+	hogl_vf_cache_entry* entry = NULL;
+
+	if (cache->slots[slot] == CACHE_SLOT_EMPTY || cache->entries[cache->slots[slot]].pins == 0) {
+		hogl_log_warn("Tried to unpin item %ld that is not pinned", index);
+		return HOGL_ERROR_BAD_ARGUMENT;
+	}
+
+	entry = &cache->entries[cache->slots[slot]];
+	entry->pins--;
+
+	if (entry->pins == 0) {
+		cache->stats.pinned_items--;
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_cache_drop(hogl_vf_cache* cache, hogl_vf* vf) {
+	hogl_error error = HOGL_ERROR_NONE;
+
+	for (size_t i = 0; i < cache->entry_count; i++) {
+		hogl_vf_cache_entry* entry = &cache->entries[i];
+
+		if (entry->vf != vf) {
+			continue;
+		}
+
+		if (entry->pins != 0) {
+			hogl_log_warn("Item %ld is still pinned, keeping it in the cache", entry->index);
+			error = HOGL_ERROR_BAD_ARGUMENT;
+			continue;
+		}
+
+		__cache_evict(cache, i);
+	}
+
+	return error;
+}
+
+void hogl_vf_cache_get_stats(hogl_vf_cache* cache, hogl_vf_cache_stats* stats) {
+	(*stats) = cache->stats;
+}
+
+void hogl_vf_cache_free(hogl_vf_cache* cache) {
+	if (cache->entries != NULL) {
+		for (size_t i = 0; i < cache->entry_count; i++) {
+			hogl_free(cache->entries[i].data);
+		}
+	}
+
+	hogl_free(cache->entries);
+	hogl_free(cache->free_entries);
+	hogl_free(cache->slots);
+	hogl_free(cache);
+}
\ No newline at end of file
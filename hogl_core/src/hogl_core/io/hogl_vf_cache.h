@@ -0,0 +1,126 @@
+/**
+* @brief hogl virtual file cache header contains functionality for keeping a bounded working set of item data
+* in memory, meant for virtual files opened using hogl_vf_open_index
+*/
+
+#ifndef _HOGL_VF_CACHE_
+#define _HOGL_VF_CACHE_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "hogl_core/shared/hogl_def.h"
+#include "hogl_core/io/hogl_vf.h"
+
+/**
+ * @brief Item cache object, holds copies of item data up to a byte budget and evicts the least recently used
+ * unpinned items using the CLOCK algorithm. The cache is not thread safe
+*/
+typedef struct _hogl_vf_cache hogl_vf_cache;
+
+/**
+ * @brief Cache counters
+*/
+typedef struct _hogl_vf_cache_stats {
+	/**
+	 * @brief Number of pins that found the item in the cache
+	*/
+	uint64_t hits;
+
+	/**
+	 * @brief Number of pins that had to read the item
+	*/
+	uint64_t misses;
+
+	/**
+	 * @brief Number of items evicted to stay within the budget or dropped
+	*/
+	uint64_t evictions;
+
+	/**
+	 * @brief Bytes of item data currently inside the cache
+	*/
+	uint64_t resident_bytes;
+
+	/**
+	 * @brief Number of items currently inside the cache
+	*/
+	size_t resident_items;
+
+	/**
+	 * @brief Number of items currently pinned
+	*/
+	size_t pinned_items;
+} hogl_vf_cache_stats;
+
+/**
+ * @brief Creates a new item cache
+ * @param cache The result will be stored inside the cache pointer
+ * @param budget Maximum number of bytes of item data kept in the cache, pinned items are never evicted
+ * so the cache can go over the budget while they are pinned
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the cache was created
+ *		HOGL_ERROR_MEMORY			if the cache could not be allocated
+*/
+HOGL_API hogl_error hogl_vf_cache_new(hogl_vf_cache** cache, uint64_t budget);
+
+/**
+ * @brief Changes the byte budget of the cache, items are evicted right away if the cache is over the new budget
+ * @param cache Cache
+ * @param budget New budget in bytes
+*/
+HOGL_API void hogl_vf_cache_set_budget(hogl_vf_cache* cache, uint64_t budget);
+
+/**
+ * @brief Pins the item, reading it if it is not inside the cache. The data stays valid and is not evicted
+ * until the item is unpinned as many times as it was pinned
+ * @param cache Cache
+ * @param vf Virtual file the item belongs to, needs to have its item mapping built using hogl_vf_map_vfi
+ * @param index Index of the item
+ * @param data Receives a pointer to the item data, NULL for empty items
+ * @param size Receives the size of the item data, can be NULL
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the item was pinned
+ *		HOGL_ERROR_OUT_OF_RANGE		if index was out of range in virtual file
+ *		HOGL_ERROR_VF_VFI_MAP		if the item mapping has not be built, should call hogl_vf_map_vfi before
+ *		HOGL_ERROR_MEMORY			if the item could not be stored inside the cache
+ *		HOGL_ERROR_BAD_READ			if the item could not be read
+ *		HOGL_ERROR_VF_CHECKSUM		if the item data is corrupted
+*/
+HOGL_API hogl_error hogl_vf_cache_pin(hogl_vf_cache* cache, hogl_vf* vf, size_t index, const void** data, uint64_t* size);
+
+/**
+ * @brief Unpins an item pinned with hogl_vf_cache_pin, once it has no pins left it can be evicted
+ * @param cache Cache
+ * @param vf Virtual file the item belongs to
+ * @param index Index of the item
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the item was unpinned
+ *		HOGL_ERROR_BAD_ARGUMENT		if the item is not pinned
+*/
+HOGL_API hogl_error hogl_vf_cache_unpin(hogl_vf_cache* cache, hogl_vf* vf, size_t index);
+
+/**
+ * @brief Drops all items of the virtual file from the cache, has to be called before the virtual file is freed
+ * or changed
+ * @param cache Cache
+ * @param vf Virtual file whose items are dropped
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if all items were dropped
+ *		HOGL_ERROR_BAD_ARGUMENT		if some items of the virtual file are still pinned, they are kept
+*/
+HOGL_API hogl_error hogl_vf_cache_drop(hogl_vf_cache* cache, hogl_vf* vf);
+
+/**
+ * @brief Gets the counters of the cache
+ * @param cache Cache
+ * @param stats Target pointer
+*/
+HOGL_API void hogl_vf_cache_get_stats(hogl_vf_cache* cache, hogl_vf_cache_stats* stats);
+
+/**
+ * @brief Frees the cache and all item data inside it, pinned data becomes invalid
+ * @param cache Cache to free
+*/
+HOGL_API void hogl_vf_cache_free(hogl_vf_cache* cache);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include "hogl_vf_mount.h"
+
+#include <string.h>
+#include <stdbool.h>
+#include "hogl_core/shared/hogl_log.h"
+#include "hogl_core/shared/hogl_memory.h"
+#include "hogl_core/shared/hogl_hash.h"
+
+#define MOUNT_SLOT_EMPTY ((size_t)-1)
+
+typedef struct _hogl_vf_mount {
+	hogl_vf* vf;
+	int32_t priority;
+} hogl_vf_mount;
+
+typedef struct _hogl_vf_mount_slot {
+	uint64_t hash;
+	size_t mount;
+	size_t item;
+} hogl_vf_mount_slot;
+
+typedef struct _hogl_vf_mounts {
+	// Mounted virtual files in mount order
+	hogl_vf_mount* mounts;
+	size_t mount_count;
+	size_t mount_capacity;
+
+	// Open addressing index of all names, each slot points to the item that currently owns the name
+	hogl_vf_mount_slot* slots;
+	size_t slot_capacity;
+	size_t name_count;
+} hogl_vf_mounts;
+
+bool __mount_overrides(hogl_vf_mounts* mounts, size_t mount, size_t other) {
+	int32_t priority = mounts->mounts[mount].priority;
+	int32_t other_priority = mounts->mounts[other].priority;
+
+	// Mount order breaks ties so the result doesn't depend on the order items are inserted in
+	return priority > other_priority || (priority == other_priority && mount > other);
+}
+
+hogl_vf_mount_slot* __find_slot(hogl_vf_mounts* mounts, uint64_t hash, const char* name) {
+	size_t mask = mounts->slot_capacity - 1;
+	size_t slot = (size_t)hash & mask;
+
+	while (mounts->slots[slot].mount != MOUNT_SLOT_EMPTY) {
+		hogl_vf_mount_slot* current = &mounts->slots[slot];
+		const char* current_name = NULL;
+
+		if (current->hash == hash) {
+			hogl_vf_item_name(mounts->mounts[current->mount].vf, current->item, &current_name);
+
+			if (strcmp(current_name, name) == 0) {
+				return current;
+			}
+		}
+
+		slot = (slot + 1) & mask;
+	}
+
+	// Empty slot the name would be stored in
+	return &mounts->slots[slot];
+}
+
+void __insert_items(hogl_vf_mounts* mounts, size_t mount) {
+	hogl_vf* vf = mounts->mounts[mount].vf;
+	size_t count = hogl_vf_item_count(vf);
+
+	for (size_t i = 0; i < count; i++) {
+		const char* name = NULL;
+		uint64_t hash = 0;
+		hogl_vf_mount_slot* slot = NULL;
+
+		hogl_vf_item_name(vf, i, &name);
+		hash = hogl_hash64(name, strlen(name), 0);
+		slot = __find_slot(mounts, hash, name);
+
+		if (slot->mount == MOUNT_SLOT_EMPTY) {
+			slot->hash = hash;
+			slot->mount = mount;
+			slot->item = i;
+			mounts->name_count++;
+		}
+		else if (__mount_overrides(mounts, mount, slot->mount)) {
+			slot->mount = mount;
+			slot->item = i;
+		}
+	}
+}
+
+hogl_error __rebuild_index(hogl_vf_mounts* mounts) {
+	hogl_vf_mount_slot* new_slots = NULL;
+	size_t new_capacity = 64;
+	size_t item_count = 0;
+
+	for (size_t i = 0; i < mounts->mount_count; i++) {
+		item_count += hogl_vf_item_count(mounts->mounts[i].vf);
+	}
+
+	// Item count is an upper bound of the name count, keep the load factor under 50%
+	while (new_capacity < item_count * 2) {
+		new_capacity *= 2;
+	}
+
+	new_slots = hogl_malloc((unsigned int)(new_capacity * sizeof(hogl_vf_mount_slot)));
+
+	if (new_slots == NULL) {
+		hogl_log_error("Failed to allocate mount table index");
+		return HOGL_ERROR_MEMORY;
+	}
+
+	hogl_free(mounts->slots);
+	mounts->slots = new_slots;
+	mounts->slot_capacity = new_capacity;
+	mounts->name_count = 0;
+
+	for (size_t i = 0; i < new_capacity; i++) {
+		mounts->slots[i].mount = MOUNT_SLOT_EMPTY;
+	}
+
+	for (size_t i = 0; i < mounts->mount_count; i++) {
+		__insert_items(mounts, i);
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_mounts_new(hogl_vf_mounts** mounts) {
+	hogl_vf_mounts* result = hogl_malloc(sizeof(hogl_vf_mounts));
+
+	if (result == NULL) {
+		hogl_log_error("Failed to allocate mount table");
+		return HOGL_ERROR_MEMORY;
+	}
+
+	result->mounts = NULL;
+	result->mount_count = 0;
+	result->mount_capacity = 0;
+	result->slots = NULL;
+	result->slot_capacity = 0;
+	result->name_count = 0;
+
+	if (__rebuild_index(result) != HOGL_ERROR_NONE) {
+		hogl_free(result);
+		return HOGL_ERROR_MEMORY;
+	}
+
+	(*mounts) = result;
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_mounts_add(hogl_vf_mounts* mounts, hogl_vf* vf, int32_t priority) {
+	for (size_t i = 0; i < mounts->mount_count; i++) {
+		if (mounts->mounts[i].vf == vf) {
+			hogl_log_warn("Virtual file is already mounted");
+			return HOGL_ERROR_BAD_ARGUMENT;
+		}
+	}
+
+	if (mounts->mount_count == mounts->mount_capacity) {
+		size_t new_capacity = mounts->mount_capacity == 0 ? 8 : mounts->mount_capacity * 2;
+		hogl_vf_mount* new_mounts = hogl_realloc(mounts->mounts, new_capacity * sizeof(hogl_vf_mount));
+
+		if (new_mounts == NULL) {
+			hogl_log_error("Failed to expand mount table");
+			return HOGL_ERROR_MEMORY;
+		}
+
+		mounts->mounts = new_mounts;
+		mounts->mount_capacity = new_capacity;
+	}
+
+	mounts->mounts[mounts->mount_count].vf = vf;
+	mounts->mounts[mounts->mount_count].priority = priority;
+	mounts->mount_count++;
+
+	// Only the new items are inserted unless the index has to grow
+	if ((mounts->name_count + hogl_vf_item_count(vf)) * 2 > mounts->slot_capacity) {
+		if (__rebuild_index(mounts) != HOGL_ERROR_NONE) {
+			mounts->mount_count--;
+			return HOGL_ERROR_MEMORY;
+		}
+	}
+	else {
+		__insert_items(mounts, mounts->mount_count - 1);
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_mounts_remove(hogl_vf_mounts* mounts, hogl_vf* vf) {
+	hogl_vf_mount removed;
+	size_t mount = 0;
+
+	while (mount < mounts->mount_count && mounts->mounts[mount].vf != vf) {
+		mount++;
+	}
+
+	if (mount == mounts->mount_count) {
+		hogl_log_warn("Virtual file is not mounted");
+		return HOGL_ERROR_BAD_ARGUMENT;
+	}
+
+	removed = mounts->mounts[mount];
+	memmove(&mounts->mounts[mount], &mounts->mounts[mount + 1], (mounts->mount_count - mount - 1) * sizeof(hogl_vf_mount));
+	mounts->mount_count--;
+
+	// Names it owned may belong to any other mount now, rebuilding is simpler than tracking shadowed items
+	if (__rebuild_index(mounts) != HOGL_ERROR_NONE) {
+		// Keep the old index consistent by mounting the virtual file back
+		memmove(&mounts->mounts[mount + 1], &mounts->mounts[mount], (mounts->mount_count - mount) * sizeof(hogl_vf_mount));
+		mounts->mounts[mount] = removed;
+		mounts->mount_count++;
+		return HOGL_ERROR_MEMORY;
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_mounts_find(hogl_vf_mounts* mounts, const char* name, hogl_vf** vf, size_t* index) {
+	hogl_vf_mount_slot* slot = __find_slot(mounts, hogl_hash64(name, strlen(name), 0), name);
+
+	if (slot->mount == MOUNT_SLOT_EMPTY) {
+		return HOGL_ERROR_VF_BAD_NAME;
+	}
+
+	(*vf) = mounts->mounts[slot->mount].vf;
+	(*index) = slot->item;
+
+	return HOGL_ERROR_NONE;
+}
+
+size_t hogl_vf_mounts_name_count(hogl_vf_mounts* mounts) {
+	return mounts->name_count;
+}
+
+void hogl_vf_mounts_free(hogl_vf_mounts* mounts) {
+	hogl_free(mounts->mounts);
+	hogl_free(mounts->slots);
+	hogl_free(mounts);
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+/**
+* @brief hogl virtual file mount header contains functionality for layering multiple virtual files into a single
+* name space, for example a base pack, patch packs on top of it and mods on top of those
+*/
+
+#ifndef _HOGL_VF_MOUNT_
+#define _HOGL_VF_MOUNT_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "hogl_core/shared/hogl_def.h"
+#include "hogl_core/io/hogl_vf.h"
+
+/**
+ * @brief Mount table object, keeps a single hash index of the item names of all mounted virtual files where
+ * every name points to the item of the highest priority virtual file that contains it
+*/
+typedef struct _hogl_vf_mounts hogl_vf_mounts;
+
+/**
+ * @brief Creates a new empty mount table
+ * @param mounts The result will be stored inside the mounts pointer
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the mount table was created
+ *		HOGL_ERROR_MEMORY			if the mount table could not be allocated
+*/
+HOGL_API hogl_error hogl_vf_mounts_new(hogl_vf_mounts** mounts);
+
+/**
+ * @brief Mounts the virtual file, its items override items with the same name of virtual files mounted with a lower
+ * priority, for equal priorities the virtual file mounted last wins. The virtual file is not owned by the mount
+ * table and must not be changed (items added, removed or renamed) or freed until it is unmounted
+ * @param mounts Mount table
+ * @param vf Virtual file to mount, can be opened using hogl_vf_read or hogl_vf_open_index
+ * @param priority Priority of the virtual file, higher priorities override lower ones
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the virtual file was mounted
+ *		HOGL_ERROR_BAD_ARGUMENT		if the virtual file is already mounted
+ *		HOGL_ERROR_MEMORY			if the mount table could not be expanded, the virtual file is not mounted
+*/
+HOGL_API hogl_error hogl_vf_mounts_add(hogl_vf_mounts* mounts, hogl_vf* vf, int32_t priority);
+
+/**
+ * @brief Unmounts the virtual file, names it overrode resolve to the virtual files below it again
+ * @param mounts Mount table
+ * @param vf Virtual file to unmount
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the virtual file was unmounted
+ *		HOGL_ERROR_BAD_ARGUMENT		if the virtual file is not mounted
+ *		HOGL_ERROR_MEMORY			if the index could not be rebuilt, the virtual file stays mounted
+*/
+HOGL_API hogl_error hogl_vf_mounts_remove(hogl_vf_mounts* mounts, hogl_vf* vf);
+
+/**
+ * @brief Finds the item with the specified name, the lookup goes through the merged index so its cost doesn't
+ * depend on the number of mounted virtual files
+ * @param mounts Mount table
+ * @param name Name of the item
+ * @param vf Receives the virtual file that owns the item
+ * @param index Receives the index of the item inside that virtual file
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the item was found
+ *		HOGL_ERROR_VF_BAD_NAME		if no mounted virtual file contains the name
+*/
+HOGL_API hogl_error hogl_vf_mounts_find(hogl_vf_mounts* mounts, const char* name, hogl_vf** vf, size_t* index);
+
+/**
+ * @brief Gets the number of unique item names across all mounted virtual files
+ * @param mounts Mount table
+ * @return Name count
+*/
+HOGL_API size_t hogl_vf_mounts_name_count(hogl_vf_mounts* mounts);
+
+/**
+ * @brief Frees the mount table, mounted virtual files are not freed
+ * @param mounts Mount table to free
+*/
+HOGL_API void hogl_vf_mounts_free(hogl_vf_mounts* mounts);
+
+#endif
\ No newline at end of file
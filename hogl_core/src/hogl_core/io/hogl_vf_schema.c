@@ -0,0 +1,349 @@
+#include "hogl_vf_schema.h"
+
+#include <string.h>
+#include "hogl_core/shared/hogl_log.h"
+#include "hogl_core/shared/hogl_memory.h"
+
+typedef struct _hogl_vf_schema_type {
+	uint32_t type;
+	hogl_vf_layout layout;
+} hogl_vf_schema_type;
+
+typedef struct _hogl_vf_schema {
+	// Sorted by type
+	hogl_vf_schema_type* types;
+	size_t type_count;
+	size_t type_capacity;
+} hogl_vf_schema;
+
+size_t __schema_lower_bound(hogl_vf_schema* schema, uint32_t type) {
+	size_t low = 0;
+	size_t high = schema->type_count;
+
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+
+		if (schema->types[mid].type < type) {
+			low = mid + 1;
+		}
+		else {
+			high = mid;
+		}
+	}
+
+	return low;
+}
+
+uint64_t __element_size(uint32_t type) {
+	switch (type) {
+	case HOGL_ET_FLOAT:
+	case HOGL_ET_UINT:
+		return 4;
+	case HOGL_ET_USHORT:
+		return 2;
+	case HOGL_ET_UBYTE:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+uint64_t __format_channels(uint32_t format) {
+	switch (format) {
+	case HOGL_TF_RED:
+	case HOGL_TF_R16F:
+		return 1;
+	case HOGL_TF_RG:
+	case HOGL_TF_RG16F:
+		return 2;
+	case HOGL_TF_RGB:
+	case HOGL_TF_RGB16F:
+		return 3;
+	case HOGL_TF_RGBA:
+	case HOGL_TF_RGBA16F:
+		return 4;
+	default:
+		return 0;
+	}
+}
+
+hogl_error __parse_mesh(hogl_vf_view* view) {
+	hogl_vf_mesh_header* header = &view->mesh;
+	uint64_t index_size = __element_size(header->index_type);
+
+	// Index buffers are drawn as 32 or 16 bit indices
+	if (header->attribute_count > HOGL_VF_MAX_ATTRIBUTES || header->vertex_stride == 0 ||
+		(header->index_count != 0 && header->index_type != HOGL_ET_UINT && header->index_type != HOGL_ET_USHORT)) {
+		hogl_log_error("Mesh item has an invalid header");
+		return HOGL_ERROR_BAD_READ;
+	}
+
+	for (uint32_t i = 0; i < header->attribute_count; i++) {
+		hogl_vf_attribute* attribute = &header->attributes[i];
+		uint64_t end = attribute->offset + attribute->ecount * __element_size(attribute->type);
+
+		if (attribute->ecount < 1 || attribute->ecount > 4 || __element_size(attribute->type) == 0 || end > header->vertex_stride) {
+			hogl_log_error("Mesh item attribute %d doesn't fit inside a vertex", i);
+			return HOGL_ERROR_BAD_READ;
+		}
+	}
+
+	if ((uint64_t)header->vertex_count * header->vertex_stride + (uint64_t)header->index_count * index_size > view->size) {
+		hogl_log_error("Mesh item is smaller than its header says");
+		return HOGL_ERROR_BAD_READ;
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+// GL reads every row but the last one with its padding to the default unpack alignment of 4 bytes
+bool __mip_fits(const hogl_vf_mip* mip, uint64_t texel_size) {
+	uint64_t row = (uint64_t)mip->width * texel_size;
+	uint64_t pitch = (row + 3) & ~(uint64_t)3;
+
+	if (mip->width == 0 || mip->height == 0) {
+		return true;
+	}
+
+	// Divide instead of multiplying so hostile sizes can't overflow
+	return row <= mip->size && (mip->height == 1 || pitch <= (mip->size - row) / (mip->height - 1));
+}
+
+hogl_error __parse_texture(hogl_vf_view* view) {
+	hogl_vf_texture_header* header = &view->texture;
+	uint64_t texel_size = __format_channels(header->data_format) * __element_size(header->element_type);
+
+	if (header->mip_count == 0 || header->mip_count > HOGL_VF_MAX_MIPS || texel_size == 0) {
+		hogl_log_error("Texture item has an invalid header");
+		return HOGL_ERROR_BAD_READ;
+	}
+
+	for (uint32_t i = 0; i < header->mip_count; i++) {
+		hogl_vf_mip* mip = &header->mips[i];
+
+		if ((uint64_t)mip->offset + mip->size > view->size || !__mip_fits(mip, texel_size)) {
+			hogl_log_error("Texture item mip level %d doesn't fit inside the item", i);
+			return HOGL_ERROR_BAD_READ;
+		}
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_schema_new(hogl_vf_schema** schema) {
+	hogl_vf_schema* result = hogl_malloc(sizeof(hogl_vf_schema));
+
+	if (result == NULL) {
+		hogl_log_error("Failed to allocate virtual file schema");
+		return HOGL_ERROR_MEMORY;
+	}
+
+	result->types = NULL;
+	result->type_count = 0;
+	result->type_capacity = 0;
+
+	(*schema) = result;
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_schema_register(hogl_vf_schema* schema, uint32_t type, hogl_vf_layout layout) {
+	size_t position = __schema_lower_bound(schema, type);
+
+	if (position < schema->type_count && schema->types[position].type == type) {
+		schema->types[position].layout = layout;
+		return HOGL_ERROR_NONE;
+	}
+
+	if (schema->type_count == schema->type_capacity) {
+		size_t new_capacity = schema->type_capacity == 0 ? 16 : schema->type_capacity * 2;
+		hogl_vf_schema_type* new_types = hogl_realloc(schema->types, new_capacity * sizeof(hogl_vf_schema_type));
+
+		if (new_types == NULL) {
+			hogl_log_error("Failed to expand virtual file schema");
+			return HOGL_ERROR_MEMORY;
+		}
+
+		schema->types = new_types;
+		schema->type_capacity = new_capacity;
+	}
+
+	memmove(&schema->types[position + 1], &schema->types[position], (schema->type_count - position) * sizeof(hogl_vf_schema_type));
+	schema->types[position].type = type;
+	schema->types[position].layout = layout;
+	schema->type_count++;
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_vf_layout hogl_vf_schema_layout(hogl_vf_schema* schema, uint32_t type) {
+	size_t position = __schema_lower_bound(schema, type);
+
+	if (position < schema->type_count && schema->types[position].type == type) {
+		return schema->types[position].layout;
+	}
+
+	return HOGL_VFL_RAW;
+}
+
+hogl_error hogl_vf_schema_view(hogl_vf_schema* schema, hogl_vf* vf, size_t index, hogl_vf_view* view) {
+	uint32_t type = 0;
+	uint64_t size = 0;
+	void* data = NULL;
+	bool foreign = false;
+	hogl_error error = HOGL_ERROR_NONE;
+
+	if ((error = hogl_vf_item_type(vf, index, &type)) != HOGL_ERROR_NONE ||
+		(error = hogl_vf_item_size(vf, index, &size)) != HOGL_ERROR_NONE ||
+		(error = hogl_vf_item_foreign(vf, index, &foreign)) != HOGL_ERROR_NONE) {
+		return error;
+	}
+
+	// Headers are read as is, typed items have to be swapped before they can be viewed
+	if (foreign && hogl_vf_schema_layout(schema, type) != HOGL_VFL_RAW) {
+		hogl_log_error("Item %ld was written with a different byte order", index);
+		return HOGL_ERROR_ENDIAN_MISMATCH;
+	}
+
+	error = hogl_vf_map_item(vf, index, &data);
+
+	if (error != HOGL_ERROR_NONE) {
+		return error;
+	}
+
+	return hogl_vf_schema_view_data(schema, type, data, size, view);
+}
+
+hogl_error hogl_vf_schema_view_data(hogl_vf_schema* schema, uint32_t type, const void* data, uint64_t size, hogl_vf_view* view) {
+	size_t header_size = 0;
+	void* header = NULL;
+
+	hogl_memset(view, 0, sizeof(hogl_vf_view));
+	view->layout = hogl_vf_schema_layout(schema, type);
+
+	switch (view->layout) {
+	case HOGL_VFL_MESH:
+		header = &view->mesh;
+		header_size = sizeof(hogl_vf_mesh_header);
+		break;
+	case HOGL_VFL_TEXTURE:
+		header = &view->texture;
+		header_size = sizeof(hogl_vf_texture_header);
+		break;
+	case HOGL_VFL_AUDIO:
+		header = &view->audio;
+		header_size = sizeof(hogl_vf_audio_header);
+		break;
+	default:
+		break;
+	}
+
+	if (size < header_size) {
+		hogl_log_error("Item is smaller than its header");
+		return HOGL_ERROR_BAD_READ;
+	}
+
+	// Item data has no alignment so only the header is copied out, the payload is used in place
+	if (header_size != 0) {
+		hogl_smemcpy(header, data, header_size);
+	}
+
+	view->data = (const char*)data + header_size;
+	view->size = size - header_size;
+
+	switch (view->layout) {
+	case HOGL_VFL_MESH:
+		return __parse_mesh(view);
+	case HOGL_VFL_TEXTURE:
+		return __parse_texture(view);
+	default:
+		return HOGL_ERROR_NONE;
+	}
+}
+
+#ifdef HOGL_SUITE_GRAPHICS
+hogl_error hogl_vf_view_vbo_descs(const hogl_vf_view* view, hogl_vbo_usage usage, hogl_vbo_desc* descs,
+	hogl_ap_desc* aps, size_t* count) {
+	const hogl_vf_mesh_header* header = &view->mesh;
+	uint64_t vertices_size = (uint64_t)header->vertex_count * header->vertex_stride;
+
+	if (view->layout != HOGL_VFL_MESH) {
+		hogl_log_error("Trying to create vbo descriptions from a view that is not a mesh");
+		return HOGL_ERROR_BAD_ARGUMENT;
+	}
+
+	for (uint32_t i = 0; i < header->attribute_count; i++) {
+		aps[i].index = (int)header->attributes[i].index;
+		aps[i].ecount = (int)header->attributes[i].ecount;
+		aps[i].type = (hogl_element_type)header->attributes[i].type;
+		aps[i].normalized = header->attributes[i].normalized != 0;
+		aps[i].stride = header->vertex_stride;
+		aps[i].offset = header->attributes[i].offset;
+		aps[i].divisor = (int)header->attributes[i].divisor;
+	}
+
+	descs[0].type = HOGL_VBOT_ARRAY_BUFFER;
+	descs[0].usage = usage;
+	descs[0].ap_desc = aps;
+	descs[0].desc_size = header->attribute_count;
+	descs[0].data_size = (size_t)vertices_size;
+	descs[0].data = (void*)view->data;
+	descs[0].index_type = HOGL_IT_UINT32;
+	(*count) = 1;
+
+	if (header->index_count != 0) {
+		descs[1].type = HOGL_VBOT_ELEMENT_BUFFER;
+		descs[1].usage = usage;
+		descs[1].ap_desc = NULL;
+		descs[1].desc_size = 0;
+		descs[1].data_size = (size_t)(header->index_count * __element_size(header->index_type));
+		descs[1].data = (void*)((const char*)view->data + vertices_size);
+		descs[1].index_type = header->index_type == HOGL_ET_USHORT ? HOGL_IT_UINT16 : HOGL_IT_UINT32;
+		(*count) = 2;
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_vf_view_texture_data(const hogl_vf_view* view, uint32_t mip, hogl_texture_data* data) {
+	if (view->layout != HOGL_VFL_TEXTURE) {
+		hogl_log_error("Trying to create texture data from a view that is not a texture");
+		return HOGL_ERROR_BAD_ARGUMENT;
+	}
+
+	if (mip >= view->texture.mip_count) {
+		hogl_log_warn("Texture item doesn't have mip level %d", mip);
+		return HOGL_ERROR_OUT_OF_RANGE;
+	}
+
+	data->display_format = (hogl_texture_format)view->texture.display_format;
+	data->data_format = (hogl_texture_format)view->texture.data_format;
+	data->etype = (hogl_element_type)view->texture.element_type;
+	data->width = view->texture.mips[mip].width;
+	data->height = view->texture.mips[mip].height;
+	data->data = (void*)((const char*)view->data + view->texture.mips[mip].offset);
+
+	return HOGL_ERROR_NONE;
+}
+#endif
+
+#ifdef HOGL_SUITE_AUDIO
+hogl_error hogl_vf_view_abuffer_desc(const hogl_vf_view* view, hogl_abuffer_desc* desc) {
+	if (view->layout != HOGL_VFL_AUDIO) {
+		hogl_log_error("Trying to create an audio buffer description from a view that is not audio");
+		return HOGL_ERROR_BAD_ARGUMENT;
+	}
+
+	desc->data = (void*)view->data;
+	desc->data_size = (size_t)view->size;
+	desc->format = (hogl_audio_format)view->audio.format;
+	desc->sample_rate = view->audio.sample_rate;
+
+	return HOGL_ERROR_NONE;
+}
+#endif
+
+void hogl_vf_schema_free(hogl_vf_schema* schema) {
+	hogl_free(schema->types);
+	hogl_free(schema);
+}
\ No newline at end of file
@@ -0,0 +1,275 @@
+/**
+* @brief hogl virtual file schema header contains functionality for describing the layout of typed virtual file
+* items and reading them through views that point straight into the item data
+*/
+
+#ifndef _HOGL_VF_SCHEMA_
+#define _HOGL_VF_SCHEMA_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "hogl_core/shared/hogl_def.h"
+#include "hogl_core/io/hogl_vf.h"
+
+#ifdef HOGL_SUITE_GRAPHICS
+#include "hogl_core/graphics/hogl_gl_primitive.h"
+#endif
+
+#ifdef HOGL_SUITE_AUDIO
+#include "hogl_core/audio/hogl_al_primitive.h"
+#endif
+
+/**
+ * @brief Maximum number of vertex attributes of a mesh item
+*/
+#define HOGL_VF_MAX_ATTRIBUTES 8
+
+/**
+ * @brief Maximum number of mip levels of a texture item
+*/
+#define HOGL_VF_MAX_MIPS 16
+
+/**
+ * @brief Schema object, maps item type ids to layouts
+*/
+typedef struct _hogl_vf_schema hogl_vf_schema;
+
+/**
+ * @brief Item layouts, every layout other than raw starts with its header followed by the payload
+*/
+typedef enum {
+	/**
+	 * @brief No header, the whole item is payload
+	*/
+	HOGL_VFL_RAW,
+
+	/**
+	 * @brief hogl_vf_mesh_header, vertex_count * vertex_stride bytes of vertices, index_count indices
+	*/
+	HOGL_VFL_MESH,
+
+	/**
+	 * @brief hogl_vf_texture_header, mip level data at the offsets stored inside the header
+	*/
+	HOGL_VFL_TEXTURE,
+
+	/**
+	 * @brief hogl_vf_audio_header, sample data
+	*/
+	HOGL_VFL_AUDIO
+} hogl_vf_layout;
+
+/**
+ * @brief Vertex attribute of a mesh item, same meaning as the fields of hogl_ap_desc
+*/
+typedef struct _hogl_vf_attribute {
+	uint32_t index;
+	uint32_t ecount;
+
+	/**
+	 * @brief hogl_element_type value
+	*/
+	uint32_t type;
+	uint32_t normalized;
+
+	/**
+	 * @brief Offset of the attribute inside a vertex
+	*/
+	uint32_t offset;
+	uint32_t divisor;
+} hogl_vf_attribute;
+
+/**
+ * @brief Header of a mesh item, vertices are interleaved
+*/
+typedef struct _hogl_vf_mesh_header {
+	uint32_t vertex_count;
+	uint32_t vertex_stride;
+
+	/**
+	 * @brief Number of indices, 0 if the mesh is not indexed
+	*/
+	uint32_t index_count;
+
+	/**
+	 * @brief hogl_element_type value of the indices, HOGL_ET_UINT or HOGL_ET_USHORT
+	*/
+	uint32_t index_type;
+
+	uint32_t attribute_count;
+	hogl_vf_attribute attributes[HOGL_VF_MAX_ATTRIBUTES];
+} hogl_vf_mesh_header;
+
+/**
+ * @brief Mip level of a texture item, rows are padded to 4 bytes like the default OpenGL unpack alignment expects
+*/
+typedef struct _hogl_vf_mip {
+	uint32_t width;
+	uint32_t height;
+
+	/**
+	 * @brief Offset of the level data from the start of the payload
+	*/
+	uint32_t offset;
+	uint32_t size;
+} hogl_vf_mip;
+
+/**
+ * @brief Header of a texture item
+*/
+typedef struct _hogl_vf_texture_header {
+	/**
+	 * @brief hogl_texture_format values
+	*/
+	uint32_t display_format;
+	uint32_t data_format;
+
+	/**
+	 * @brief hogl_element_type value
+	*/
+	uint32_t element_type;
+
+	uint32_t mip_count;
+	hogl_vf_mip mips[HOGL_VF_MAX_MIPS];
+} hogl_vf_texture_header;
+
+/**
+ * @brief Header of an audio item
+*/
+typedef struct _hogl_vf_audio_header {
+	/**
+	 * @brief hogl_audio_format value
+	*/
+	uint32_t format;
+	uint32_t sample_rate;
+} hogl_vf_audio_header;
+
+/**
+ * @brief Typed view of an item, the header is copied out of the item but the payload is not
+*/
+typedef struct _hogl_vf_view {
+	hogl_vf_layout layout;
+
+	/**
+	 * @brief Payload following the header, points into the item data and is only valid as long as it is
+	*/
+	const void* data;
+	uint64_t size;
+
+	/**
+	 * @brief Header of the item, only the one matching the layout is set
+	*/
+	hogl_vf_mesh_header mesh;
+	hogl_vf_texture_header texture;
+	hogl_vf_audio_header audio;
+} hogl_vf_view;
+
+/**
+ * @brief Creates a new schema without any registered types, unregistered types are raw
+ * @param schema The result will be stored inside the schema pointer
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the schema was created
+ *		HOGL_ERROR_MEMORY			if the schema could not be allocated
+*/
+HOGL_API hogl_error hogl_vf_schema_new(hogl_vf_schema** schema);
+
+/**
+ * @brief Registers the layout of an item type, registering a type again replaces its layout
+ * @param schema Schema
+ * @param type Item type id used with hogl_vf_add_item
+ * @param layout Layout of items with this type
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the type was registered
+ *		HOGL_ERROR_MEMORY			if the schema could not be expanded
+*/
+HOGL_API hogl_error hogl_vf_schema_register(hogl_vf_schema* schema, uint32_t type, hogl_vf_layout layout);
+
+/**
+ * @brief Gets the layout registered for the item type
+ * @param schema Schema
+ * @param type Item type id
+ * @return Layout of the type, HOGL_VFL_RAW if the type is not registered
+*/
+HOGL_API hogl_vf_layout hogl_vf_schema_layout(hogl_vf_schema* schema, uint32_t type);
+
+/**
+ * @brief Creates a view of the item, the item data is mapped so the virtual file has to be loaded
+ * using hogl_vf_read, for virtual files opened with hogl_vf_open_index use hogl_vf_schema_view_data
+ * @param schema Schema
+ * @param vf Virtual file
+ * @param index Index of the item
+ * @param view Target view
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the view was created
+ *		HOGL_ERROR_OUT_OF_RANGE		if index was out of range in virtual file
+ *		HOGL_ERROR_VF_VFI_MAP		if the item mapping has not be built, should call hogl_vf_map_vfi before
+ *		HOGL_ERROR_VF_NOT_LOADED	if the virtual file data is not in memory
+ *		HOGL_ERROR_ENDIAN_MISMATCH	if the item was written on a machine with a different byte order
+ *		HOGL_ERROR_VF_CHECKSUM		if the item data is corrupted
+ *		HOGL_ERROR_BAD_READ			if the item is too small or its header doesn't match its size
+*/
+HOGL_API hogl_error hogl_vf_schema_view(hogl_vf_schema* schema, hogl_vf* vf, size_t index, hogl_vf_view* view);
+
+/**
+ * @brief Creates a view of item data that is already in memory, for example pinned inside a hogl_vf_cache
+ * @param schema Schema
+ * @param type Type of the item
+ * @param data Item data
+ * @param size Item size
+ * @param view Target view
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the view was created
+ *		HOGL_ERROR_BAD_READ			if the item is too small or its header doesn't match its size
+*/
+HOGL_API hogl_error hogl_vf_schema_view_data(hogl_vf_schema* schema, uint32_t type, const void* data, uint64_t size, hogl_vf_view* view);
+
+#ifdef HOGL_SUITE_GRAPHICS
+/**
+ * @brief Fills vbo descriptions for a mesh view that can be passed to hogl_vao_alloc_buffers, the data of the
+ * descriptions points into the item data and must not be modified
+ * @param view Mesh view
+ * @param usage Usage of the buffers
+ * @param descs Array of at least 2 descriptions, the vertex buffer and the index buffer if the mesh is indexed
+ * @param aps Array of at least HOGL_VF_MAX_ATTRIBUTES attribute pointer descriptions used by descs
+ * @param count Receives the number of descriptions filled
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the descriptions were filled
+ *		HOGL_ERROR_BAD_ARGUMENT		if the view is not a mesh view
+*/
+HOGL_API hogl_error hogl_vf_view_vbo_descs(const hogl_vf_view* view, hogl_vbo_usage usage, hogl_vbo_desc* descs,
+	hogl_ap_desc* aps, size_t* count);
+
+/**
+ * @brief Fills texture data for a mip level of a texture view that can be passed to hogl_set_texture_data,
+ * the data points into the item data and must not be modified
+ * @param view Texture view
+ * @param mip Mip level
+ * @param data Target texture data
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the texture data was filled
+ *		HOGL_ERROR_BAD_ARGUMENT		if the view is not a texture view
+ *		HOGL_ERROR_OUT_OF_RANGE		if the texture doesn't have the mip level
+*/
+HOGL_API hogl_error hogl_vf_view_texture_data(const hogl_vf_view* view, uint32_t mip, hogl_texture_data* data);
+#endif
+
+#ifdef HOGL_SUITE_AUDIO
+/**
+ * @brief Fills an audio buffer description for an audio view that can be passed to hogl_abuffer_new,
+ * the data points into the item data and must not be modified
+ * @param view Audio view
+ * @param desc Target description
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the description was filled
+ *		HOGL_ERROR_BAD_ARGUMENT		if the view is not an audio view
+*/
+HOGL_API hogl_error hogl_vf_view_abuffer_desc(const hogl_vf_view* view, hogl_abuffer_desc* desc);
+#endif
+
+/**
+ * @brief Frees the schema
+ * @param schema Schema to free
+*/
+HOGL_API void hogl_vf_schema_free(hogl_vf_schema* schema);
+
+#endif
\ No newline at end of file
@@ -1,9 +1,30 @@
 #include "hogl_os.h"
 
+#include <stdio.h>
+#include <string.h>
+#include "hogl_core/shared/hogl_memory.h"
+
+// Longest path hogl_dir_walk builds
+#define HOGL_OS_PATH_MAX 4096
+
 #ifdef _WIN32
 
 #include <Windows.h>
 
+typedef struct _hogl_thread {
+	HANDLE handle;
+	hogl_thread_fn fn;
+	void* usrp;
+} hogl_thread;
+
+typedef struct _hogl_mutex {
+	CRITICAL_SECTION cs;
+} hogl_mutex;
+
+typedef struct _hogl_cond {
+	CONDITION_VARIABLE cv;
+} hogl_cond;
+
 unsigned long hogl_get_thread_id(void) {
 	return GetCurrentThreadId();
 }
@@ -24,9 +45,503 @@ int hogl_atomic_substract_b32(int* variable, int value) {
 	return InterlockedExchangeAdd(variable, value * -1);
 }
 
+hogl_file hogl_file_open(const char* path) {
+	// Others may keep writing the file, the vf writer reads back data it is still appending to
+	HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	return (hogl_file)handle;
+}
+
+uint64_t hogl_file_pread(hogl_file file, void* dst, uint64_t size, uint64_t offset) {
+	uint64_t total = 0;
+
+	// ReadFile can only read DWORD amount of bytes at once
+	while (total < size) {
+		OVERLAPPED ov = { 0 };
+		DWORD chunk = (size - total) > 0x40000000 ? 0x40000000 : (DWORD)(size - total);
+		DWORD rsize = 0;
+
+		ov.Offset = (DWORD)((offset + total) & 0xFFFFFFFF);
+		ov.OffsetHigh = (DWORD)((offset + total) >> 32);
+
+		if (!ReadFile((HANDLE)file, (char*)dst + total, chunk, &rsize, &ov) || rsize == 0) {
+			break;
+		}
+
+		total += rsize;
+	}
+
+	return total;
+}
+
+uint64_t hogl_file_size(hogl_file file) {
+	LARGE_INTEGER size;
+
+	if (!GetFileSizeEx((HANDLE)file, &size)) {
+		return 0;
+	}
+
+	return (uint64_t)size.QuadPart;
+}
+
+void hogl_file_close(hogl_file file) {
+	CloseHandle((HANDLE)file);
+}
+
+void* hogl_file_map(hogl_file file, uint64_t size) {
+	HANDLE mapping = NULL;
+	void* data = NULL;
+
+	if (size == 0) {
+		return NULL;
+	}
+
+	mapping = CreateFileMappingA((HANDLE)file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+
+	if (mapping == NULL) {
+		return NULL;
+	}
+
+	data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, (SIZE_T)size);
+
+	// The view keeps the mapping object alive
+	CloseHandle(mapping);
+
+	return data;
+}
+
+void hogl_file_unmap(void* data, uint64_t size) {
+	UnmapViewOfFile(data);
+}
+
+void hogl_file_prefetch(hogl_file file, uint64_t offset, uint64_t size) {
+	// No read ahead hint for file handles, mapped memory can use hogl_memory_prefetch
+}
+
+void hogl_file_advise(hogl_file file, hogl_access_pattern pattern) {
+	// Access pattern can only be given when opening the file
+}
+
+void hogl_memory_prefetch(void* data, uint64_t size) {
+	WIN32_MEMORY_RANGE_ENTRY range;
+
+	range.VirtualAddress = data;
+	range.NumberOfBytes = (SIZE_T)size;
+
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+void hogl_memory_advise(void* data, uint64_t size, hogl_access_pattern pattern) {
+	// Windows has no access pattern hints for mapped views
+}
+
+hogl_error hogl_dir_walk(const char* path, hogl_dir_fn fn, void* usrp) {
+	WIN32_FIND_DATAA data;
+	HANDLE find = INVALID_HANDLE_VALUE;
+	char child[HOGL_OS_PATH_MAX];
+
+	if (snprintf(child, sizeof(child), "%s/*", path) >= (int)sizeof(child)) {
+		return HOGL_ERROR_BAD_PATH;
+	}
+
+	find = FindFirstFileA(child, &data);
+
+	if (find == INVALID_HANDLE_VALUE) {
+		return HOGL_ERROR_BAD_PATH;
+	}
+
+	do {
+		if (strcmp(data.cFileName, ".") == 0 || strcmp(data.cFileName, "..") == 0) {
+			continue;
+		}
+
+		if (snprintf(child, sizeof(child), "%s/%s", path, data.cFileName) >= (int)sizeof(child)) {
+			continue;
+		}
+
+		// Linked directories and junctions are skipped, they can form cycles
+		if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0) {
+			if ((data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) == 0) {
+				hogl_dir_walk(child, fn, usrp);
+			}
+		}
+		else {
+			fn(child, usrp);
+		}
+	} while (FindNextFileA(find, &data));
+
+	FindClose(find);
+
+	return HOGL_ERROR_NONE;
+}
+
+unsigned int hogl_cpu_count(void) {
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? info.dwNumberOfProcessors : 1;
+}
+
+DWORD WINAPI __thread_entry(LPVOID p) {
+	hogl_thread* thread = (hogl_thread*)p;
+	thread->fn(thread->usrp);
+	return 0;
+}
+
+hogl_thread* hogl_thread_new(hogl_thread_fn fn, void* usrp) {
+	hogl_thread* thread = hogl_malloc(sizeof(hogl_thread));
+
+	if (thread == NULL) {
+		return NULL;
+	}
+
+	thread->fn = fn;
+	thread->usrp = usrp;
+	thread->handle = CreateThread(NULL, 0, __thread_entry, thread, 0, NULL);
+
+	if (thread->handle == NULL) {
+		hogl_free(thread);
+		return NULL;
+	}
+
+	return thread;
+}
+
+void hogl_thread_join(hogl_thread* thread) {
+	WaitForSingleObject(thread->handle, INFINITE);
+	CloseHandle(thread->handle);
+	hogl_free(thread);
+}
+
+hogl_mutex* hogl_mutex_new(void) {
+	hogl_mutex* mutex = hogl_malloc(sizeof(hogl_mutex));
+
+	if (mutex == NULL) {
+		return NULL;
+	}
+
+	InitializeCriticalSection(&mutex->cs);
+	return mutex;
+}
+
+void hogl_mutex_lock(hogl_mutex* mutex) {
+	EnterCriticalSection(&mutex->cs);
+}
+
+void hogl_mutex_unlock(hogl_mutex* mutex) {
+	LeaveCriticalSection(&mutex->cs);
+}
+
+void hogl_mutex_free(hogl_mutex* mutex) {
+	DeleteCriticalSection(&mutex->cs);
+	hogl_free(mutex);
+}
+
+hogl_cond* hogl_cond_new(void) {
+	hogl_cond* cond = hogl_malloc(sizeof(hogl_cond));
+
+	if (cond == NULL) {
+		return NULL;
+	}
+
+	InitializeConditionVariable(&cond->cv);
+	return cond;
+}
+
+void hogl_cond_wait(hogl_cond* cond, hogl_mutex* mutex) {
+	SleepConditionVariableCS(&cond->cv, &mutex->cs, INFINITE);
+}
+
+void hogl_cond_signal(hogl_cond* cond) {
+	WakeConditionVariable(&cond->cv);
+}
+
+void hogl_cond_broadcast(hogl_cond* cond) {
+	WakeAllConditionVariable(&cond->cv);
+}
+
+void hogl_cond_free(hogl_cond* cond) {
+	hogl_free(cond);
+}
+
 #elif __linux__
 
-// NOT YET IMPLEMENTED
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+// Thread id functionality is NOT YET IMPLEMENTED
+
+typedef struct _hogl_thread {
+	pthread_t handle;
+	hogl_thread_fn fn;
+	void* usrp;
+} hogl_thread;
+
+typedef struct _hogl_mutex {
+	pthread_mutex_t mtx;
+} hogl_mutex;
+
+typedef struct _hogl_cond {
+	pthread_cond_t cv;
+} hogl_cond;
+
+int hogl_atomic_set_b32(int* destination, int newValue) {
+	return __atomic_exchange_n(destination, newValue, __ATOMIC_SEQ_CST);
+}
+
+int hogl_atomic_get_b32(int* variable) {
+	return __atomic_load_n(variable, __ATOMIC_SEQ_CST);
+}
+
+int hogl_atomic_add_b32(int* destination, int value) {
+	return __atomic_fetch_add(destination, value, __ATOMIC_SEQ_CST);
+}
+
+int hogl_atomic_substract_b32(int* variable, int value) {
+	return __atomic_fetch_sub(variable, value, __ATOMIC_SEQ_CST);
+}
+
+hogl_file hogl_file_open(const char* path) {
+	return (hogl_file)open(path, O_RDONLY);
+}
+
+uint64_t hogl_file_pread(hogl_file file, void* dst, uint64_t size, uint64_t offset) {
+	uint64_t total = 0;
+
+	while (total < size) {
+		ssize_t rsize = pread((int)file, (char*)dst + total, size - total, (off_t)(offset + total));
+
+		if (rsize <= 0) {
+			break;
+		}
+
+		total += (uint64_t)rsize;
+	}
+
+	return total;
+}
+
+uint64_t hogl_file_size(hogl_file file) {
+	struct stat st;
+
+	if (fstat((int)file, &st) != 0) {
+		return 0;
+	}
+
+	return (uint64_t)st.st_size;
+}
+
+void hogl_file_close(hogl_file file) {
+	close((int)file);
+}
+
+void* hogl_file_map(hogl_file file, uint64_t size) {
+	void* data = NULL;
+
+	if (size == 0) {
+		return NULL;
+	}
+
+	data = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_PRIVATE, (int)file, 0);
+
+	return data != MAP_FAILED ? data : NULL;
+}
+
+void hogl_file_unmap(void* data, uint64_t size) {
+	munmap(data, (size_t)size);
+}
+
+void hogl_file_prefetch(hogl_file file, uint64_t offset, uint64_t size) {
+	posix_fadvise((int)file, (off_t)offset, (off_t)size, POSIX_FADV_WILLNEED);
+}
+
+void hogl_file_advise(hogl_file file, hogl_access_pattern pattern) {
+	int advice = POSIX_FADV_NORMAL;
+
+	if (pattern == HOGL_ACCESS_SEQUENTIAL) {
+		advice = POSIX_FADV_SEQUENTIAL;
+	}
+	else if (pattern == HOGL_ACCESS_RANDOM) {
+		advice = POSIX_FADV_RANDOM;
+	}
+
+	// Zero length applies the advice up to the end of the file
+	posix_fadvise((int)file, 0, 0, advice);
+}
+
+// madvise only accepts page aligned addresses
+void __page_range(void* data, uint64_t size, char** start, size_t* length) {
+	uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+	uintptr_t begin = (uintptr_t)data & ~(page - 1);
+
+	(*start) = (char*)begin;
+	(*length) = (size_t)((uintptr_t)data + size - begin);
+}
+
+void hogl_memory_prefetch(void* data, uint64_t size) {
+	char* start = NULL;
+	size_t length = 0;
+
+	if (size == 0) {
+		return;
+	}
+
+	__page_range(data, size, &start, &length);
+	madvise(start, length, MADV_WILLNEED);
+}
+
+void hogl_memory_advise(void* data, uint64_t size, hogl_access_pattern pattern) {
+	char* start = NULL;
+	size_t length = 0;
+	int advice = MADV_NORMAL;
+
+	if (size == 0) {
+		return;
+	}
+
+	if (pattern == HOGL_ACCESS_SEQUENTIAL) {
+		advice = MADV_SEQUENTIAL;
+	}
+	else if (pattern == HOGL_ACCESS_RANDOM) {
+		advice = MADV_RANDOM;
+	}
+
+	__page_range(data, size, &start, &length);
+	madvise(start, length, advice);
+}
+
+hogl_error hogl_dir_walk(const char* path, hogl_dir_fn fn, void* usrp) {
+	DIR* dir = opendir(path);
+	struct dirent* ent = NULL;
+	struct stat st;
+	char child[HOGL_OS_PATH_MAX];
+
+	if (dir == NULL) {
+		return HOGL_ERROR_BAD_PATH;
+	}
+
+	while ((ent = readdir(dir)) != NULL) {
+		if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) {
+			continue;
+		}
+
+		if (snprintf(child, sizeof(child), "%s/%s", path, ent->d_name) >= (int)sizeof(child) || lstat(child, &st) != 0) {
+			continue;
+		}
+
+		// Links to files are followed, links to directories are skipped since they can form cycles
+		if (S_ISLNK(st.st_mode) && (stat(child, &st) != 0 || S_ISDIR(st.st_mode))) {
+			continue;
+		}
+
+		if (S_ISDIR(st.st_mode)) {
+			hogl_dir_walk(child, fn, usrp);
+		}
+		else if (S_ISREG(st.st_mode)) {
+			fn(child, usrp);
+		}
+	}
+
+	closedir(dir);
+
+	return HOGL_ERROR_NONE;
+}
+
+unsigned int hogl_cpu_count(void) {
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (unsigned int)count : 1;
+}
+
+void* __thread_entry(void* p) {
+	hogl_thread* thread = (hogl_thread*)p;
+	thread->fn(thread->usrp);
+	return NULL;
+}
+
+hogl_thread* hogl_thread_new(hogl_thread_fn fn, void* usrp) {
+	hogl_thread* thread = hogl_malloc(sizeof(hogl_thread));
+
+	if (thread == NULL) {
+		return NULL;
+	}
+
+	thread->fn = fn;
+	thread->usrp = usrp;
+
+	if (pthread_create(&thread->handle, NULL, __thread_entry, thread) != 0) {
+		hogl_free(thread);
+		return NULL;
+	}
+
+	return thread;
+}
+
+void hogl_thread_join(hogl_thread* thread) {
+	pthread_join(thread->handle, NULL);
+	hogl_free(thread);
+}
+
+hogl_mutex* hogl_mutex_new(void) {
+	hogl_mutex* mutex = hogl_malloc(sizeof(hogl_mutex));
+
+	if (mutex == NULL) {
+		return NULL;
+	}
+
+	if (pthread_mutex_init(&mutex->mtx, NULL) != 0) {
+		hogl_free(mutex);
+		return NULL;
+	}
+
+	return mutex;
+}
+
+void hogl_mutex_lock(hogl_mutex* mutex) {
+	pthread_mutex_lock(&mutex->mtx);
+}
+
+void hogl_mutex_unlock(hogl_mutex* mutex) {
+	pthread_mutex_unlock(&mutex->mtx);
+}
+
+void hogl_mutex_free(hogl_mutex* mutex) {
+	pthread_mutex_destroy(&mutex->mtx);
+	hogl_free(mutex);
+}
+
+hogl_cond* hogl_cond_new(void) {
+	hogl_cond* cond = hogl_malloc(sizeof(hogl_cond));
+
+	if (cond == NULL) {
+		return NULL;
+	}
+
+	if (pthread_cond_init(&cond->cv, NULL) != 0) {
+		hogl_free(cond);
+		return NULL;
+	}
+
+	return cond;
+}
+
+void hogl_cond_wait(hogl_cond* cond, hogl_mutex* mutex) {
+	pthread_cond_wait(&cond->cv, &mutex->mtx);
+}
+
+void hogl_cond_signal(hogl_cond* cond) {
+	pthread_cond_signal(&cond->cv);
+}
+
+void hogl_cond_broadcast(hogl_cond* cond) {
+	pthread_cond_broadcast(&cond->cv);
+}
+
+void hogl_cond_free(hogl_cond* cond) {
+	pthread_cond_destroy(&cond->cv);
+	hogl_free(cond);
+}
 
 #else
 
@@ -5,8 +5,39 @@
 #ifndef _HOGL_OS_
 #define _HOGL_OS_
 
+#include <stdint.h>
 #include "hogl_core/shared/hogl_def.h"
 
+/**
+ * @brief Operating system file handle, on windows this is a HANDLE on linux a file descriptor
+*/
+typedef intptr_t hogl_file;
+
+/**
+ * @brief Value returned by hogl_file_open when the file could not be opened
+*/
+#define HOGL_INVALID_FILE ((hogl_file)-1)
+
+/**
+ * @brief Operating system thread
+*/
+typedef struct _hogl_thread hogl_thread;
+
+/**
+ * @brief Mutual exclusion lock
+*/
+typedef struct _hogl_mutex hogl_mutex;
+
+/**
+ * @brief Condition variable, used together with a hogl_mutex
+*/
+typedef struct _hogl_cond hogl_cond;
+
+/**
+ * @brief Thread entry point
+*/
+typedef void (*hogl_thread_fn)(void*);
+
 /**
  * @brief Returns the current thread id
  * @return Current thread id
@@ -44,4 +75,179 @@ int hogl_atomic_add_b32(int* variable, int value);
 */
 int hogl_atomic_substract_b32(int* variable, int value);
 
+/**
+ * @brief Opens the file pointed to by path for reading
+ * @param path Path to the file
+ * @return File handle or HOGL_INVALID_FILE if the file could not be opened
+*/
+hogl_file hogl_file_open(const char* path);
+
+/**
+ * @brief Reads size bytes from the file starting at offset into dst, the file position is not used or changed
+ * so this can be called from multiple threads on the same file
+ * @param file File to read from
+ * @param dst Destination pointer, must be at least size bytes long
+ * @param size Number of bytes to read
+ * @param offset Offset in bytes from the start of the file
+ * @return Number of bytes read, less than size if the end of file was reached or an error occurred
+*/
+uint64_t hogl_file_pread(hogl_file file, void* dst, uint64_t size, uint64_t offset);
+
+/**
+ * @brief Returns the size of the file in bytes
+ * @param file File whose size is needed
+ * @return Size of the file
+*/
+uint64_t hogl_file_size(hogl_file file);
+
+/**
+ * @brief Closes the file
+ * @param file File to close
+*/
+void hogl_file_close(hogl_file file);
+
+/**
+ * @brief Maps the first size bytes of the file into memory copy on write, changes to the memory are private
+ * and are never written back to the file. The file can be closed while the mapping is alive
+ * @param file File to map
+ * @param size Number of bytes to map, must not be larger than the file
+ * @return Pointer to the mapped memory or NULL if the file could not be mapped, unmap using hogl_file_unmap
+*/
+void* hogl_file_map(hogl_file file, uint64_t size);
+
+/**
+ * @brief Unmaps memory mapped by hogl_file_map
+ * @param data Pointer returned by hogl_file_map
+ * @param size Size passed to hogl_file_map
+*/
+void hogl_file_unmap(void* data, uint64_t size);
+
+/**
+ * @brief Asks the operating system to start reading the range of the file into the page cache, returns without
+ * waiting for the read. This is only a hint and does nothing on platforms without support for it
+ * @param file File to read ahead
+ * @param offset Offset in bytes from the start of the file
+ * @param size Number of bytes to read ahead
+*/
+void hogl_file_prefetch(hogl_file file, uint64_t offset, uint64_t size);
+
+/**
+ * @brief Tells the operating system how the file will be read so it can adjust its read ahead, this is only
+ * a hint and does nothing on platforms without support for it
+ * @param file File that will be read
+ * @param pattern Expected access pattern
+*/
+void hogl_file_advise(hogl_file file, hogl_access_pattern pattern);
+
+/**
+ * @brief Asks the operating system to start loading the range of mapped memory, returns without waiting for
+ * the pages to be loaded so the first access does not have to fault them in. This is only a hint
+ * @param data Start of the range inside memory mapped by hogl_file_map
+ * @param size Size of the range in bytes
+*/
+void hogl_memory_prefetch(void* data, uint64_t size);
+
+/**
+ * @brief Tells the operating system how the range of mapped memory will be accessed so it can adjust its read
+ * ahead, this is only a hint and does nothing on platforms without support for it
+ * @param data Start of the range inside memory mapped by hogl_file_map
+ * @param size Size of the range in bytes
+ * @param pattern Expected access pattern
+*/
+void hogl_memory_advise(void* data, uint64_t size, hogl_access_pattern pattern);
+
+/**
+ * @brief Called by hogl_dir_walk for every file, the path is only valid during the call
+*/
+typedef void (*hogl_dir_fn)(const char* path, void* usrp);
+
+/**
+ * @brief Calls fn for every regular file inside the directory and its subdirectories, paths passed to fn
+ * start with the directory path and use / as the separator, the order of the files is not specified. Linked
+ * directories are not entered
+ * @param path Path to the directory
+ * @param fn Function called for every file
+ * @param usrp User pointer passed to fn
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if the directory was walked
+ *		HOGL_ERROR_BAD_PATH			if path could not be opened as a directory
+*/
+hogl_error hogl_dir_walk(const char* path, hogl_dir_fn fn, void* usrp);
+
+/**
+ * @brief Returns the number of logical processors on the machine
+ * @return Processor count, at least 1
+*/
+unsigned int hogl_cpu_count(void);
+
+/**
+ * @brief Starts a new thread that executes fn with usrp as its argument
+ * @param fn Thread function
+ * @param usrp User pointer passed to fn
+ * @return Thread object or NULL if the thread could not be created, must be joined using hogl_thread_join
+*/
+hogl_thread* hogl_thread_new(hogl_thread_fn fn, void* usrp);
+
+/**
+ * @brief Waits for the thread to finish and frees the thread object
+ * @param thread Thread to join
+*/
+void hogl_thread_join(hogl_thread* thread);
+
+/**
+ * @brief Creates a new mutex
+ * @return Mutex object, free using hogl_mutex_free, NULL if it could not be created
+*/
+hogl_mutex* hogl_mutex_new(void);
+
+/**
+ * @brief Locks the mutex, blocks if it is already locked
+ * @param mutex Mutex to lock
+*/
+void hogl_mutex_lock(hogl_mutex* mutex);
+
+/**
+ * @brief Unlocks the mutex
+ * @param mutex Mutex to unlock
+*/
+void hogl_mutex_unlock(hogl_mutex* mutex);
+
+/**
+ * @brief Frees the mutex, it must not be locked
+ * @param mutex Mutex to free
+*/
+void hogl_mutex_free(hogl_mutex* mutex);
+
+/**
+ * @brief Creates a new condition variable
+ * @return Condition variable object, free using hogl_cond_free, NULL if it could not be created
+*/
+hogl_cond* hogl_cond_new(void);
+
+/**
+ * @brief Atomically unlocks the mutex and waits for the condition to be signaled, the mutex is locked again before returning.
+ * Spurious wakeups are possible so the condition has to be checked in a loop
+ * @param cond Condition to wait on
+ * @param mutex Locked mutex protecting the condition
+*/
+void hogl_cond_wait(hogl_cond* cond, hogl_mutex* mutex);
+
+/**
+ * @brief Wakes up a single thread waiting on the condition
+ * @param cond Condition to signal
+*/
+void hogl_cond_signal(hogl_cond* cond);
+
+/**
+ * @brief Wakes up all threads waiting on the condition
+ * @param cond Condition to signal
+*/
+void hogl_cond_broadcast(hogl_cond* cond);
+
+/**
+ * @brief Frees the condition variable, no threads can be waiting on it
+ * @param cond Condition to free
+*/
+void hogl_cond_free(hogl_cond* cond);
+
 #endif
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "hogl_def.h"
 
+#include <string.h>
+
 #include <gl/glad.h>
 #include <gl/glfw3.h>
 
@@ -7,22 +9,143 @@
 #include <AL/alc.h>
 
 #include "hogl_core/shared/hogl_log.h"
+#include "hogl_core/shared/hogl_memory.h"
 
-int __hogl_gl_check(void) {
-#ifndef HOGL_DISABLE_GL_WARNING
-	GLenum err;
-	int err_count = 0;
-	while ((err = glGetError()) != GL_NO_ERROR) {
-		hogl_log_error("OpenGL error detected %ld", err);
-		err_count++;
+#ifndef HOGL_GL_CHECK_MODE
+	#if defined(HOGL_DISABLE_GL_WARNING)
+		#define HOGL_GL_CHECK_MODE HOGL_GL_CHECK_OFF
+	#elif defined(NDEBUG)
+		#define HOGL_GL_CHECK_MODE HOGL_GL_CHECK_PER_FRAME
+	#else
+		#define HOGL_GL_CHECK_MODE HOGL_GL_CHECK_PER_CALL
+	#endif
+#endif
+
+#define GL_CHECK_MESSAGE_SIZE 256
+
+// Shared by all contexts, hogl issues GL calls from a single thread
+static struct {
+	hogl_gl_check_mode mode;
+
+	// Last check site, the error callback fires during the next GL call after it
+	const char* file;
+	int line;
+
+	// First error of the frame
+	int error_count;
+	const char* error_file;
+	int error_line;
+	char message[GL_CHECK_MESSAGE_SIZE];
+
+	// Set while a window context with loaded GL functions is current
+	int context_current;
+} gl_check = { HOGL_GL_CHECK_MODE, NULL, 0, 0, NULL, 0, { 0 }, 0 };
+
+int __hogl_gl_check(const char* file, int line) {
+	switch (gl_check.mode) {
+	case HOGL_GL_CHECK_PER_CALL: {
+		GLenum err;
+		int err_count = 0;
+		while ((err = glGetError()) != GL_NO_ERROR) {
+			hogl_log_error("OpenGL error detected %ld at %s:%d", err, file, line);
+			err_count++;
+		}
+
+		return err_count;
+	}
+	case HOGL_GL_CHECK_PER_FRAME:
+		gl_check.file = file;
+		gl_check.line = line;
+		return 0;
+	default:
+		return 0;
 	}
+}
 
-	return err_count;
-#else
-	return 0;
+void __hogl_gl_report(const char* message) {
+	size_t length = 0;
+
+	if (gl_check.mode != HOGL_GL_CHECK_PER_FRAME) {
+		return;
+	}
+
+	if (gl_check.error_count++ != 0) {
+		return;
+	}
+
+	gl_check.error_file = gl_check.file;
+	gl_check.error_line = gl_check.line;
+
+	length = strlen(message);
+	if (length >= GL_CHECK_MESSAGE_SIZE) {
+		length = GL_CHECK_MESSAGE_SIZE - 1;
+	}
+
+	hogl_memcpy(gl_check.message, message, length);
+	gl_check.message[length] = 0;
+}
+
+void __hogl_gl_apply_check_mode(void) {
+#ifndef HOGL_SUPPRESS_GL_LOG
+	if (gl_check.mode == HOGL_GL_CHECK_OFF) {
+		glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+	}
+	else {
+		glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+	}
 #endif
 }
 
+void __hogl_gl_set_context_current(int current) {
+	gl_check.context_current = current;
+}
+
+void hogl_set_gl_check_mode(hogl_gl_check_mode mode) {
+	gl_check.mode = mode;
+	gl_check.file = NULL;
+	gl_check.line = 0;
+	gl_check.error_count = 0;
+
+	// Windows created later apply the mode themselves once their context is loaded
+	if (gl_check.context_current) {
+		__hogl_gl_apply_check_mode();
+	}
+}
+
+hogl_gl_check_mode hogl_get_gl_check_mode(void) {
+	return gl_check.mode;
+}
+
+hogl_error hogl_gl_check_frame(void) {
+	int pending = 0;
+
+	if (gl_check.mode != HOGL_GL_CHECK_PER_FRAME) {
+		return HOGL_ERROR_NONE;
+	}
+
+	// One round trip for the whole frame, errors not seen by the debug output are still counted
+	while (glGetError() != GL_NO_ERROR) {
+		pending++;
+	}
+
+	if (gl_check.error_count == 0 && pending == 0) {
+		return HOGL_ERROR_NONE;
+	}
+
+	if (gl_check.error_count != 0) {
+		hogl_log_error("%d OpenGL errors this frame, first after check at %s:%d: %s",
+			gl_check.error_count, gl_check.error_file != NULL ? gl_check.error_file : "frame start", gl_check.error_line, gl_check.message);
+	}
+	else {
+		hogl_log_error("%d OpenGL errors this frame, enable debug output or per call checking for their location", pending);
+	}
+
+	gl_check.error_count = 0;
+	gl_check.file = NULL;
+	gl_check.line = 0;
+	return HOGL_ERROR_OPENGL_GENERIC;
+}
+
 int __hogl_al_check(void) {
 #ifndef HOGL_DISABLE_AL_WARNING
 	ALCenum err;
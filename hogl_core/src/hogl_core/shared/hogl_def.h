@@ -31,7 +31,8 @@
 	#define NULL 0
 #endif
 
-#define hogl_gl_check() if (__hogl_gl_check() != 0) { return HOGL_ERROR_OPENGL_GENERIC; }
+#define hogl_gl_check() if (__hogl_gl_check(__FILE__, __LINE__) != 0) { return HOGL_ERROR_OPENGL_GENERIC; }
+#define hogl_gl_check_cleanup(cleanup) if (__hogl_gl_check(__FILE__, __LINE__) != 0) { cleanup; return HOGL_ERROR_OPENGL_GENERIC; }
 #define hogl_al_check() if (__hogl_al_check() != 0) { return HOGL_ERROR_OPENAL_GENERIC; }
 
 /**
@@ -66,7 +67,11 @@ typedef enum {
 	HOGL_ERROR_OPENAL_DEVICE,
 	HOGL_ERROR_OPENAL_CONTEXT,
 	HOGL_ERROR_OPENGL_GENERIC,
-	HOGL_ERROR_OPENAL_GENERIC
+	HOGL_ERROR_OPENAL_GENERIC,
+	HOGL_ERROR_VF_NOT_LOADED,
+	HOGL_ERROR_VF_CHECKSUM,
+	HOGL_ERROR_VF_PATCH_MISMATCH,
+	HOGL_ERROR_OPENGL_UNSUPPORTED
 } hogl_error;
 
 /**
@@ -86,13 +91,22 @@ typedef enum {
 	HOGL_VBOU_DYNAMIC
 } hogl_vbo_usage;
 
+/**
+ * @brief hogl possible index buffer element types
+*/
+typedef enum {
+	HOGL_IT_UINT32,
+	HOGL_IT_UINT16
+} hogl_index_type;
+
 /**
  * @brief hogl possible internal element type
 */
 typedef enum {
 	HOGL_ET_FLOAT,
 	HOGL_ET_UINT,
-	HOGL_ET_UBYTE
+	HOGL_ET_UBYTE,
+	HOGL_ET_USHORT
 } hogl_element_type;
 
 /**
@@ -207,9 +221,73 @@ typedef enum {
 } hogl_audio_format;
 
 /**
- * @brief Checks if any errors occurred in OpenGL since last call
+ * @brief Expected access pattern of file data, used as a hint for the operating system read ahead
+*/
+typedef enum {
+	HOGL_ACCESS_NORMAL,
+	HOGL_ACCESS_SEQUENTIAL,
+	HOGL_ACCESS_RANDOM
+} hogl_access_pattern;
+
+/**
+ * @brief When OpenGL errors are checked
+*/
+typedef enum {
+	// glGetError after every call, errors are returned from the failing function
+	HOGL_GL_CHECK_PER_CALL,
+	// glGetError once per frame, the first error is reported with the last check site before it
+	HOGL_GL_CHECK_PER_FRAME,
+	// No checking at all
+	HOGL_GL_CHECK_OFF
+} hogl_gl_check_mode;
+
+/**
+ * @brief Checks if any errors occurred in OpenGL since last call, in per frame mode only remembers the call site
+ * @param file Source file of the check
+ * @param line Source line of the check
+*/
+HOGL_API int __hogl_gl_check(const char* file, int line);
+
+/**
+ * @brief Records an OpenGL error reported through the debug output, used by the KHR_debug callback
+ * @param message Driver message for the error
+*/
+void __hogl_gl_report(const char* message);
+
+/**
+ * @brief Makes the debug output of the current context synchronous in the per call and per frame modes, so errors are
+ * reported inside the failing call, and asynchronous when checking is off
+*/
+void __hogl_gl_apply_check_mode(void);
+
+/**
+ * @brief Tells the error checking whether a window context with loaded GL functions is current, set by hogl_wnd
+ * @param current 1 if such a context is current, 0 otherwise
+*/
+void __hogl_gl_set_context_current(int current);
+
+/**
+ * @brief Sets when OpenGL errors are checked, per call by default, per frame if NDEBUG is defined,
+ * off if HOGL_DISABLE_GL_WARNING is defined, HOGL_GL_CHECK_MODE overrides the default. Turning checking off also
+ * lets the debug output of the current context run asynchronously
+ * @param mode New check mode
+*/
+HOGL_API void hogl_set_gl_check_mode(hogl_gl_check_mode mode);
+
+/**
+ * @brief Returns the current OpenGL error check mode
+ * @return Current check mode
+*/
+HOGL_API hogl_gl_check_mode hogl_get_gl_check_mode(void);
+
+/**
+ * @brief Collects OpenGL errors raised since the last frame check and reports the first one,
+ * called by hogl_swap_window_buffer so usually there is no need to call this directly
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				no errors were raised
+ *		HOGL_ERROR_OPENGL_GENERIC	at least one error was raised since the last check
 */
-HOGL_API int __hogl_gl_check(void);
+HOGL_API hogl_error hogl_gl_check_frame(void);
 
 /**
  * @brief Checks if any errors occurred in OpenAL since last call
@@ -0,0 +1,133 @@
+#include "hogl_endian.h"
+
+#include <string.h>
+
+#if defined(_M_X64) || defined(__x86_64__)
+	#define HOGL_BSWAP_SSSE3
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+	#include <tmmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+	#include <stdlib.h>
+	#define __bswap16(x) _byteswap_ushort(x)
+	#define __bswap32(x) _byteswap_ulong(x)
+	#define __bswap64(x) _byteswap_uint64(x)
+#else
+	#define __bswap16(x) __builtin_bswap16(x)
+	#define __bswap32(x) __builtin_bswap32(x)
+	#define __bswap64(x) __builtin_bswap64(x)
+#endif
+
+bool hogl_big_endian() {
+	volatile uint32_t i = 0x01234567;
+	return (*((uint8_t*)(&i))) == 0x01;
+}
+
+static void __swap_scalar(uint8_t* p, size_t count, uint32_t width) {
+	// memcpy keeps unaligned accesses well defined, compilers turn it into plain loads
+	for (size_t i = 0; i < count; i++, p += width) {
+		if (width == 2) {
+			uint16_t v;
+			memcpy(&v, p, sizeof(v));
+			v = __bswap16(v);
+			memcpy(p, &v, sizeof(v));
+		}
+		else if (width == 4) {
+			uint32_t v;
+			memcpy(&v, p, sizeof(v));
+			v = __bswap32(v);
+			memcpy(p, &v, sizeof(v));
+		}
+		else {
+			uint64_t v;
+			memcpy(&v, p, sizeof(v));
+			v = __bswap64(v);
+			memcpy(p, &v, sizeof(v));
+		}
+	}
+}
+
+#ifdef HOGL_BSWAP_SSSE3
+
+static bool __has_ssse3(void) {
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 9)) != 0;
+#else
+	unsigned int eax, ebx, ecx, edx;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+		return false;
+	}
+	return (ecx & bit_SSSE3) != 0;
+#endif
+}
+
+#ifndef _MSC_VER
+__attribute__((target("ssse3")))
+#endif
+static size_t __swap_ssse3(uint8_t* p, size_t size, uint32_t width) {
+	__m128i mask;
+	size_t i = 0;
+
+	if (width == 2) {
+		mask = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+	}
+	else if (width == 4) {
+		mask = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+	}
+	else {
+		mask = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+	}
+
+	// 4 independent registers per iteration so the loads and shuffles can overlap
+	for (; i + 64 <= size; i += 64) {
+		__m128i a = _mm_loadu_si128((const __m128i*)(p + i));
+		__m128i b = _mm_loadu_si128((const __m128i*)(p + i + 16));
+		__m128i c = _mm_loadu_si128((const __m128i*)(p + i + 32));
+		__m128i d = _mm_loadu_si128((const __m128i*)(p + i + 48));
+		_mm_storeu_si128((__m128i*)(p + i), _mm_shuffle_epi8(a, mask));
+		_mm_storeu_si128((__m128i*)(p + i + 16), _mm_shuffle_epi8(b, mask));
+		_mm_storeu_si128((__m128i*)(p + i + 32), _mm_shuffle_epi8(c, mask));
+		_mm_storeu_si128((__m128i*)(p + i + 48), _mm_shuffle_epi8(d, mask));
+	}
+
+	for (; i + 16 <= size; i += 16) {
+		__m128i a = _mm_loadu_si128((const __m128i*)(p + i));
+		_mm_storeu_si128((__m128i*)(p + i), _mm_shuffle_epi8(a, mask));
+	}
+
+	// Returns the number of bytes swapped, the rest is left for the scalar path
+	return i;
+}
+
+#endif
+
+void hogl_byte_swap(void* data, size_t count, uint32_t width) {
+	uint8_t* p = (uint8_t*)data;
+	size_t done = 0;
+
+	if (width != 2 && width != 4 && width != 8) {
+		return;
+	}
+
+#ifdef HOGL_BSWAP_SSSE3
+	static int s_hw = -1;
+
+	if (s_hw == -1) {
+		s_hw = __has_ssse3() ? 1 : 0;
+	}
+
+	if (s_hw == 1) {
+		// 16 is a multiple of every width so the vector loop never splits an element
+		done = __swap_ssse3(p, count * width, width);
+	}
+#endif
+
+	__swap_scalar(p + done, count - done / width, width);
+}
\ No newline at end of file
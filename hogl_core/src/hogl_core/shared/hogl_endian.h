@@ -0,0 +1,29 @@
+/**
+* @brief hogl endian file contains functions for converting data between byte orders
+*/
+
+#ifndef _HOGL_ENDIAN_
+#define _HOGL_ENDIAN_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "hogl_core/shared/hogl_def.h"
+
+/**
+ * @brief Checks the byte order of the machine
+ * @return True if the machine is big endian, false if it is little endian
+*/
+HOGL_API bool hogl_big_endian();
+
+/**
+ * @brief Reverses the byte order of every element inside data, on x86-64 processors with SSSE3 the
+ * elements are swapped 16 bytes at a time using byte shuffles
+ * @param data Data to swap, does not need to be aligned
+ * @param count Number of elements inside data
+ * @param width Size of a single element in bytes, one of 2 (uint16), 4 (uint32, float) or 8 (uint64, double),
+ * for any other width the data is left untouched
+*/
+HOGL_API void hogl_byte_swap(void* data, size_t count, uint32_t width);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include "hogl_hash.h"
+
+#include <string.h>
+#include <stdbool.h>
+
+#if defined(_M_X64) || defined(__x86_64__)
+	#define HOGL_CRC32C_SSE42
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+	#include <nmmintrin.h>
+#endif
+
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define PRIME64_5 0x27D4EB2F165667C5ULL
+
+// Reflected CRC32C polynomial
+#define CRC32C_POLY 0x82F63B78
+
+// Slicing by 8 tables for the software CRC32C implementation
+static uint32_t s_crc_table[8][256];
+static bool s_crc_table_ready = false;
+
+static uint64_t __rotl64(uint64_t x, int r) {
+	return (x << r) | (x >> (64 - r));
+}
+
+// Both algorithms are defined on little endian reads, big endian machines swap so hashes match across machines
+static uint64_t __read64(const uint8_t* p) {
+	uint64_t v;
+	memcpy(&v, p, sizeof(uint64_t));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	v = __builtin_bswap64(v);
+#endif
+	return v;
+}
+
+static uint32_t __read32(const uint8_t* p) {
+	uint32_t v;
+	memcpy(&v, p, sizeof(uint32_t));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	v = __builtin_bswap32(v);
+#endif
+	return v;
+}
+
+static uint64_t __xxh64_round(uint64_t acc, uint64_t input) {
+	acc += input * PRIME64_2;
+	acc = __rotl64(acc, 31);
+	acc *= PRIME64_1;
+	return acc;
+}
+
+static uint64_t __xxh64_merge(uint64_t acc, uint64_t val) {
+	val = __xxh64_round(0, val);
+	acc ^= val;
+	acc = acc * PRIME64_1 + PRIME64_4;
+	return acc;
+}
+
+uint64_t hogl_hash64(const void* data, size_t size, uint64_t seed) {
+	const uint8_t* p = (const uint8_t*)data;
+	const uint8_t* end = p + size;
+	uint64_t h = 0;
+
+	if (size >= 32) {
+		const uint8_t* limit = end - 32;
+		uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+		uint64_t v2 = seed + PRIME64_2;
+		uint64_t v3 = seed;
+		uint64_t v4 = seed - PRIME64_1;
+
+		// 4 independent lanes so the multiplications can be pipelined
+		do {
+			v1 = __xxh64_round(v1, __read64(p));
+			v2 = __xxh64_round(v2, __read64(p + 8));
+			v3 = __xxh64_round(v3, __read64(p + 16));
+			v4 = __xxh64_round(v4, __read64(p + 24));
+			p += 32;
+		} while (p <= limit);
+
+		h = __rotl64(v1, 1) + __rotl64(v2, 7) + __rotl64(v3, 12) + __rotl64(v4, 18);
+		h = __xxh64_merge(h, v1);
+		h = __xxh64_merge(h, v2);
+		h = __xxh64_merge(h, v3);
+		h = __xxh64_merge(h, v4);
+	}
+	else {
+		h = seed + PRIME64_5;
+	}
+
+	h += (uint64_t)size;
+
+	// Tail
+	while (p + 8 <= end) {
+		h ^= __xxh64_round(0, __read64(p));
+		h = __rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+		p += 8;
+	}
+
+	if (p + 4 <= end) {
+		h ^= (uint64_t)__read32(p) * PRIME64_1;
+		h = __rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+		p += 4;
+	}
+
+	while (p < end) {
+		h ^= (*p) * PRIME64_5;
+		h = __rotl64(h, 11) * PRIME64_1;
+		p++;
+	}
+
+	// Avalanche
+	h ^= h >> 33;
+	h *= PRIME64_2;
+	h ^= h >> 29;
+	h *= PRIME64_3;
+	h ^= h >> 32;
+
+	return h;
+}
+
+static void __crc32c_init_table(void) {
+	for (uint32_t i = 0; i < 256; i++) {
+		uint32_t crc = i;
+
+		for (int j = 0; j < 8; j++) {
+			crc = (crc >> 1) ^ (CRC32C_POLY & (0 - (crc & 1)));
+		}
+
+		s_crc_table[0][i] = crc;
+	}
+
+	for (uint32_t i = 0; i < 256; i++) {
+		for (int t = 1; t < 8; t++) {
+			s_crc_table[t][i] = (s_crc_table[t - 1][i] >> 8) ^ s_crc_table[0][s_crc_table[t - 1][i] & 0xFF];
+		}
+	}
+
+	// Writing the same values from multiple threads is harmless
+	s_crc_table_ready = true;
+}
+
+static uint32_t __crc32c_sw(uint32_t crc, const uint8_t* p, size_t size) {
+	if (!s_crc_table_ready) {
+		__crc32c_init_table();
+	}
+
+	while (size >= 8) {
+		uint64_t v = __read64(p) ^ crc;
+		crc = s_crc_table[7][v & 0xFF] ^
+			s_crc_table[6][(v >> 8) & 0xFF] ^
+			s_crc_table[5][(v >> 16) & 0xFF] ^
+			s_crc_table[4][(v >> 24) & 0xFF] ^
+			s_crc_table[3][(v >> 32) & 0xFF] ^
+			s_crc_table[2][(v >> 40) & 0xFF] ^
+			s_crc_table[1][(v >> 48) & 0xFF] ^
+			s_crc_table[0][v >> 56];
+		p += 8;
+		size -= 8;
+	}
+
+	while (size > 0) {
+		crc = (crc >> 8) ^ s_crc_table[0][(crc ^ *p) & 0xFF];
+		p++;
+		size--;
+	}
+
+	return crc;
+}
+
+#ifdef HOGL_CRC32C_SSE42
+
+static bool __has_sse42(void) {
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 20)) != 0;
+#else
+	unsigned int eax, ebx, ecx, edx;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+		return false;
+	}
+	return (ecx & bit_SSE4_2) != 0;
+#endif
+}
+
+#ifndef _MSC_VER
+__attribute__((target("sse4.2")))
+#endif
+static uint32_t __crc32c_hw(uint32_t crc, const uint8_t* p, size_t size) {
+	uint64_t crc64 = crc;
+
+	// Align to 8 bytes so the 64 bit loads don't cross cache lines
+	while (size > 0 && ((uintptr_t)p & 7) != 0) {
+		crc64 = _mm_crc32_u8((uint32_t)crc64, *p);
+		p++;
+		size--;
+	}
+
+	while (size >= 32) {
+		crc64 = _mm_crc32_u64(crc64, __read64(p));
+		crc64 = _mm_crc32_u64(crc64, __read64(p + 8));
+		crc64 = _mm_crc32_u64(crc64, __read64(p + 16));
+		crc64 = _mm_crc32_u64(crc64, __read64(p + 24));
+		p += 32;
+		size -= 32;
+	}
+
+	while (size >= 8) {
+		crc64 = _mm_crc32_u64(crc64, __read64(p));
+		p += 8;
+		size -= 8;
+	}
+
+	while (size > 0) {
+		crc64 = _mm_crc32_u8((uint32_t)crc64, *p);
+		p++;
+		size--;
+	}
+
+	return (uint32_t)crc64;
+}
+
+#endif
+
+uint32_t hogl_crc32c(uint32_t crc, const void* data, size_t size) {
+#ifdef HOGL_CRC32C_SSE42
+	static int s_hw = -1;
+
+	if (s_hw == -1) {
+		s_hw = __has_sse42() ? 1 : 0;
+	}
+
+	if (s_hw == 1) {
+		return ~__crc32c_hw(~crc, (const uint8_t*)data, size);
+	}
+#endif
+
+	return ~__crc32c_sw(~crc, (const uint8_t*)data, size);
+}
\ No newline at end of file
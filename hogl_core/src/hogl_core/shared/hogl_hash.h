@@ -0,0 +1,32 @@
+/**
+* @brief hogl hash file contains non cryptographic hash and checksum functions used for content lookup and integrity checks
+*/
+
+#ifndef _HOGL_HASH_
+#define _HOGL_HASH_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "hogl_core/shared/hogl_def.h"
+
+/**
+ * @brief Computes a 64 bit hash of the data, this is an implementation of the XXH64 algorithm and it produces
+ * the same values as the reference implementation on both little and big endian machines
+ * @param data Data to hash
+ * @param size Size of data in bytes
+ * @param seed Hash seed, 0 by default
+ * @return 64 bit hash value
+*/
+HOGL_API uint64_t hogl_hash64(const void* data, size_t size, uint64_t seed);
+
+/**
+ * @brief Computes the CRC32C (Castagnoli) checksum of the data, on x86-64 processors with SSE4.2 the crc32
+ * instruction is used otherwise a table based implementation is used, both produce the same values
+ * @param crc Checksum of the previous data when checksumming in parts, 0 for the first part
+ * @param data Data to checksum
+ * @param size Size of data in bytes
+ * @return Checksum of the previous parts and data
+*/
+HOGL_API uint32_t hogl_crc32c(uint32_t crc, const void* data, size_t size);
+
+#endif
\ No newline at end of file
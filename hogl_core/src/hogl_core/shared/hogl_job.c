@@ -0,0 +1,224 @@
+#include "hogl_job.h"
+
+#include <stdbool.h>
+
+#include "hogl_core/shared/hogl_log.h"
+#include "hogl_core/shared/hogl_memory.h"
+#include "hogl_core/os/hogl_os.h"
+
+#define JOB_QUEUE_INITIAL_CAPACITY 64
+
+typedef struct _hogl_job {
+	hogl_job_fn fn;
+	void* usrp;
+} hogl_job;
+
+typedef struct _hogl_job_system {
+	hogl_thread** threads;
+	unsigned int thread_count;
+
+	hogl_mutex* mutex;
+	hogl_cond* job_cond;
+	hogl_cond* idle_cond;
+
+	// Ring buffer of pending jobs
+	hogl_job* queue;
+	size_t capacity;
+	size_t head;
+	size_t count;
+
+	// Jobs that are queued or executing
+	size_t pending;
+	bool running;
+} hogl_job_system;
+
+void __js_worker(void* p) {
+	hogl_job_system* js = (hogl_job_system*)p;
+	hogl_job job;
+
+	hogl_mutex_lock(js->mutex);
+
+	while (true) {
+		while (js->count == 0 && js->running) {
+			hogl_cond_wait(js->job_cond, js->mutex);
+		}
+
+		if (js->count == 0 && !js->running) {
+			break;
+		}
+
+		job = js->queue[js->head];
+		js->head = (js->head + 1) % js->capacity;
+		js->count--;
+
+		hogl_mutex_unlock(js->mutex);
+		job.fn(job.usrp);
+		hogl_mutex_lock(js->mutex);
+
+		js->pending--;
+		if (js->pending == 0) {
+			hogl_cond_broadcast(js->idle_cond);
+		}
+	}
+
+	hogl_mutex_unlock(js->mutex);
+}
+
+bool __js_reserve(hogl_job_system* js, size_t count) {
+	size_t new_capacity = js->capacity;
+	hogl_job* new_queue = NULL;
+
+	if (js->count + count <= js->capacity) {
+		return true;
+	}
+
+	while (new_capacity < js->count + count) {
+		new_capacity *= 2;
+	}
+
+	new_queue = hogl_malloc(new_capacity * sizeof(hogl_job));
+
+	if (new_queue == NULL) {
+		return false;
+	}
+
+	// Unwrap the ring buffer into the new queue
+	for (size_t i = 0; i < js->count; i++) {
+		new_queue[i] = js->queue[(js->head + i) % js->capacity];
+	}
+
+	hogl_free(js->queue);
+	js->queue = new_queue;
+	js->capacity = new_capacity;
+	js->head = 0;
+
+	return true;
+}
+
+// Frees the job system objects, the worker threads must already be joined
+void __js_discard(hogl_job_system* js) {
+	if (js->idle_cond != NULL) {
+		hogl_cond_free(js->idle_cond);
+	}
+
+	if (js->job_cond != NULL) {
+		hogl_cond_free(js->job_cond);
+	}
+
+	if (js->mutex != NULL) {
+		hogl_mutex_free(js->mutex);
+	}
+
+	hogl_free(js->queue);
+	hogl_free(js->threads);
+	hogl_free(js);
+}
+
+hogl_error hogl_js_new(hogl_job_system** js, unsigned int threads) {
+	if (threads == 0) {
+		threads = hogl_cpu_count();
+	}
+
+	(*js) = hogl_malloc(sizeof(hogl_job_system));
+
+	if ((*js) == NULL) {
+		return HOGL_ERROR_MEMORY;
+	}
+
+	(*js)->mutex = hogl_mutex_new();
+	(*js)->job_cond = hogl_cond_new();
+	(*js)->idle_cond = hogl_cond_new();
+	(*js)->queue = hogl_malloc(JOB_QUEUE_INITIAL_CAPACITY * sizeof(hogl_job));
+	(*js)->capacity = JOB_QUEUE_INITIAL_CAPACITY;
+	(*js)->head = 0;
+	(*js)->count = 0;
+	(*js)->pending = 0;
+	(*js)->running = true;
+	(*js)->thread_count = 0;
+	(*js)->threads = hogl_malloc(threads * sizeof(hogl_thread*));
+
+	if ((*js)->mutex == NULL || (*js)->job_cond == NULL || (*js)->idle_cond == NULL || (*js)->queue == NULL || (*js)->threads == NULL) {
+		hogl_log_error("Failed to allocate the job system");
+		__js_discard(*js);
+		(*js) = NULL;
+		return HOGL_ERROR_MEMORY;
+	}
+
+	for (unsigned int i = 0; i < threads; i++) {
+		(*js)->threads[i] = hogl_thread_new(__js_worker, *js);
+
+		if ((*js)->threads[i] == NULL) {
+			hogl_log_error("Failed to start job system worker thread %d", i);
+			hogl_js_free(*js);
+			(*js) = NULL;
+			return HOGL_ERROR_MEMORY;
+		}
+
+		(*js)->thread_count++;
+	}
+
+	return HOGL_ERROR_NONE;
+}
+
+hogl_error hogl_js_submit(hogl_job_system* js, hogl_job_fn fn, void* usrp) {
+	return hogl_js_submit_n(js, fn, &usrp, 1);
+}
+
+hogl_error hogl_js_submit_n(hogl_job_system* js, hogl_job_fn fn, void** usrps, size_t count) {
+	hogl_mutex_lock(js->mutex);
+
+	if (!__js_reserve(js, count)) {
+		hogl_mutex_unlock(js->mutex);
+		hogl_log_error("Failed to expand the job queue");
+		return HOGL_ERROR_MEMORY;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		hogl_job* job = &js->queue[(js->head + js->count) % js->capacity];
+		job->fn = fn;
+		job->usrp = usrps[i];
+		js->count++;
+	}
+
+	js->pending += count;
+
+	if (count == 1) {
+		hogl_cond_signal(js->job_cond);
+	}
+	else {
+		hogl_cond_broadcast(js->job_cond);
+	}
+
+	hogl_mutex_unlock(js->mutex);
+
+	return HOGL_ERROR_NONE;
+}
+
+void hogl_js_wait(hogl_job_system* js) {
+	hogl_mutex_lock(js->mutex);
+
+	while (js->pending != 0) {
+		hogl_cond_wait(js->idle_cond, js->mutex);
+	}
+
+	hogl_mutex_unlock(js->mutex);
+}
+
+unsigned int hogl_js_thread_count(hogl_job_system* js) {
+	return js->thread_count;
+}
+
+void hogl_js_free(hogl_job_system* js) {
+	hogl_js_wait(js);
+
+	hogl_mutex_lock(js->mutex);
+	js->running = false;
+	hogl_cond_broadcast(js->job_cond);
+	hogl_mutex_unlock(js->mutex);
+
+	for (unsigned int i = 0; i < js->thread_count; i++) {
+		hogl_thread_join(js->threads[i]);
+	}
+
+	__js_discard(js);
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+/**
+* @brief hogl job file contains a simple job system, a fixed amount of worker threads that execute submitted
+* jobs in the order they were submitted
+*/
+
+#ifndef _HOGL_JOB_
+#define _HOGL_JOB_
+
+#include <stddef.h>
+#include "hogl_core/shared/hogl_def.h"
+
+/**
+ * @brief Job system object, owns the worker threads and the job queue
+*/
+typedef struct _hogl_job_system hogl_job_system;
+
+/**
+ * @brief Job function, executed on one of the worker threads
+*/
+typedef void (*hogl_job_fn)(void* usrp);
+
+/**
+ * @brief Creates a new job system and starts its worker threads
+ * @param js Where to store the new job system
+ * @param threads Number of worker threads, 0 to use one thread per logical processor
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the job system could not be allocated or a worker thread could not be started
+*/
+HOGL_API hogl_error hogl_js_new(hogl_job_system** js, unsigned int threads);
+
+/**
+ * @brief Submits a single job to the job system
+ * @param js Job system
+ * @param fn Job function
+ * @param usrp User pointer passed to the job function
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the job queue could not be expanded
+*/
+HOGL_API hogl_error hogl_js_submit(hogl_job_system* js, hogl_job_fn fn, void* usrp);
+
+/**
+ * @brief Submits count jobs with the same function under a single queue lock, the jobs are started in array order
+ * @param js Job system
+ * @param fn Job function
+ * @param usrps Array of count user pointers, one job is created for each
+ * @param count Number of jobs
+ * @return Returns error codes:
+ *		HOGL_ERROR_NONE				if operation was successful
+ *		HOGL_ERROR_MEMORY			if the job queue could not be expanded, no jobs are submitted
+*/
+HOGL_API hogl_error hogl_js_submit_n(hogl_job_system* js, hogl_job_fn fn, void** usrps, size_t count);
+
+/**
+ * @brief Blocks until all submitted jobs have finished executing
+ * @param js Job system
+*/
+HOGL_API void hogl_js_wait(hogl_job_system* js);
+
+/**
+ * @brief Returns the number of worker threads
+ * @param js Job system
+ * @return Worker thread count
+*/
+HOGL_API unsigned int hogl_js_thread_count(hogl_job_system* js);
+
+/**
+ * @brief Waits for all submitted jobs, stops the worker threads and frees the job system
+ * @param js Job system to free
+*/
+HOGL_API void hogl_js_free(hogl_job_system* js);
+
+#endif
\ No newline at end of file
@@ -57,6 +57,10 @@ void hogl_memset(void* dst, int value, size_t count) {
 }
 
 void hogl_free(void* p) {
+	if (p == NULL) {
+		return;
+	}
+
 	size_t blockSize = _msize(p);
 	hogl_log_trace("Freeing %ld bytes", blockSize);
 	hogl_atomic_substract_b32(&s_allocated, blockSize);
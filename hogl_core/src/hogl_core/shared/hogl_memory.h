@@ -55,7 +55,7 @@ HOGL_API void hogl_memset(void* dst, int value, size_t count);
 
 /**
  * @brief Frees the memory specified by p
- * @param p Memory to free
+ * @param p Memory to free, does nothing if p is NULL
 */
 HOGL_API void hogl_free(void* p);
 
@@ -64,6 +64,10 @@ hogl_ubo* pbrDataUBO;
 hogl_ubo* matricesUBO;
 hogl_ubo* prefilterUBO;
 
+// Per face matrices of the IBL passes, the matrices binding point is 7
+hogl_ubo_ring* iblRing;
+#define MATRICES_BP 7
+
 hogl_shader* pbrShader;
 hogl_shader* equirectangularToCubemapShader;
 hogl_shader* irradianceShader;
@@ -237,6 +241,7 @@ void generate_basic_geometry(void) {
 
     float* sphere_vertices = NULL;
     unsigned int* sphere_indices = NULL;
+    hogl_index_type sphere_index_type = HOGL_IT_UINT32;
 
 	hogl_vbo_desc descs[2];
     hogl_ap_desc apdescs[3];
@@ -308,6 +313,9 @@ void generate_basic_geometry(void) {
     sphere_vertices = generate_sphere_vertices();
     sphere_indices = generate_sphere_indices();
 
+    // The sphere has few enough vertices for 16 bit indices
+    sphere_index_type = hogl_narrow_indices(sphere_indices, 2 * Y_SEGMENTS * (X_SEGMENTS + 1), sphere_indices);
+
     descs[0].data = sphere_vertices;
     descs[0].data_size = (3 + 2 + 3) * (Y_SEGMENTS + 1) * (X_SEGMENTS + 1) * sizeof(float);
     descs[0].type = HOGL_VBOT_ARRAY_BUFFER;
@@ -316,8 +324,9 @@ void generate_basic_geometry(void) {
     descs[0].desc_size = 3;
 
     descs[1].data = sphere_indices;
-    descs[1].data_size = 2 * Y_SEGMENTS * (X_SEGMENTS + 1) * sizeof(unsigned int);
+    descs[1].data_size = 2 * Y_SEGMENTS * (X_SEGMENTS + 1) * (sphere_index_type == HOGL_IT_UINT16 ? sizeof(unsigned short) : sizeof(unsigned int));
     descs[1].type = HOGL_VBOT_ELEMENT_BUFFER;
+    descs[1].index_type = sphere_index_type;
     descs[1].usage = HOGL_VBOU_STATIC;
     descs[1].ap_desc = apdescs;
     descs[1].desc_size = 3;
@@ -738,6 +747,16 @@ void mat_init(float* mret) {
     mret[3 + 3 * 4] = 1.0f;
 }
 
+void push_face_matrices(void) {
+    // Without a ring every face rewrites the matrices ubo
+    if (iblRing == NULL) {
+        hogl_ubo_data(matricesUBO, &md, sizeof(md));
+        return;
+    }
+
+    hogl_ubo_ring_push(iblRing, MATRICES_BP, &md, sizeof(md));
+}
+
 void load_audio(hogl_abuffer_desc* desc) {
     int error;
     wavfh header;
@@ -851,6 +870,15 @@ void prepare_pbr(void) {
     target.z = -1.0f;
     look_at(eye, target, up, &views[5][0]);
 
+    // Every face gets its own slice so the passes don't wait on each other, 42 faces in total, rings need OpenGL 4.4
+    if (hogl_ubo_ring_new(&iblRing, 64 * 256, 1) == HOGL_ERROR_NONE) {
+        hogl_ubo_ring_begin(iblRing);
+    }
+    else {
+        hogl_log_warn("Uniform buffer rings are not supported, updating the matrices ubo per face");
+        iblRing = NULL;
+    }
+
     hogl_framebuffer_bind(fbo);
     hogl_renderbuffer_bind(rbo);
     
@@ -864,7 +892,7 @@ void prepare_pbr(void) {
 
     for (int i = 0; i < 6; i++) {
         memcpy(&md.view[0], &views[i][0], 16 * sizeof(float));
-        hogl_ubo_data(matricesUBO, &md, sizeof(md));
+        push_face_matrices();
 
         hogl_cm_active_side(envCubemap, i);
         hogl_framebuffer_ca(fbo, envCubemap, 0, 0);
@@ -884,7 +912,7 @@ void prepare_pbr(void) {
     
     for (int i = 0; i < 6; i++) {
         memcpy(&md.view[0], &views[i][0], 16 * sizeof(float));
-        hogl_ubo_data(matricesUBO, &md, sizeof(md));
+        push_face_matrices();
     
         hogl_cm_active_side(irradianceMap, i);
         hogl_framebuffer_ca(fbo, irradianceMap, 0, 0);
@@ -912,7 +940,7 @@ void prepare_pbr(void) {
         for (unsigned int i = 0; i < 6; ++i)
         {
             memcpy(&md.view[0], &views[i][0], 16 * sizeof(float));
-            hogl_ubo_data(matricesUBO, &md, sizeof(md));
+            push_face_matrices();
     
             hogl_cm_active_side(prefilterMap, i);
             hogl_framebuffer_ca(fbo, prefilterMap, 0, mip);
@@ -936,6 +964,14 @@ void prepare_pbr(void) {
     hogl_render_clear(0, 0, 0, 0);
     hogl_render_a(HOGL_RM_TRIANGLE_STRIP, 4);
 
+    // Give the matrices binding point back to the ubo
+    if (iblRing != NULL) {
+        hogl_ubo_ring_end(iblRing);
+        hogl_ubo_ring_free(iblRing);
+        iblRing = NULL;
+    }
+    hogl_ubo_bind(matricesUBO);
+
     perspective(45.0f, 1280.0f / 720.0f, 0.1f, 100.0f, &md.projection[0]);
 
     hogl_reset_framebuffer();
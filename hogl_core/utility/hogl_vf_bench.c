@@ -0,0 +1,310 @@
+/**
+* @brief hogl_vf_bench measures virtual file build, save, open, lookup and item read speed on generated packs
+*
+* Usage: hogl_vf_bench [-o results.csv] [-r repeats] [-m max MiB per pack] [-d directory]
+*
+* Every pack is made of items with unique pseudo random data so deduplication doesn't skew the numbers. Cold open
+* is the first open after the pack is saved, the operating system file cache is not flushed so on most systems
+* it measures a cached file as well. The csv has one row per pack and operation
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "hogl_core/io/hogl_vf.h"
+#include "hogl_core/io/hogl_vf_mount.h"
+#include "hogl_core/shared/hogl_log.h"
+#include "hogl_core/shared/hogl_memory.h"
+
+#define BENCH_NAME_LEN 32
+
+static const size_t s_item_counts[] = { 1000, 10000, 100000 };
+static const uint64_t s_item_sizes[] = { 64, 4096, 65536 };
+
+typedef struct _bench_result {
+	const char* operation;
+	uint64_t operations;
+	uint64_t bytes;
+	double seconds;
+} bench_result;
+
+void __log_cb(char* message, unsigned int size) {
+	if (strstr(message, "TRACE MESSAGE") == NULL) {
+		printf("%.*s\n", (int)size, message);
+	}
+}
+
+double __seconds(void) {
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+uint64_t __xorshift(uint64_t* state) {
+	(*state) ^= (*state) << 13;
+	(*state) ^= (*state) >> 7;
+	(*state) ^= (*state) << 17;
+	return (*state);
+}
+
+void __fill(char* data, uint64_t size, uint64_t seed) {
+	uint64_t state = seed * 0x9E3779B97F4A7C15ULL + 1;
+
+	for (uint64_t i = 0; i < size; i += sizeof(uint64_t)) {
+		uint64_t value = __xorshift(&state);
+		memcpy(data + i, &value, size - i < sizeof(uint64_t) ? size - i : sizeof(uint64_t));
+	}
+}
+
+void __report(FILE* csv, size_t count, uint64_t size, bench_result* result) {
+	double ns = result->operations != 0 ? result->seconds * 1e9 / (double)result->operations : 0.0;
+	double mbs = result->seconds > 0.0 ? (double)result->bytes / (1024.0 * 1024.0) / result->seconds : 0.0;
+
+	printf("%8zu x %6llu B  %-12s %12.1f ns/op %10.1f MiB/s\n", count, (unsigned long long)size, result->operation, ns, mbs);
+
+	if (csv != NULL) {
+		fprintf(csv, "%zu,%llu,%s,%llu,%llu,%.9f,%.1f,%.1f\n", count, (unsigned long long)size, result->operation,
+			(unsigned long long)result->operations, (unsigned long long)result->bytes, result->seconds, ns, mbs);
+	}
+}
+
+bool __bench_pack(FILE* csv, const char* path, size_t count, uint64_t size, int repeats) {
+	hogl_vf* vf = NULL;
+	hogl_vf_mounts* mounts = NULL;
+	char* data = hogl_malloc((unsigned int)size);
+	size_t* order = hogl_malloc((unsigned int)(count * sizeof(size_t)));
+	char name[BENCH_NAME_LEN];
+	uint64_t total = (uint64_t)count * size;
+	uint64_t state = 42;
+	bench_result result;
+	double start = 0.0;
+	bool ok = data != NULL && order != NULL;
+
+	// Build
+	vf = hogl_vf_new(1, BENCH_NAME_LEN);
+	ok = ok && vf != NULL;
+	result.operation = "build";
+	result.operations = count;
+	result.bytes = total;
+	result.seconds = 0.0;
+
+	for (size_t i = 0; i < count && ok; i++) {
+		snprintf(name, sizeof(name), "item_%08zu", i);
+		__fill(data, size, i);
+
+		// Only the add is timed, generating the data is not
+		start = __seconds();
+		ok = hogl_vf_add_item(vf, name, 0, data, size) == HOGL_ERROR_NONE;
+		result.seconds += __seconds() - start;
+	}
+
+	if (ok) {
+		__report(csv, count, size, &result);
+	}
+
+	// Save
+	if (ok) {
+		result.operation = "save";
+		result.operations = 1;
+		start = __seconds();
+		ok = hogl_vf_save(vf, path) == HOGL_ERROR_NONE;
+		result.seconds = __seconds() - start;
+	}
+
+	if (vf != NULL) {
+		hogl_vf_free(vf);
+		vf = NULL;
+	}
+
+	if (ok) {
+		__report(csv, count, size, &result);
+	}
+
+	// Cold open, first read after the save
+	if (ok) {
+		result.operation = "open_cold";
+		start = __seconds();
+		ok = hogl_vf_read(&vf, path) == HOGL_ERROR_NONE;
+		result.seconds = __seconds() - start;
+	}
+
+	if (ok) {
+		__report(csv, count, size, &result);
+		hogl_vf_free(vf);
+		vf = NULL;
+
+		result.operation = "open_warm";
+		result.operations = repeats;
+		result.bytes = total * repeats;
+		result.seconds = 0.0;
+
+		for (int r = 0; r < repeats && ok; r++) {
+			start = __seconds();
+			ok = hogl_vf_read(&vf, path) == HOGL_ERROR_NONE;
+			result.seconds += __seconds() - start;
+
+			if (ok) {
+				hogl_vf_free(vf);
+				vf = NULL;
+			}
+		}
+	}
+
+	if (ok) {
+		__report(csv, count, size, &result);
+
+		result.operation = "open_index";
+		result.bytes = 0;
+		result.seconds = 0.0;
+
+		for (int r = 0; r < repeats && ok; r++) {
+			start = __seconds();
+			ok = hogl_vf_open_index(&vf, path) == HOGL_ERROR_NONE;
+			result.seconds += __seconds() - start;
+
+			if (ok && r + 1 < repeats) {
+				hogl_vf_free(vf);
+				vf = NULL;
+			}
+		}
+	}
+
+	if (ok) {
+		__report(csv, count, size, &result);
+
+		// Random item reads through the open index
+		for (size_t i = 0; i < count; i++) {
+			order[i] = (size_t)(__xorshift(&state) % count);
+		}
+
+		result.operation = "read_item";
+		result.operations = count;
+		result.bytes = total;
+		start = __seconds();
+
+		for (size_t i = 0; i < count && ok; i++) {
+			ok = hogl_vf_read_item(vf, order[i], data, size) == HOGL_ERROR_NONE;
+		}
+
+		result.seconds = __seconds() - start;
+	}
+
+	if (ok) {
+		__report(csv, count, size, &result);
+
+		// Lookups, linear search is capped since it is quadratic over the whole pack
+		result.operation = "lookup";
+		result.operations = count < 10000 ? count : 10000;
+		result.bytes = 0;
+		start = __seconds();
+
+		for (size_t i = 0; i < result.operations && ok; i++) {
+			size_t index = 0;
+			snprintf(name, sizeof(name), "item_%08zu", order[i]);
+			ok = hogl_vf_get_item_index(vf, name, &index) == HOGL_ERROR_NONE && index == order[i];
+		}
+
+		result.seconds = __seconds() - start;
+	}
+
+	if (ok) {
+		__report(csv, count, size, &result);
+
+		ok = hogl_vf_mounts_new(&mounts) == HOGL_ERROR_NONE && hogl_vf_mounts_add(mounts, vf, 0) == HOGL_ERROR_NONE;
+		result.operation = "lookup_mount";
+		result.operations = count;
+		start = __seconds();
+
+		for (size_t i = 0; i < count && ok; i++) {
+			hogl_vf* owner = NULL;
+			size_t index = 0;
+			snprintf(name, sizeof(name), "item_%08zu", order[i]);
+			ok = hogl_vf_mounts_find(mounts, name, &owner, &index) == HOGL_ERROR_NONE && index == order[i];
+		}
+
+		result.seconds = __seconds() - start;
+	}
+
+	if (ok) {
+		__report(csv, count, size, &result);
+	}
+
+	if (mounts != NULL) {
+		hogl_vf_mounts_free(mounts);
+	}
+
+	if (vf != NULL) {
+		hogl_vf_free(vf);
+	}
+
+	hogl_free(data);
+	hogl_free(order);
+	remove(path);
+
+	return ok;
+}
+
+int main(int argc, char** argv) {
+	const char* csv_path = NULL;
+	const char* directory = ".";
+	uint64_t max_bytes = 256ULL * 1024 * 1024;
+	int repeats = 5;
+	char path[1024];
+	FILE* csv = NULL;
+	bool ok = true;
+
+	for (int i = 1; i + 1 < argc; i += 2) {
+		if (strcmp(argv[i], "-o") == 0) {
+			csv_path = argv[i + 1];
+		}
+		else if (strcmp(argv[i], "-r") == 0) {
+			repeats = atoi(argv[i + 1]) > 0 ? atoi(argv[i + 1]) : 1;
+		}
+		else if (strcmp(argv[i], "-m") == 0) {
+			max_bytes = strtoull(argv[i + 1], NULL, 10) * 1024 * 1024;
+		}
+		else if (strcmp(argv[i], "-d") == 0) {
+			directory = argv[i + 1];
+		}
+		else {
+			printf("Usage: hogl_vf_bench [-o results.csv] [-r repeats] [-m max MiB per pack] [-d directory]\n");
+			return 1;
+		}
+	}
+
+	hogl_set_log_cb(__log_cb);
+	snprintf(path, sizeof(path), "%s/hogl_vf_bench.hvf", directory);
+
+	if (csv_path != NULL) {
+		csv = fopen(csv_path, "w");
+
+		if (csv == NULL) {
+			printf("Failed to open %s\n", csv_path);
+			return 1;
+		}
+
+		fprintf(csv, "items,item_size,operation,operations,bytes,seconds,ns_per_op,mib_per_s\n");
+	}
+
+	for (size_t c = 0; c < sizeof(s_item_counts) / sizeof(s_item_counts[0]) && ok; c++) {
+		for (size_t s = 0; s < sizeof(s_item_sizes) / sizeof(s_item_sizes[0]) && ok; s++) {
+			if ((uint64_t)s_item_counts[c] * s_item_sizes[s] > max_bytes) {
+				continue;
+			}
+
+			ok = __bench_pack(csv, path, s_item_counts[c], s_item_sizes[s], repeats);
+
+			if (!ok) {
+				printf("Benchmark of %zu x %llu B failed\n", s_item_counts[c], (unsigned long long)s_item_sizes[s]);
+			}
+		}
+	}
+
+	if (csv != NULL) {
+		fclose(csv);
+	}
+
+	return ok ? 0 : 1;
+}
\ No newline at end of file
@@ -2,11 +2,16 @@ import struct
 import numpy as np
 
 version = np.uint32(0)
+max_name_len = 16
+name = "test".encode()
 data = []
 
 # Endian check
 data.append(struct.pack('<L', 0x01234567))
 
+# Format revision
+data.append(np.uint32(5))
+
 # Version
 data.append(version)
 
@@ -14,19 +19,38 @@ data.append(version)
 data.append(np.uint64(1))
 
 # Data size
-data.append(np.uint64(4 + 4 + 4 + 8 + 4))
+data.append(np.uint64(4))
+
+# Names size, every name is null terminated
+data.append(np.uint64(len(name) + 1))
+
+# Max name length
+data.append(np.uint32(max_name_len))
 
-# Type
+# Flags, index checksum, data checksum
+# flags 0 means the file checksums are not set, hogl_vf_save fills them in
+data.append(np.uint32(0))
+data.append(np.uint32(0))
 data.append(np.uint32(0))
 
-# Name
-data.append(np.uint32(4))
-data.append("test".encode())
+# String table
+data.append(name + b'\0')
 
-# Data
+# Item table (type, flags, size, offset into data, content hash, crc32c, reserved, name offset, name length)
+# flags 0 means the content hash and checksum are not set and hogl computes them when needed
+data.append(np.uint32(0))
+data.append(np.uint32(0))
 data.append(np.uint64(4))
+data.append(np.uint64(0))
+data.append(np.uint64(0))
+data.append(np.uint32(0))
+data.append(np.uint32(0))
+data.append(np.uint32(0))
+data.append(np.uint32(len(name)))
+
+# Data
 data.append(np.uint32(50))
 
 with open("test.hvf", "wb") as f:
 	for el in data:
-		f.write(el)
+		f.write(el)
\ No newline at end of file
@@ -0,0 +1,134 @@
+/**
+* @brief hvf_diff creates and applies patches between two versions of a hogl virtual file
+*
+* Usage:
+*	hvf_diff <base> <target> <patch>			writes a patch that turns base into target
+*	hvf_diff --apply <base> <patch> [output]	applies the patch, without output base is patched in place and
+*												only the changed data is appended to it
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include "hogl_core/io/hogl_vf.h"
+#include "hogl_core/os/hogl_os.h"
+#include "hogl_core/shared/hogl_log.h"
+
+void __log_cb(char* message, unsigned int size) {
+	// Allocations are traced, print only warnings and errors
+	if (strstr(message, "TRACE MESSAGE") == NULL) {
+		printf("%.*s\n", (int)size, message);
+	}
+}
+
+uint64_t __file_size(const char* path) {
+	hogl_file file = hogl_file_open(path);
+	uint64_t size = 0;
+
+	if (file != HOGL_INVALID_FILE) {
+		size = hogl_file_size(file);
+		hogl_file_close(file);
+	}
+
+	return size;
+}
+
+int __diff(const char* base_path, const char* target_path, const char* patch_path) {
+	hogl_vf* base = NULL;
+	hogl_vf* target = NULL;
+	hogl_vf* patch = NULL;
+	hogl_error error = HOGL_ERROR_NONE;
+
+	if (hogl_vf_read(&base, base_path) != HOGL_ERROR_NONE) {
+		return 1;
+	}
+
+	if (hogl_vf_read(&target, target_path) != HOGL_ERROR_NONE) {
+		hogl_vf_free(base);
+		return 1;
+	}
+
+	error = hogl_vf_diff(base, target, &patch);
+
+	if (error == HOGL_ERROR_NONE) {
+		error = hogl_vf_save(patch, patch_path);
+
+		if (error == HOGL_ERROR_NONE) {
+			printf("Patch %s: %zu changed items, %.2f MiB (target %.2f MiB)\n", patch_path, hogl_vf_item_count(patch) - 1,
+				(double)__file_size(patch_path) / (1024.0 * 1024.0), (double)__file_size(target_path) / (1024.0 * 1024.0));
+		}
+
+		hogl_vf_free(patch);
+	}
+
+	hogl_vf_free(base);
+	hogl_vf_free(target);
+
+	return error == HOGL_ERROR_NONE ? 0 : 1;
+}
+
+int __apply(const char* base_path, const char* patch_path, const char* output_path) {
+	hogl_vf* base = NULL;
+	hogl_vf* patch = NULL;
+	uint64_t old_size = __file_size(base_path);
+	uint64_t written = 0;
+	hogl_error error = HOGL_ERROR_NONE;
+
+	if (hogl_vf_read(&base, base_path) != HOGL_ERROR_NONE) {
+		return 1;
+	}
+
+	if (hogl_vf_read(&patch, patch_path) != HOGL_ERROR_NONE) {
+		hogl_vf_free(base);
+		return 1;
+	}
+
+	error = hogl_vf_apply_patch(base, patch);
+
+	if (error == HOGL_ERROR_NONE) {
+		// Saving back to the file it was read from appends, anywhere else writes a compact copy
+		if (output_path == NULL) {
+			hogl_vf_set_journal(base, true);
+			output_path = base_path;
+		}
+		else {
+			error = hogl_vf_compact(base);
+		}
+	}
+
+	if (error == HOGL_ERROR_NONE) {
+		error = hogl_vf_save(base, output_path);
+	}
+
+	if (error == HOGL_ERROR_NONE) {
+		written = __file_size(output_path);
+
+		// A journal save that didn't grow the file rewrote it
+		if (output_path == base_path && written > old_size) {
+			written -= old_size;
+		}
+
+		printf("Patched %s to version %u, %.2f MiB written\n", output_path, hogl_vf_version(base), (double)written / (1024.0 * 1024.0));
+	}
+
+	hogl_vf_free(base);
+	hogl_vf_free(patch);
+
+	return error == HOGL_ERROR_NONE ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+	hogl_set_log_cb(__log_cb);
+
+	if (argc == 4 && strcmp(argv[1], "--apply") != 0) {
+		return __diff(argv[1], argv[2], argv[3]);
+	}
+
+	if ((argc == 4 || argc == 5) && strcmp(argv[1], "--apply") == 0) {
+		return __apply(argv[2], argv[3], argc == 5 ? argv[4] : NULL);
+	}
+
+	printf("Usage: hvf_diff <base> <target> <patch>\n       hvf_diff --apply <base> <patch> [output]\n");
+
+	return 1;
+}
\ No newline at end of file
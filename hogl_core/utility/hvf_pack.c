@@ -0,0 +1,370 @@
+/**
+* @brief hvf_pack builds a hogl virtual file from a directory or a manifest, files are read and hashed in parallel
+* on the job system while the streaming vf writer stores them
+*
+* Usage: hvf_pack [options] <output> <directory or manifest>
+*	-j <threads>		worker threads, 0 uses one per logical processor (default 0)
+*	-v <version>		version of the virtual file (default 0)
+*	-n <length>			maximum item name length (default 256)
+*	-t <type>			type of every item (default 0)
+*	-b <files>			files loaded per batch for every worker thread (default 16)
+*	--verbose			print trace messages
+*
+* A manifest is a text file with one item per line: <file path> [item name], empty lines and lines starting
+* with # are skipped. Items of a directory are named by their path relative to the directory
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "hogl_core/io/hogl_vf.h"
+#include "hogl_core/os/hogl_os.h"
+#include "hogl_core/shared/hogl_job.h"
+#include "hogl_core/shared/hogl_hash.h"
+#include "hogl_core/shared/hogl_log.h"
+#include "hogl_core/shared/hogl_memory.h"
+
+#define PACK_LINE_MAX 4096
+
+typedef struct _pack_file {
+	char* path;
+	char* name;
+
+	// Filled by the load job
+	char* data;
+	uint64_t size;
+	uint64_t hash;
+	uint32_t crc;
+	bool loaded;
+} pack_file;
+
+typedef struct _pack_list {
+	pack_file* files;
+	size_t count;
+	size_t capacity;
+	size_t root_length;
+} pack_list;
+
+static bool s_verbose = false;
+
+void __log_cb(char* message, unsigned int size) {
+	// Allocations are traced, a pack would print thousands of them
+	if (s_verbose || strstr(message, "TRACE MESSAGE") == NULL) {
+		printf("%.*s\n", (int)size, message);
+	}
+}
+
+char* __copy_string(const char* str, size_t length) {
+	char* result = hogl_malloc((unsigned int)(length + 1));
+
+	if (result != NULL) {
+		memcpy(result, str, length);
+		result[length] = '\0';
+	}
+
+	return result;
+}
+
+bool __list_add(pack_list* list, const char* path, size_t path_length, const char* name, size_t name_length) {
+	pack_file* file = NULL;
+
+	if (list->count == list->capacity) {
+		size_t new_capacity = list->capacity == 0 ? 256 : list->capacity * 2;
+		pack_file* new_files = hogl_realloc(list->files, new_capacity * sizeof(pack_file));
+
+		if (new_files == NULL) {
+			return false;
+		}
+
+		list->files = new_files;
+		list->capacity = new_capacity;
+	}
+
+	file = &list->files[list->count];
+	memset(file, 0, sizeof(pack_file));
+	file->path = __copy_string(path, path_length);
+	file->name = __copy_string(name, name_length);
+
+	if (file->path == NULL || file->name == NULL) {
+		hogl_free(file->path);
+		hogl_free(file->name);
+		return false;
+	}
+
+	list->count++;
+
+	return true;
+}
+
+void __dir_cb(const char* path, void* usrp) {
+	pack_list* list = usrp;
+	const char* name = path + list->root_length + 1;
+
+	if (!__list_add(list, path, strlen(path), name, strlen(name))) {
+		hogl_log_error("Out of memory adding %s", path);
+	}
+}
+
+bool __read_manifest(pack_list* list, const char* path) {
+	FILE* fp = fopen(path, "r");
+	char line[PACK_LINE_MAX];
+
+	if (fp == NULL) {
+		hogl_log_error("%s is neither a directory nor a manifest", path);
+		return false;
+	}
+
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		char* file_path = line;
+		char* name = NULL;
+		size_t path_length = 0;
+		size_t name_length = 0;
+
+		line[strcspn(line, "\r\n")] = '\0';
+
+		while (*file_path == ' ' || *file_path == '\t') {
+			file_path++;
+		}
+
+		if (*file_path == '\0' || *file_path == '#') {
+			continue;
+		}
+
+		path_length = strcspn(file_path, " \t");
+		name = file_path + path_length;
+
+		while (*name == ' ' || *name == '\t') {
+			name++;
+		}
+
+		// Unnamed items are named by their path
+		name_length = strcspn(name, " \t");
+
+		if (name_length == 0) {
+			name = file_path;
+			name_length = path_length;
+		}
+
+		if (!__list_add(list, file_path, path_length, name, name_length)) {
+			hogl_log_error("Out of memory reading %s", path);
+			fclose(fp);
+			return false;
+		}
+	}
+
+	fclose(fp);
+
+	return true;
+}
+
+int __file_compare(const void* a, const void* b) {
+	return strcmp(((const pack_file*)a)->name, ((const pack_file*)b)->name);
+}
+
+void __load_file(void* usrp) {
+	pack_file* file = usrp;
+	hogl_file handle = hogl_file_open(file->path);
+
+	if (handle == HOGL_INVALID_FILE) {
+		return;
+	}
+
+	file->size = hogl_file_size(handle);
+	// hogl allocations are limited to 4 GB, larger files fail to load
+	file->data = file->size != 0 && file->size <= UINT32_MAX ? hogl_malloc((unsigned int)file->size) : NULL;
+
+	if ((file->data != NULL || file->size == 0) &&
+		hogl_file_pread(handle, file->data, file->size, 0) == file->size) {
+		file->hash = hogl_hash64(file->data, file->size, 0);
+		file->crc = hogl_crc32c(0, file->data, file->size);
+		file->loaded = true;
+	}
+
+	hogl_file_close(handle);
+}
+
+bool __submit_batch(hogl_job_system* js, pack_list* list, void** usrps, size_t first, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		usrps[i] = &list->files[first + i];
+	}
+
+	return count == 0 || hogl_js_submit_n(js, __load_file, usrps, count) == HOGL_ERROR_NONE;
+}
+
+double __seconds(void) {
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+void __usage(void) {
+	printf("Usage: hvf_pack [-j threads] [-v version] [-n max_name_len] [-t type] [-b batch] [--verbose] <output> <directory or manifest>\n");
+}
+
+int main(int argc, char** argv) {
+	pack_list list = { NULL, 0, 0, 0 };
+	hogl_job_system* js = NULL;
+	hogl_vf_writer* writer = NULL;
+	const char* output = NULL;
+	const char* input = NULL;
+	unsigned int threads = 0;
+	uint32_t version = 0;
+	uint32_t max_name_len = 256;
+	uint32_t type = 0;
+	size_t batch_per_thread = 16;
+	size_t batch = 0;
+	size_t failed = 0;
+	uint64_t input_bytes = 0;
+	uint64_t output_bytes = 0;
+	hogl_file out_file = HOGL_INVALID_FILE;
+	void** usrps = NULL;
+	char* root = NULL;
+	double start = 0.0;
+	double elapsed = 0.0;
+	hogl_error error = HOGL_ERROR_NONE;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--verbose") == 0) {
+			s_verbose = true;
+		}
+		else if (argv[i][0] == '-' && argv[i][1] != '\0' && argv[i][2] == '\0' && i + 1 < argc) {
+			unsigned long value = strtoul(argv[++i], NULL, 10);
+
+			switch (argv[i - 1][1]) {
+			case 'j': threads = (unsigned int)value; break;
+			case 'v': version = (uint32_t)value; break;
+			case 'n': max_name_len = (uint32_t)value; break;
+			case 't': type = (uint32_t)value; break;
+			case 'b': batch_per_thread = value != 0 ? (size_t)value : 1; break;
+			default: __usage(); return 1;
+			}
+		}
+		else if (output == NULL) {
+			output = argv[i];
+		}
+		else if (input == NULL) {
+			input = argv[i];
+		}
+		else {
+			__usage();
+			return 1;
+		}
+	}
+
+	if (output == NULL || input == NULL) {
+		__usage();
+		return 1;
+	}
+
+	hogl_set_log_cb(__log_cb);
+	start = __seconds();
+
+	// Collect files, anything that isn't a directory is read as a manifest
+	list.root_length = strlen(input);
+
+	while (list.root_length > 1 && (input[list.root_length - 1] == '/' || input[list.root_length - 1] == '\\')) {
+		list.root_length--;
+	}
+
+	root = __copy_string(input, list.root_length);
+	error = root != NULL ? hogl_dir_walk(root, __dir_cb, &list) : HOGL_ERROR_MEMORY;
+	hogl_free(root);
+
+	if (error != HOGL_ERROR_NONE && !__read_manifest(&list, input)) {
+		return 1;
+	}
+
+	// Sorted so the same input always gives the same file
+	qsort(list.files, list.count, sizeof(pack_file), __file_compare);
+
+	if (hogl_js_new(&js, threads) != HOGL_ERROR_NONE) {
+		hogl_log_error("Failed to start the job system");
+		return 1;
+	}
+
+	batch = batch_per_thread * hogl_js_thread_count(js);
+	usrps = hogl_malloc((unsigned int)(batch * sizeof(void*)));
+
+	if (usrps == NULL || hogl_vf_writer_open(&writer, output, version, max_name_len) != HOGL_ERROR_NONE) {
+		hogl_log_error("Failed to start writing %s", output);
+		hogl_js_free(js);
+		return 1;
+	}
+
+	// While the main thread writes a batch the workers already load the next one
+	error = __submit_batch(js, &list, usrps, 0, list.count < batch ? list.count : batch) ? HOGL_ERROR_NONE : HOGL_ERROR_MEMORY;
+
+	for (size_t first = 0; first < list.count && error == HOGL_ERROR_NONE; first += batch) {
+		size_t count = list.count - first < batch ? list.count - first : batch;
+		size_t next = first + count;
+
+		hogl_js_wait(js);
+
+		if (next < list.count &&
+			!__submit_batch(js, &list, usrps, next, list.count - next < batch ? list.count - next : batch)) {
+			error = HOGL_ERROR_MEMORY;
+		}
+
+		for (size_t i = first; i < next; i++) {
+			pack_file* file = &list.files[i];
+
+			if (!file->loaded) {
+				hogl_log_error("Failed to read %s", file->path);
+				failed++;
+			}
+			else if (error == HOGL_ERROR_NONE) {
+				error = hogl_vf_writer_add_hashed(writer, file->name, type, file->data, file->size, file->hash, file->crc);
+
+				if (error != HOGL_ERROR_NONE) {
+					hogl_log_error("Failed to add %s", file->path);
+				}
+
+				input_bytes += file->size;
+			}
+
+			hogl_free(file->data);
+			file->data = NULL;
+		}
+	}
+
+	// Make sure no job still uses the list
+	hogl_js_wait(js);
+	hogl_js_free(js);
+
+	if (hogl_vf_writer_close(writer) != HOGL_ERROR_NONE) {
+		error = HOGL_ERROR_BAD_WRITE;
+	}
+
+	elapsed = __seconds() - start;
+
+	out_file = hogl_file_open(output);
+
+	if (out_file != HOGL_INVALID_FILE) {
+		output_bytes = hogl_file_size(out_file);
+		hogl_file_close(out_file);
+	}
+
+	for (size_t i = 0; i < list.count; i++) {
+		hogl_free(list.files[i].data);
+		hogl_free(list.files[i].path);
+		hogl_free(list.files[i].name);
+	}
+
+	hogl_free(list.files);
+	hogl_free(usrps);
+
+	if (error != HOGL_ERROR_NONE) {
+		hogl_log_error("Failed to pack %s", output);
+		return 1;
+	}
+
+	printf("Packed %zu files (%zu unreadable) into %s\n", list.count - failed, failed, output);
+	printf("Input  : %.2f MiB\n", (double)input_bytes / (1024.0 * 1024.0));
+	printf("Output : %.2f MiB\n", (double)output_bytes / (1024.0 * 1024.0));
+	printf("Time   : %.3f s\n", elapsed);
+	printf("Speed  : %.2f MiB/s\n", elapsed > 0.0 ? (double)input_bytes / (1024.0 * 1024.0) / elapsed : 0.0);
+
+	return failed != 0 ? 2 : 0;
+}
\ No newline at end of file